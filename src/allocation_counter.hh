@@ -0,0 +1,38 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_allocation_counter_hh
+#define INCLUDED_allocation_counter_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+
+namespace sesh {
+
+/**
+ * Returns the number of times the global operator new has been called in this
+ * program. The counting operators are defined in allocation_counter.cc, which
+ * is linked into benchmark programs that measure memory allocations.
+ */
+std::size_t allocation_count() noexcept;
+
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_allocation_counter_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -20,8 +20,8 @@
 
 #include "buildconfig.h"
 
-#include <memory>
 #include <type_traits>
+#include "async/ref_ptr.hh"
 #include "common/function_helper.hh"
 #include "common/logic_helper.hh"
 
@@ -44,7 +44,7 @@ class continuation {
 
 private:
 
-    std::shared_ptr<runnable> m_runnable;
+    ref_ptr<runnable> m_runnable;
 
 public:
 
@@ -52,10 +52,10 @@ public:
     constexpr continuation() = default;
 
     /**
-     * Constructs a continuation from a nullable shared pointer to a runnable.
-     * The runnable, if non-null, will be run as the body of continuation.
+     * Constructs a continuation from a nullable pointer to a runnable. The
+     * runnable, if non-null, will be run as the body of continuation.
      */
-    continuation(std::shared_ptr<runnable> &&r) noexcept :
+    continuation(ref_ptr<runnable> &&r) noexcept :
             m_runnable(std::move(r)) { }
 
     /** Move constructor. The argument continuation will be empty (a nop). */
@@ -84,7 +84,7 @@ public:
      * Resumes the suspended computation, if any. Returns after the computation
      * ends.
      */
-    ~continuation() noexcept { run(); }
+    inline ~continuation() noexcept;
 
 }; // class continuation
 
@@ -94,7 +94,7 @@ inline void swap(continuation &l, continuation &r) noexcept {
 }
 
 /** Abstract computation that can be run once. */
-class runnable {
+class runnable : public ref_counted {
 
 private:
 
@@ -162,6 +162,10 @@ inline void continuation::run() noexcept {
         m_runnable = m_runnable->run().m_runnable;
 }
 
+inline continuation::~continuation() noexcept {
+    run();
+}
+
 } // namespace async
 } // namespace sesh
 
@@ -17,14 +17,15 @@
 
 #include "buildconfig.h"
 
-#include <memory>
 #include <type_traits>
 #include "async/continuation.hh"
+#include "async/ref_ptr.hh"
 #include "catch.hpp"
 
 namespace {
 
 using sesh::async::continuation;
+using sesh::async::make_ref;
 using sesh::async::runnable_wrapper;
 
 TEST_CASE("Continuation special member function properties") {
@@ -43,7 +44,7 @@ TEST_CASE("Null-constructed continuation does nothing on destruction") {
 TEST_CASE("continuation::run") {
     int i = 0;
     auto f = [&i] { CHECK(i == 0); i = 100; };
-    continuation c(std::make_shared<runnable_wrapper<decltype(f)>>(f));
+    continuation c(make_ref<runnable_wrapper<decltype(f)>>(f));
     CHECK(i == 0);
     c.run();
     CHECK(i == 100);
@@ -56,9 +57,9 @@ TEST_CASE("Continuation returned by runnable is run in turn") {
     auto f = [&i] { CHECK(i == 0); i = 100; };
     auto g = [f] {
         return continuation(
-                std::make_shared<runnable_wrapper<decltype(f)>>(f));
+                make_ref<runnable_wrapper<decltype(f)>>(f));
     };
-    continuation c(std::make_shared<runnable_wrapper<decltype(g)>>(g));
+    continuation c(make_ref<runnable_wrapper<decltype(g)>>(g));
     c.run();
     CHECK(i == 100);
 }
@@ -66,14 +67,14 @@ TEST_CASE("Continuation returned by runnable is run in turn") {
 TEST_CASE("Continuation destructor runs the continuation") {
     int i = 0;
     auto f = [&i] { CHECK(i == 0); i = 100; };
-    (void) continuation(std::make_shared<runnable_wrapper<decltype(f)>>(f));
+    (void) continuation(make_ref<runnable_wrapper<decltype(f)>>(f));
     CHECK(i == 100);
 }
 
 TEST_CASE("Continuation move construction") {
     int i = 0;
     auto f = [&i] { CHECK(i == 0); i = 100; };
-    auto c1 = continuation(std::make_shared<runnable_wrapper<decltype(f)>>(f));
+    auto c1 = continuation(make_ref<runnable_wrapper<decltype(f)>>(f));
     {
         auto c2 = continuation(std::move(c1));
         CHECK(i == 0);
@@ -86,10 +87,10 @@ TEST_CASE("Swapping continuations") {
     auto f1 = [&i1] { CHECK(i1 == 0); i1 = 100; };
     auto f2 = [&i2] { CHECK(i2 == 0); i2 = 200; };
     {
-        continuation c1(std::make_shared<runnable_wrapper<decltype(f1)>>(f1));
+        continuation c1(make_ref<runnable_wrapper<decltype(f1)>>(f1));
         {
             continuation c2(
-                    std::make_shared<runnable_wrapper<decltype(f2)>>(f2));
+                    make_ref<runnable_wrapper<decltype(f2)>>(f2));
             c1.swap(c2);
             CHECK(i1 == 0);
             CHECK(i2 == 0);
@@ -106,10 +107,10 @@ TEST_CASE("Move assignment swaps continuations") {
     auto f1 = [&i1] { CHECK(i1 == 0); i1 = 100; };
     auto f2 = [&i2] { CHECK(i2 == 0); i2 = 200; };
     {
-        continuation c1(std::make_shared<runnable_wrapper<decltype(f1)>>(f1));
+        continuation c1(make_ref<runnable_wrapper<decltype(f1)>>(f1));
         {
             continuation c2(
-                    std::make_shared<runnable_wrapper<decltype(f2)>>(f2));
+                    make_ref<runnable_wrapper<decltype(f2)>>(f2));
             c1 = std::move(c2);
             CHECK(i1 == 0);
             CHECK(i2 == 0);
@@ -21,15 +21,19 @@
 #include "buildconfig.h"
 
 #include <cassert>
+#include <cstddef>
 #include <exception>
 #include <functional>
-#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 #include "async/continuation.hh"
+#include "async/ref_ptr.hh"
 #include "common/direct_initialize.hh"
 #include "common/either.hh"
 #include "common/empty.hh"
 #include "common/function_helper.hh"
+#include "common/pool_allocator.hh"
 #include "common/type_tag.hh"
 
 namespace sesh {
@@ -48,13 +52,15 @@ namespace async {
  * the client just after the result is passed to the callback, so the result
  * and callback are soon destroyed anyway.
  *
- * A delay object must be allocated in the heap and managed by std::shared_ptr.
+ * A delay object must be allocated in the heap and managed by {@link ref_ptr}.
+ * Unless SESH_NO_DELAY_POOL is defined, delay objects are allocated from the
+ * memory pool of the current thread (see {@link common::memory_pool}).
  *
  * @tparam T The result type. It must be a decayed move-constructible type
  * other than std::exception_ptr.
  */
 template<typename T>
-class delay : public runnable, public std::enable_shared_from_this<delay<T>> {
+class delay : public runnable {
 
 public:
 
@@ -66,6 +72,12 @@ public:
 
     public:
 
+        /**
+         * Move-constructs a copy of this callback at the argument address,
+         * which must be suitably sized and aligned.
+         */
+        virtual callback *move_to(void *) noexcept = 0;
+
         virtual ~callback() = default;
 
         continuation operator()(common::trial<T> &&t) noexcept {
@@ -96,19 +108,102 @@ public:
             return call(m_function, std::move(t));
         }
 
+        callback *move_to(void *p) noexcept final override {
+            return new (p) callback_wrapper(std::move(m_function));
+        }
+
     }; // template<typename F> class callback_wrapper
 
-    using callback_pointer = std::unique_ptr<callback>;
+    /**
+     * Owner of a callback. A callback that fits in the buffer of this
+     * object and whose move constructor does not throw is constructed in
+     * place. Larger callbacks are allocated in the free store. Most callbacks
+     * set by futures are small function objects, so this saves a memory
+     * allocation per callback.
+     */
+    class callback_storage {
+
+    public:
+
+        /** Size of the buffer for callbacks constructed in place. */
+        constexpr static std::size_t buffer_size = 6 * sizeof(void *);
+
+    private:
+
+        using buffer = typename std::aligned_storage<buffer_size>::type;
+
+        template<typename F>
+        using fits = std::integral_constant<bool,
+                sizeof(callback_wrapper<F>) <= sizeof(buffer) &&
+                alignof(callback_wrapper<F>) <= alignof(buffer) &&
+                std::is_nothrow_move_constructible<F>::value>;
+
+        buffer m_buffer;
+        callback *m_callback;
+        bool m_is_inline;
+
+        template<typename F, typename... A>
+        callback *construct(std::true_type, A &&... a) {
+            void *p = &m_buffer;
+            return new (p) callback_wrapper<F>(std::forward<A>(a)...);
+        }
+
+        template<typename F, typename... A>
+        callback *construct(std::false_type, A &&... a) {
+            return new callback_wrapper<F>(std::forward<A>(a)...);
+        }
+
+    public:
+
+        /**
+         * Constructs a callback of type @c F with the arguments following the
+         * type tag.
+         */
+        template<typename F, typename... A>
+        explicit callback_storage(common::type_tag<F>, A &&... a) :
+                m_callback(construct<F>(fits<F>(), std::forward<A>(a)...)),
+                m_is_inline(fits<F>::value) { }
+
+        callback_storage(callback_storage &&s) noexcept :
+                m_callback(s.m_callback), m_is_inline(s.m_is_inline) {
+            if (m_is_inline)
+                m_callback = s.m_callback->move_to(&m_buffer);
+            else
+                s.m_callback = nullptr;
+        }
+
+        callback_storage(const callback_storage &) = delete;
+        callback_storage &operator=(const callback_storage &) = delete;
+
+        ~callback_storage() {
+            if (m_is_inline)
+                m_callback->~callback();
+            else
+                delete m_callback;
+        }
+
+        /** Returns true if the callback is constructed in this object. */
+        bool is_inline() const noexcept { return m_is_inline; }
+
+        continuation operator()(common::trial<T> &&t) noexcept {
+            return (*m_callback)(std::move(t));
+        }
+
+    }; // class callback_storage
 
 private:
 
     using empty = common::empty;
     using trial = common::trial<T>;
-    using forward_source = std::weak_ptr<delay>;
-    using forward_target = std::shared_ptr<delay>;
+    /**
+     * Pointer to the delay that forwards its result to this delay. The
+     * pointer is reset to null when the source delay is destroyed.
+     */
+    using forward_source = delay *;
+    using forward_target = ref_ptr<delay>;
 
     using input = common::variant<empty, trial, forward_source>;
-    using output = common::variant<empty, callback_pointer, forward_target>;
+    using output = common::variant<empty, callback_storage, forward_target>;
 
     input m_input = input(empty());
     output m_output = output(empty());
@@ -116,18 +211,55 @@ private:
     continuation to_continuation() {
         if (m_input.tag() != m_input.template tag<trial>())
             return {};
-        if (m_output.tag() != m_output.template tag<callback_pointer>())
+        if (m_output.tag() != m_output.template tag<callback_storage>())
             return {};
-        return continuation(this->shared_from_this());
+        return continuation(ref_ptr<runnable>(this));
+    }
+
+    /**
+     * If this delay forwards to another delay, resets the target's pointer
+     * back to this delay.
+     */
+    void detach_target() noexcept {
+        if (m_output.tag() != m_output.template tag<forward_target>())
+            return;
+
+        delay *to = m_output.template value<forward_target>().get();
+        if (to == nullptr)
+            return;
+        if (to->m_input.tag() != to->m_input.template tag<forward_source>())
+            return;
+
+        auto &source = to->m_input.template value<forward_source>();
+        if (source == this)
+            source = nullptr;
     }
 
     continuation do_run() noexcept final override {
-        auto &f = m_output.template value<callback_pointer>();
-        return (*f)(std::move(m_input.template value<trial>()));
+        auto &f = m_output.template value<callback_storage>();
+        return f(std::move(m_input.template value<trial>()));
     }
 
 public:
 
+#ifndef SESH_NO_DELAY_POOL
+
+    static void *operator new(std::size_t size) {
+        return common::memory_pool::instance().allocate(size);
+    }
+
+    static void operator delete(void *p, std::size_t size) noexcept {
+        common::memory_pool::instance().deallocate(p, size);
+    }
+
+#endif // #ifndef SESH_NO_DELAY_POOL
+
+    delay() = default;
+    delay(const delay &) = delete;
+    delay &operator=(const delay &) = delete;
+
+    ~delay() { detach_target(); }
+
     /**
      * Sets the result of this delay object by constructing
      * <code>trial&lt;T></code> with the arguments. If the constructor throws,
@@ -178,12 +310,11 @@ public:
      * the callback passing the result to it. Otherwise, the continuation is a
      * nop.
      */
-    continuation set_callback(callback_pointer &&f) {
-        assert(m_output.tag() != m_output.template tag<callback_pointer>());
-        assert(f != nullptr);
+    continuation set_callback(callback_storage &&f) {
+        assert(m_output.tag() != m_output.template tag<callback_storage>());
 
         if (m_input.tag() == m_input.template tag<forward_source>()) {
-            if (auto fs = m_input.template value<forward_source>().lock())
+            if (delay *fs = m_input.template value<forward_source>())
                 return fs->set_callback(std::move(f));
             return {};
         }
@@ -213,8 +344,22 @@ public:
      */
     template<typename F, typename... A>
     continuation emplace_callback(A &&... a) {
-        return set_callback(callback_pointer(
-                new callback_wrapper<F>(std::forward<A>(a)...)));
+        assert(m_output.tag() != m_output.template tag<callback_storage>());
+
+        if (m_input.tag() == m_input.template tag<forward_source>()) {
+            if (delay *fs = m_input.template value<forward_source>())
+                return fs->template emplace_callback<F>(
+                        std::forward<A>(a)...);
+            return {};
+        }
+
+        m_output.template emplace_with_fallback<empty>(
+                common::direct_initialize(),
+                common::type_tag<callback_storage>(),
+                common::type_tag<F>(),
+                std::forward<A>(a)...);
+
+        return to_continuation();
     }
 
     /**
@@ -251,7 +396,7 @@ public:
      * this function, the two endpoints are directly connected so that the
      * intermediate delay objects are dropped and deallocated.
      *
-     * For maximum efficiency, the argument shared pointers should be destroyed
+     * For maximum efficiency, the argument pointers should be destroyed
      * (or reset) as soon as possible after this function returned.
      *
      * The argument pointers must be non-null. The "from" and "to" objects must
@@ -267,10 +412,10 @@ public:
      * continuation is a nop.
      */
     static continuation forward(
-            std::shared_ptr<delay> &&from, std::shared_ptr<delay> &&to) {
+            ref_ptr<delay> &&from, ref_ptr<delay> &&to) {
         assert(from != nullptr);
         assert(from->m_output.tag() !=
-                from->m_output.template tag<callback_pointer>());
+                from->m_output.template tag<callback_storage>());
 
         assert(to != nullptr);
         assert(to->m_input.tag() != to->m_input.template tag<trial>());
@@ -278,14 +423,18 @@ public:
         // Normalize "from"
         if (from->m_input.tag() ==
                 from->m_input.template tag<forward_source>()) {
-            from = from->m_input.template value<forward_source>().lock();
-            if (from == nullptr)
+            delay *source = from->m_input.template value<forward_source>();
+            if (source == nullptr)
                 return {};
+            from = ref_ptr<delay>(source);
         }
 
         // Normalize "to"
-        if (to->m_output.tag() == to->m_output.template tag<forward_target>())
+        if (to->m_output.tag() ==
+                to->m_output.template tag<forward_target>()) {
+            to->detach_target();
             to = std::move(to->m_output.template value<forward_target>());
+        }
 
         // Transfer result
         if (from->m_input.tag() == from->m_input.template tag<trial>())
@@ -294,15 +443,15 @@ public:
 
         // Transfer callback
         if (to->m_output.tag() ==
-                to->m_output.template tag<callback_pointer>())
+                to->m_output.template tag<callback_storage>())
             return from->set_callback(std::move(
-                    to->m_output.template value<callback_pointer>()));
+                    to->m_output.template value<callback_storage>()));
 
         // Connect
         to->m_input.emplace(
                 common::direct_initialize(),
                 common::type_tag<forward_source>(),
-                from);
+                from.get());
         from->m_output.emplace(
                 common::direct_initialize(),
                 common::type_tag<forward_target>(),
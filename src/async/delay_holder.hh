@@ -20,21 +20,21 @@
 
 #include "buildconfig.h"
 
-#include <memory>
 #include <utility>
 #include "async/continuation.hh"
 #include "async/delay.hh"
+#include "async/ref_ptr.hh"
 
 namespace sesh {
 namespace async {
 
-/** A non-copyable base class that has a shared pointer to a delay object. */
+/** A non-copyable base class that has a pointer to a delay object. */
 template<typename T>
 class delay_holder {
 
 private:
 
-    std::shared_ptr<async::delay<T>> m_delay;
+    ref_ptr<async::delay<T>> m_delay;
 
 public:
 
@@ -45,7 +45,7 @@ public:
     delay_holder() = default;
 
     /** Creates a delay holder that holds the argument delay. */
-    explicit delay_holder(const std::shared_ptr<async::delay<T>> &d) noexcept :
+    explicit delay_holder(const ref_ptr<async::delay<T>> &d) noexcept :
             m_delay(d) { }
 
     delay_holder(const delay_holder &) = delete;
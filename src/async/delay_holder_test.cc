@@ -19,12 +19,15 @@
 
 #include <utility>
 #include "async/delay_holder.hh"
+#include "async/ref_ptr.hh"
 #include "catch.hpp"
 
 namespace {
 
 using sesh::async::delay;
 using sesh::async::delay_holder;
+using sesh::async::make_ref;
+using sesh::async::ref_ptr;
 
 TEST_CASE("Delay holder, move") {
     delay_holder<int> d;
@@ -37,14 +40,14 @@ TEST_CASE("Delay holder, default construction and invalidness") {
 }
 
 TEST_CASE("Delay holder, construction with delay and validness") {
-    std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    ref_ptr<delay<int>> d = make_ref<delay<int>>();
     delay_holder<int> dh(d);
     d.reset();
     CHECK(dh.is_valid());
 }
 
 TEST_CASE("Delay holder, invalidation") {
-    const std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    const ref_ptr<delay<int>> d = make_ref<delay<int>>();
     delay_holder<int> dh(d);
     dh.invalidate();
     CHECK_FALSE(dh.is_valid());
@@ -17,10 +17,13 @@
 
 #include "buildconfig.h"
 
+#include <array>
 #include <exception>
 #include <memory>
 #include <tuple>
+#include <utility>
 #include "async/delay.hh"
+#include "async/ref_ptr.hh"
 #include "catch.hpp"
 #include "common/copy.hh"
 #include "common/direct_initialize.hh"
@@ -30,6 +33,7 @@
 namespace {
 
 using sesh::async::delay;
+using sesh::async::make_ref;
 using sesh::common::copy;
 using sesh::common::direct_initialize;
 using sesh::common::trial;
@@ -37,7 +41,7 @@ using sesh::common::type_tag;
 
 TEST_CASE("Delay: set result and callback") {
     using T = std::tuple<int, float, char>;
-    auto d = std::make_shared<delay<T>>();
+    auto d = make_ref<delay<T>>();
 
     d->set_result(direct_initialize(), type_tag<T>(), 42, 3.0f, 'a');
 
@@ -50,7 +54,7 @@ TEST_CASE("Delay: set result and callback") {
 }
 
 TEST_CASE("Delay: set callback and result") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
 
     unsigned call_count = 0;
     d->set_callback([&call_count](trial<int> &&r) {
@@ -70,7 +74,7 @@ TEST_CASE("Delay: set result with throwing constructor and then callback") {
         thrower(const thrower &) { throw 42; }
     };
 
-    auto d = std::make_shared<delay<thrower>>();
+    auto d = make_ref<delay<thrower>>();
 
     d->set_result(thrower());
 
@@ -86,11 +90,81 @@ TEST_CASE("Delay: set result with throwing constructor and then callback") {
     CHECK(call_count == 1);
 }
 
+namespace callback_storage {
+
+using storage = delay<int>::callback_storage;
+
+class counter {
+
+public:
+
+    std::shared_ptr<int> count;
+
+    sesh::async::continuation operator()(trial<int> &&r) {
+        *count += r.get();
+        return {};
+    }
+
+}; // class counter
+
+class large_counter : public counter {
+
+public:
+
+    std::array<char, storage::buffer_size> padding;
+
+    explicit large_counter(const std::shared_ptr<int> &c) :
+            counter{c}, padding() { }
+
+}; // class large_counter
+
+TEST_CASE("Delay: small callback is stored in place") {
+    auto count = std::make_shared<int>(0);
+    storage s1((type_tag<counter>()), counter{count});
+    CHECK(s1.is_inline());
+
+    storage s2(std::move(s1));
+    CHECK(s2.is_inline());
+    s2(trial<int>(3));
+    CHECK(*count == 3);
+}
+
+TEST_CASE("Delay: large callback is stored in free store") {
+    auto count = std::make_shared<int>(0);
+    storage s1((type_tag<large_counter>()), large_counter(count));
+    CHECK_FALSE(s1.is_inline());
+
+    storage s2(std::move(s1));
+    s2(trial<int>(5));
+    CHECK(*count == 5);
+}
+
+TEST_CASE("Delay: callback is destroyed with delay") {
+    auto count = std::make_shared<int>(0);
+    auto d = make_ref<delay<int>>();
+    d->set_callback(counter{count});
+    CHECK(count.use_count() == 2);
+    d.reset();
+    CHECK(count.unique());
+}
+
+TEST_CASE("Delay: large callback is called") {
+    auto count = std::make_shared<int>(0);
+    auto d = make_ref<delay<int>>();
+    d->set_callback(large_counter(count));
+    d->set_result(7);
+    CHECK(*count == 7);
+    d.reset();
+    CHECK(count.unique());
+}
+
+} // namespace callback_storage
+
 namespace forwarding {
 
 TEST_CASE("Delay: simplest forward") {
-    auto source = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     delay<int>::forward(copy(source), copy(target));
 
     CHECK(source.unique());
@@ -104,9 +178,9 @@ TEST_CASE("Delay: simplest forward") {
 }
 
 TEST_CASE("Delay: forward with connected source") {
-    auto source1 = std::make_shared<delay<int>>();
-    auto source2 = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source1 = make_ref<delay<int>>();
+    auto source2 = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     delay<int>::forward(copy(source1), copy(source2));
     delay<int>::forward(copy(source2), copy(target));
 
@@ -124,9 +198,9 @@ TEST_CASE("Delay: forward with connected source") {
 }
 
 TEST_CASE("Delay: forward with abandoned source") {
-    auto source1 = std::make_shared<delay<int>>();
-    auto source2 = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source1 = make_ref<delay<int>>();
+    auto source2 = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     delay<int>::forward(copy(source1), copy(source2));
     source1.reset();
     delay<int>::forward(copy(source2), copy(target));
@@ -139,9 +213,9 @@ TEST_CASE("Delay: forward with abandoned source") {
 }
 
 TEST_CASE("Delay: forward with connected target") {
-    auto source = std::make_shared<delay<int>>();
-    auto target1 = std::make_shared<delay<int>>();
-    auto target2 = std::make_shared<delay<int>>();
+    auto source = make_ref<delay<int>>();
+    auto target1 = make_ref<delay<int>>();
+    auto target2 = make_ref<delay<int>>();
     delay<int>::forward(copy(target1), copy(target2));
     delay<int>::forward(copy(source), copy(target1));
 
@@ -159,10 +233,10 @@ TEST_CASE("Delay: forward with connected target") {
 }
 
 TEST_CASE("Delay: forward with connected source and target") {
-    auto source1 = std::make_shared<delay<int>>();
-    auto source2 = std::make_shared<delay<int>>();
-    auto target1 = std::make_shared<delay<int>>();
-    auto target2 = std::make_shared<delay<int>>();
+    auto source1 = make_ref<delay<int>>();
+    auto source2 = make_ref<delay<int>>();
+    auto target1 = make_ref<delay<int>>();
+    auto target2 = make_ref<delay<int>>();
     delay<int>::forward(copy(source1), copy(source2));
     delay<int>::forward(copy(target1), copy(target2));
     delay<int>::forward(copy(source2), copy(target1));
@@ -183,8 +257,8 @@ TEST_CASE("Delay: forward with connected source and target") {
 }
 
 TEST_CASE("Delay: forward from source with preset result") {
-    auto source = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     source->set_result(42);
     delay<int>::forward(copy(source), copy(target));
 
@@ -198,8 +272,8 @@ TEST_CASE("Delay: forward from source with preset result") {
 }
 
 TEST_CASE("Delay: forward to target with preset callback") {
-    auto source = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     int result = 0;
     target->set_callback([&result](trial<int> &&r) { result = r.get(); });
     delay<int>::forward(copy(source), copy(target));
@@ -214,8 +288,8 @@ TEST_CASE("Delay: forward to target with preset callback") {
 }
 
 TEST_CASE("Delay: forward preset result to preset callback") {
-    auto source = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     source->set_result(42);
     int result = 0;
     target->set_callback([&result](trial<int> &&r) { result = r.get(); });
@@ -230,8 +304,8 @@ TEST_CASE("Delay: forward preset result to preset callback") {
 }
 
 TEST_CASE("Delay: uniqueness of target shared pointer after forward") {
-    auto source = std::make_shared<delay<int>>();
-    auto target = std::make_shared<delay<int>>();
+    auto source = make_ref<delay<int>>();
+    auto target = make_ref<delay<int>>();
     delay<int>::forward(copy(source), copy(target));
     source.reset();
     CHECK(target.unique());
@@ -29,7 +29,9 @@
 #include "async/continuation.hh"
 #include "async/delay_holder.hh"
 #include "async/promise.hh"
+#include "common/direct_initialize.hh"
 #include "common/either.hh"
+#include "common/type_tag.hh"
 
 namespace sesh {
 namespace async {
@@ -43,10 +45,77 @@ class future;
 template<typename T>
 class future_base : public delay_holder<T> {
 
+private:
+
+    /**
+     * Result of a ready future. A ready future has no associated promise or
+     * delay object.
+     */
+    common::maybe<common::trial<T>> m_result;
+
+protected:
+
+    /** Returns true if this future is ready, that is, has a result. */
+    bool is_ready() const noexcept { return static_cast<bool>(m_result); }
+
+    /**
+     * Moves the result out of this ready future, which will be invalid. The
+     * behavior is undefined if this future is not ready.
+     */
+    common::trial<T> take_result() {
+        common::trial<T> t(std::move(*m_result));
+        m_result.clear();
+        return t;
+    }
+
 public:
 
     using delay_holder<T>::delay_holder;
 
+    future_base() = default;
+
+    /**
+     * Constructs a ready future that has the argument result. No memory is
+     * allocated to share the result with a promise.
+     */
+    explicit future_base(common::trial<T> &&t) :
+            delay_holder<T>(),
+            m_result(
+                    common::direct_initialize(),
+                    common::type_tag<common::trial<T>>(),
+                    std::move(t)) { }
+
+    /** The argument future will be invalid. */
+    future_base(future_base &&f) noexcept(
+            std::is_nothrow_move_constructible<
+                    common::maybe<common::trial<T>>>::value) :
+            delay_holder<T>(std::move(f)), m_result(std::move(f.m_result)) {
+        f.m_result.clear();
+    }
+
+    /** The argument future will be invalid. */
+    future_base &operator=(future_base &&f) noexcept(
+            std::is_nothrow_move_assignable<
+                    common::maybe<common::trial<T>>>::value) {
+        delay_holder<T>::operator=(std::move(f));
+        m_result = std::move(f.m_result);
+        f.m_result.clear();
+        return *this;
+    }
+
+    /**
+     * Checks if this future has an associated delay object or is ready.
+     */
+    bool is_valid() const noexcept {
+        return is_ready() || delay_holder<T>::is_valid();
+    }
+
+    /** Disconnects this future from the delay object or the result. */
+    void invalidate() noexcept {
+        m_result.clear();
+        delay_holder<T>::invalidate();
+    }
+
     /**
      * Sets a callback function to receive the result from the associated
      * promise. After the callback is set, this future instance will have no
@@ -58,6 +127,9 @@ public:
      * @tparam F Type of the callback function. It must return void when called
      * with an argument of type <code>common::trial<T> &&</code>.
      *
+     * If this future is ready, the callback is called before this function
+     * returns.
+     *
      * @return Continuation that must be resumed immediately after returning
      * from this function. Note that the continuation destructor automatically
      * resumes it so normally you can simply ignore the return value. If the
@@ -264,6 +336,13 @@ public:
  * A future instance has no associated promise if it was default-constructed or
  * a callback has been set.
  *
+ * A future whose result is known when it is created, such as those returned
+ * from {@link make_future}, is ready. A ready future holds the result by
+ * itself rather than sharing it with a promise through a delay object. Setting
+ * a callback to a ready future calls the callback immediately, so chaining
+ * ready futures with {@link future_base#then} or {@link future_base#map}
+ * allocates no memory for the futures.
+ *
  * Futures are not copyable to prevent setting multiple callbacks. The shared
  * future class, however, allows setting multiple callbacks for a single
  * promise.
@@ -22,14 +22,18 @@
 #include "future.hh"
 
 #include <cstddef>
+#include <exception>
 #include <functional>
-#include <memory>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include "async/continuation.hh"
+#include "async/ref_ptr.hh"
 #include "common/copy.hh"
+#include "common/direct_initialize.hh"
+#include "common/either.hh"
 #include "common/function_helper.hh"
+#include "common/type_tag.hh"
 
 namespace sesh {
 namespace async {
@@ -41,13 +45,18 @@ typename std::enable_if<std::is_void<typename std::result_of<
         typename std::decay<Function>::type(common::trial<T> &&)
 >::type>::value, continuation>::type
 future_base<T>::then(Function &&f) && {
+    if (is_ready()) {
+        typename std::decay<Function>::type function(
+                std::forward<Function>(f));
+        return call(function, take_result());
+    }
     return common::copy(std::move(*this)).delay().set_callback(
             std::forward<Function>(f));
 }
 
 template<typename T>
 std::pair<promise<T>, future<T>> make_promise_future_pair() {
-    auto d = std::make_shared<delay<T>>();
+    auto d = make_ref<delay<T>>();
     return std::pair<promise<T>, future<T>>(
             std::piecewise_construct,
             std::forward_as_tuple(d),
@@ -82,6 +91,8 @@ template<typename From>
 template<typename Function, typename To>
 continuation future_base<From>::then(Function &&f, promise<To> &&p) && {
     using C = composer<To, typename std::decay<Function>::type>;
+    if (is_ready())
+        return C(std::forward<Function>(f), std::move(p))(take_result());
     return common::copy(std::move(*this)).delay().set_callback(
             C(std::forward<Function>(f), std::move(p)));
 }
@@ -90,6 +101,15 @@ template<typename From>
 template<typename Function, typename To>
 typename std::enable_if<!std::is_void<To>::value, future<To>>::type
 future_base<From>::then(Function &&f) && {
+    if (is_ready()) {
+        typename std::decay<Function>::type function(
+                std::forward<Function>(f));
+        common::trial<From> r = take_result();
+        return make_future_from([&function, &r]() -> To {
+            return common::invoke(function, std::move(r));
+        });
+    }
+
     std::pair<promise<To>, future<To>> pf = make_promise_future_pair<To>();
     std::move(*this).then(std::forward<Function>(f), std::move(pf.first));
     return std::move(pf.second);
@@ -131,6 +151,18 @@ continuation future_base<From>::map(Function &&f, promise<To> &&p) && {
 template<typename From>
 template<typename Function, typename To>
 future<To> future_base<From>::map(Function &&f) && {
+    if (is_ready()) {
+        common::trial<From> r = take_result();
+        if (!r)
+            return make_failed_future<To>(
+                    r.template value<std::exception_ptr>());
+        typename std::decay<Function>::type function(
+                std::forward<Function>(f));
+        return make_future_from([&function, &r]() -> To {
+            return common::invoke(function, std::move(*r));
+        });
+    }
+
     std::pair<promise<To>, future<To>> pf = make_promise_future_pair<To>();
     std::move(*this).map(std::forward<Function>(f), std::move(pf.first));
     return std::move(pf.second);
@@ -182,6 +214,16 @@ typename std::enable_if<std::is_same<
         T, typename std::result_of<F(std::exception_ptr)>::type
 >::value, future<T>>::type
 future_base<T>::recover(F &&function) && {
+    if (is_ready()) {
+        common::trial<T> r = take_result();
+        if (r)
+            return make_future<T>(std::move(*r));
+        typename std::decay<F>::type f(std::forward<F>(function));
+        return make_future_from([&f, &r]() -> T {
+            return common::invoke(f, r.template value<std::exception_ptr>());
+        });
+    }
+
     std::pair<promise<T>, future<T>> pf = make_promise_future_pair<T>();
     std::move(*this).recover(std::forward<F>(function), std::move(pf.first));
     return std::move(pf.second);
@@ -196,22 +238,31 @@ continuation future_base<T>::forward(promise<T> &&receiver) && {
      * infinitely recursive algorithm to grow the delay object chain until it
      * eats up the heap.
      */
+    if (is_ready())
+        return std::move(receiver).set_trial(take_result());
     return delay_holder<T>::forward(std::move(*this), std::move(receiver));
 }
 
 template<typename F>
 auto make_future_from(F &&f) -> future<typename std::result_of<F()>::type> {
     using T = typename std::result_of<F()>::type;
-    std::pair<promise<T>, future<T>> pf = make_promise_future_pair<T>();
-    std::move(pf.first).set_result_from(std::forward<F>(f));
-    return std::move(pf.second);
+    try {
+        return make_future<T>(common::invoke(std::forward<F>(f)));
+    } catch (...) {
+        return make_failed_future<T>(std::current_exception());
+    }
 }
 
 template<typename T, typename... Arg>
 future<T> make_future(Arg &&... arg) {
-    std::pair<promise<T>, future<T>> pf = make_promise_future_pair<T>();
-    std::move(pf.first).set_result(std::forward<Arg>(arg)...);
-    return std::move(pf.second);
+    try {
+        return future<T>(common::trial<T>(
+                common::direct_initialize(),
+                common::type_tag<T>(),
+                std::forward<Arg>(arg)...));
+    } catch (...) {
+        return make_failed_future<T>(std::current_exception());
+    }
 }
 
 template<typename T>
@@ -221,9 +272,10 @@ auto make_future_of(T &&t) -> future<typename std::decay<T>::type> {
 
 template<typename T>
 future<T> make_failed_future(std::exception_ptr e) {
-    std::pair<promise<T>, future<T>> pf = make_promise_future_pair<T>();
-    std::move(pf.first).fail(e);
-    return std::move(pf.second);
+    return future<T>(common::trial<T>(
+            common::direct_initialize(),
+            common::type_tag<std::exception_ptr>(),
+            std::move(e)));
 }
 
 template<typename T, typename E>
@@ -238,6 +290,14 @@ continuation future_base<T>::wrap(promise<future<T>> &&p) && {
 
 template<typename T>
 future<future<T>> future_base<T>::wrap() && {
+    if (is_ready()) {
+        common::trial<T> r = take_result();
+        if (!r)
+            return make_failed_future<future<T>>(
+                    r.template value<std::exception_ptr>());
+        return make_future<future<T>>(make_future_of(std::move(*r)));
+    }
+
     std::pair<promise<future<T>>, future<future<T>>> pf =
             make_promise_future_pair<future<T>>();
     std::move(*this).wrap(std::move(pf.first));
@@ -268,12 +328,22 @@ public:
 
 template<typename T>
 continuation future<future<T>>::unwrap(promise<T> &&p) && {
+    if (this->is_ready())
+        return unwrapper<T>(std::move(p))(this->take_result());
     return common::copy(std::move(*this)).delay().set_callback(
             unwrapper<T>(std::move(p)));
 }
 
 template<typename T>
 future<T> future<future<T>>::unwrap() && {
+    if (this->is_ready()) {
+        common::trial<future<T>> r = this->take_result();
+        if (!r)
+            return make_failed_future<T>(
+                    r.template value<std::exception_ptr>());
+        return std::move(*r);
+    }
+
     std::pair<promise<T>, future<T>> pf = make_promise_future_pair<T>();
     std::move(*this).unwrap(std::move(pf.first));
     return std::move(pf.second);
@@ -0,0 +1,108 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include "allocation_counter.hh"
+#include "async/future.hh"
+#include "common/either.hh"
+#include "common/pool_allocator.hh"
+
+/*
+ * Measures the time and memory allocations needed to build and resolve a
+ * chain of futures connected by map. In the "pending" case, the whole chain
+ * is built before the result is set. In the "ready" case, the result is set
+ * first so each stage is resolved as soon as it is added.
+ */
+
+namespace {
+
+using sesh::allocation_count;
+using sesh::async::future;
+using sesh::async::make_promise_future_pair;
+using sesh::common::pool_statistics;
+using sesh::common::thread_pool_statistics;
+using sesh::common::trial;
+
+using clock = std::chrono::steady_clock;
+
+constexpr std::size_t stage_count = 1000;
+
+int increment(int i) {
+    return i + 1;
+}
+
+future<int> add_stages(future<int> &&f) {
+    for (std::size_t i = 0; i < stage_count; ++i)
+        f = std::move(f).map(increment);
+    return std::move(f);
+}
+
+int run_pending() {
+    auto pf = make_promise_future_pair<int>();
+    future<int> f = add_stages(std::move(pf.second));
+    int result = 0;
+    std::move(f).then([&result](trial<int> &&t) { result = *t; });
+    std::move(pf.first).set_result(0);
+    return result;
+}
+
+int run_ready() {
+    auto pf = make_promise_future_pair<int>();
+    std::move(pf.first).set_result(0);
+    future<int> f = add_stages(std::move(pf.second));
+    int result = 0;
+    std::move(f).then([&result](trial<int> &&t) { result = *t; });
+    return result;
+}
+
+void run(const char *name, int (&chain)()) {
+    std::size_t start_count = allocation_count();
+    pool_statistics start_pool = thread_pool_statistics();
+    clock::time_point start = clock::now();
+    int result = chain();
+    double us = std::chrono::duration<double, std::micro>(
+            clock::now() - start).count();
+    double allocations = allocation_count() - start_count;
+    const pool_statistics &pool = thread_pool_statistics();
+    double hits = pool.hits - start_pool.hits;
+    double misses = pool.misses - start_pool.misses;
+
+    std::cout << name << '\t' << result << '\t' <<
+            allocations / stage_count << '\t' <<
+            (hits + misses) / stage_count << '\t' <<
+            hits / stage_count << '\t' << us << '\n';
+}
+
+} // namespace
+
+int main() {
+    std::cout <<
+            "chain\tresult\tallocs/stage\tpooled/stage\thits/stage\t"
+            "time(us)\n";
+    for (int i = 0; i < 3; ++i) {
+        run("pending", run_pending);
+        run("ready", run_ready);
+    }
+    return 0;
+}
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
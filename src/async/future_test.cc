@@ -17,19 +17,24 @@
 
 #include "buildconfig.h"
 
+#include <cstddef>
 #include <exception>
 #include <tuple>
 #include <utility>
+#include "allocation_counter.hh"
 #include "async/delay.hh"
 #include "async/future.hh"
 #include "async/future_test_helper.hh"
 #include "async/promise.hh"
+#include "async/ref_ptr.hh"
 #include "catch.hpp"
 #include "common/either.hh"
 #include "common/nop.hh"
+#include "common/pool_allocator.hh"
 
 namespace {
 
+using sesh::allocation_count;
 using sesh::async::delay;
 using sesh::async::future;
 using sesh::async::make_failed_future_of;
@@ -37,8 +42,11 @@ using sesh::async::make_future;
 using sesh::async::make_future_from;
 using sesh::async::make_future_of;
 using sesh::async::make_promise_future_pair;
+using sesh::async::make_ref;
 using sesh::async::promise;
 using sesh::common::nop;
+using sesh::common::pool_statistics;
+using sesh::common::thread_pool_statistics;
 using sesh::common::trial;
 
 struct move_only {
@@ -52,21 +60,21 @@ TEST_CASE("Future, default construction and invalidness") {
 }
 
 TEST_CASE("Future, construction and validness") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     future<int> f(d);
     d = nullptr;
     CHECK(f.is_valid());
 }
 
 TEST_CASE("Future, invalidness after setting callback") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f(d);
     std::move(f).then(nop());
     CHECK_FALSE(f.is_valid());
 }
 
 TEST_CASE("Future, setting callback") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f(d);
 
     int i = 0;
@@ -78,7 +86,7 @@ TEST_CASE("Future, setting callback") {
 }
 
 TEST_CASE("Future, invalidness in callback") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     d->set_result(0);
     future<int> f(d);
     std::move(f).then([&f](trial<int> &&) { CHECK_FALSE(f.is_valid()); });
@@ -95,7 +103,7 @@ TEST_CASE("Create promise/future pair") {
 }
 
 TEST_CASE("Future, then, to promise, success") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
     std::pair<promise<double>, future<double>> pf2 =
             make_promise_future_pair<double>();
@@ -115,7 +123,7 @@ TEST_CASE("Future, then, to promise, success") {
 }
 
 TEST_CASE("Future, then, returning future, success") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
 
     int i = 0;
@@ -133,7 +141,7 @@ TEST_CASE("Future, then, returning future, success") {
 }
 
 TEST_CASE("Future, then, returning future, failure") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
 
     const auto f = [](trial<int> &&) -> char { throw 2.0; };
@@ -154,7 +162,7 @@ TEST_CASE("Future, then, returning future, failure") {
 }
 
 TEST_CASE("Future, map, to promise, success") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
     std::pair<promise<double>, future<double>> pf2 =
             make_promise_future_pair<double>();
@@ -186,7 +194,7 @@ TEST_CASE("Future, map, returning future, success, movable function") {
         }
     };
 
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
 
     int i = 0;
@@ -204,7 +212,7 @@ TEST_CASE("Future, map, returning future, success, movable function") {
 
 TEST_CASE(
         "Future, map, returning future, success, copyable constant function") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
 
     int i = 0;
@@ -222,7 +230,7 @@ TEST_CASE(
 }
 
 TEST_CASE("Future, map, returning future, failure propagation") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
 
     const auto f = [](int &&) -> char { FAIL("unexpected"); return 'a'; };
@@ -243,7 +251,7 @@ TEST_CASE("Future, map, returning future, failure propagation") {
 }
 
 TEST_CASE("Future, map, failure in callback") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     future<int> f1(dly);
 
     int i = 0;
@@ -267,7 +275,7 @@ TEST_CASE("Future, map, failure in callback") {
 }
 
 TEST_CASE("Future, recover, to promise, success") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f1(d);
     std::pair<promise<int>, future<int>> pf2 = make_promise_future_pair<int>();
 
@@ -296,7 +304,7 @@ TEST_CASE("Future, recover, returning future, success, movable function") {
         }
     };
 
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f1(d);
     future<int> f2 = std::move(f1).recover(movable_function());
 
@@ -311,7 +319,7 @@ TEST_CASE("Future, recover, returning future, success, movable function") {
 TEST_CASE(
         "Future, recover, returning future, success, "
         "copyable constant function") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f1(d);
     const auto f = [](std::exception_ptr) -> int {
         FAIL("unexpected exception");
@@ -328,7 +336,7 @@ TEST_CASE(
 }
 
 TEST_CASE("Future, recover from exception") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f1(d);
     const auto f = [](std::exception_ptr e) -> int {
         try {
@@ -349,7 +357,7 @@ TEST_CASE("Future, recover from exception") {
 }
 
 TEST_CASE("Future, recovery failure") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     future<int> f1(d);
     const auto f = [](std::exception_ptr) -> int { throw 2.0; };
     future<int> f2 = std::move(f1).recover(f);
@@ -522,6 +530,53 @@ TEST_CASE("Future, unwrap, failure in second") {
     CHECK(d == 1.0);
 }
 
+/**
+ * Returns the number of heap allocations so far, including those served by
+ * the memory pool, so that the result changes whenever a delay is allocated
+ * whether or not the delay pool is enabled. Note that Catch assertions may
+ * allocate, too.
+ */
+std::size_t allocations() {
+    pool_statistics s = thread_pool_statistics();
+    return allocation_count() + s.hits + s.misses;
+}
+
+TEST_CASE("Future, ready future is valid until callback is set") {
+    future<int> f = make_future_of(1);
+    CHECK(f.is_valid());
+    future<int> g = std::move(f);
+    CHECK_FALSE(f.is_valid());
+    CHECK(g.is_valid());
+    std::move(g).then(nop());
+    CHECK_FALSE(g.is_valid());
+}
+
+TEST_CASE("Future, ready future runs callbacks synchronously") {
+    const std::size_t count = allocations();
+    int i = 0;
+    make_future_of(1).map([](int &&v) { return v + 1; }).then(
+            [&i](trial<int> &&r) { i = r.get(); });
+    const std::size_t new_count = allocations();
+    CHECK(i == 2);
+    CHECK(new_count == count);
+}
+
+TEST_CASE("Future, ready failed future propagates exception") {
+    const std::size_t count = allocations();
+    double d = 0.0;
+    make_failed_future_of<int>(1.0).map([](int &&v) { return v; }).then(
+            [&d](trial<int> &&r) {
+        try {
+            r.get();
+        } catch (double v) {
+            d = v;
+        }
+    });
+    const std::size_t new_count = allocations();
+    CHECK(d == 1.0);
+    CHECK(new_count == count);
+}
+
 } // namespace
 
 /* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
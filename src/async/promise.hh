@@ -27,6 +27,7 @@
 #include "async/delay_holder.hh"
 #include "common/copy.hh"
 #include "common/direct_initialize.hh"
+#include "common/either.hh"
 #include "common/function_helper.hh"
 #include "common/type_tag.hh"
 
@@ -78,6 +79,25 @@ public:
                 std::forward<Arg>(arg)...);
     }
 
+    /**
+     * Sets the result of the associated future to the argument trial, which
+     * may contain either a value or an exception. After the result is set,
+     * this promise will have no associated future.
+     *
+     * The behavior is undefined if this promise has no associated future.
+     *
+     * @return Continuation that must be resumed immediately after returning
+     * from this function. Note that the continuation destructor automatically
+     * resumes it so normally you can simply ignore the return value. If the
+     * callback has already been set to the associated future, the continuation
+     * calls the callback passing the result to it. Otherwise, the continuation
+     * is a nop.
+     */
+    continuation set_trial(common::trial<T> &&t) && {
+        return common::copy(std::move(*this)).delay().set_result(
+                std::move(t));
+    }
+
     /**
      * Sets the result of the associated future to the given exception. After
      * the result is set, this promise will have no associated future.
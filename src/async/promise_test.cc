@@ -20,13 +20,16 @@
 #include <utility>
 #include "async/delay.hh"
 #include "async/promise.hh"
+#include "async/ref_ptr.hh"
 #include "catch.hpp"
 #include "common/either.hh"
 
 namespace {
 
 using sesh::async::delay;
+using sesh::async::make_ref;
 using sesh::async::promise;
+using sesh::async::ref_ptr;
 using sesh::common::trial;
 
 TEST_CASE("Promise, default construction and invalidness") {
@@ -35,14 +38,14 @@ TEST_CASE("Promise, default construction and invalidness") {
 }
 
 TEST_CASE("Promise, construction and validness") {
-    std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    ref_ptr<delay<int>> d = make_ref<delay<int>>();
     promise<int> p(d);
     d = nullptr;
     CHECK(p.is_valid());
 }
 
 TEST_CASE("Promise, invalidness after setting result") {
-    const std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    const ref_ptr<delay<int>> d = make_ref<delay<int>>();
     promise<int> p(d);
     std::move(p).set_result(0);
     CHECK_FALSE(p.is_valid());
@@ -50,7 +53,7 @@ TEST_CASE("Promise, invalidness after setting result") {
 
 TEST_CASE("Promise, setting result by construction, value") {
     using P = std::pair<int, double>;
-    const std::shared_ptr<delay<P>> dly = std::make_shared<delay<P>>();
+    const ref_ptr<delay<P>> dly = make_ref<delay<P>>();
     promise<P> p(dly);
     std::move(p).set_result(1, 2.0);
 
@@ -62,14 +65,14 @@ TEST_CASE("Promise, setting result by construction, value") {
 }
 
 TEST_CASE("Promise, setting result by construction, invalidness") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     promise<int> p(d);
     d->set_callback([&p](trial<int> &&) { CHECK_FALSE(p.is_valid()); });
     std::move(p).set_result(0);
 }
 
 TEST_CASE("Promise, setting result by function, value") {
-    const std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    const ref_ptr<delay<int>> d = make_ref<delay<int>>();
     promise<int> p(d);
     std::move(p).set_result_from([] { return 1; });
 
@@ -79,14 +82,14 @@ TEST_CASE("Promise, setting result by function, value") {
 }
 
 TEST_CASE("Promise, setting result by function, invalidness") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     promise<int> p(d);
     d->set_callback([&p](trial<int> &&) { CHECK_FALSE(p.is_valid()); });
     std::move(p).set_result_from([] { return 0; });
 }
 
 TEST_CASE("Promise, setting result to exception, value") {
-    const std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    const ref_ptr<delay<int>> d = make_ref<delay<int>>();
     promise<int> p(d);
     std::move(p).fail(std::make_exception_ptr('\1'));
 
@@ -102,14 +105,14 @@ TEST_CASE("Promise, setting result to exception, value") {
 }
 
 TEST_CASE("Promise, setting result to exception, invalidness") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     promise<int> p(d);
     d->set_callback([&p](trial<int> &&) { CHECK_FALSE(p.is_valid()); });
     std::move(p).fail(std::make_exception_ptr(0));
 }
 
 TEST_CASE("Promise, setting result to current exception, value") {
-    const std::shared_ptr<delay<int>> d = std::make_shared<delay<int>>();
+    const ref_ptr<delay<int>> d = make_ref<delay<int>>();
     promise<int> p(d);
     try {
         throw '\1';
@@ -129,7 +132,7 @@ TEST_CASE("Promise, setting result to current exception, value") {
 }
 
 TEST_CASE("Promise, setting result to current exception, invalidness") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     promise<int> p(d);
     d->set_callback([&p](trial<int> &&) { CHECK_FALSE(p.is_valid()); });
     try {
@@ -0,0 +1,243 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_async_ref_ptr_hh
+#define INCLUDED_async_ref_ptr_hh
+
+#include "buildconfig.h"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#ifdef SESH_THREAD_SAFE_ASYNC
+#include <atomic>
+#elif defined SESH_DEBUG_BUILD
+#include <thread>
+#endif
+
+namespace sesh {
+namespace async {
+
+/**
+ * Base class of objects whose lifetime is managed by {@link ref_ptr}. The
+ * reference count is embedded in the object, so a pointer to the object is
+ * all that is needed to share the ownership.
+ *
+ * The shell runs the asynchronous primitives in a single thread, so the
+ * reference count is not atomic unless the program is compiled with the
+ * SESH_THREAD_SAFE_ASYNC macro defined. Without the macro, a build configured
+ * with --enable-debug-build (which defines SESH_DEBUG_BUILD) asserts that the
+ * reference count is modified only in the thread that constructed the object.
+ *
+ * An object must be allocated by the new operator because it is destroyed by
+ * the delete operator when the last reference is released.
+ */
+class ref_counted {
+
+public:
+
+#ifdef SESH_THREAD_SAFE_ASYNC
+    using count_type = std::atomic<std::size_t>;
+#else
+    using count_type = std::size_t;
+#endif
+
+private:
+
+    mutable count_type m_count;
+
+#if !defined SESH_THREAD_SAFE_ASYNC && defined SESH_DEBUG_BUILD
+    std::thread::id m_owner = std::this_thread::get_id();
+
+    void check_thread() const noexcept {
+        assert(m_owner == std::this_thread::get_id() &&
+                "reference count modified from another thread");
+    }
+#else
+    void check_thread() const noexcept { }
+#endif
+
+protected:
+
+    ref_counted() noexcept : m_count(0) { }
+
+    /** The reference count is not copied. */
+    ref_counted(const ref_counted &) noexcept : ref_counted() { }
+
+    /** The reference count is not copied. */
+    ref_counted &operator=(const ref_counted &) noexcept { return *this; }
+
+public:
+
+    virtual ~ref_counted() = default;
+
+    /** Returns the number of ref_ptrs that refer to this object. */
+    std::size_t ref_count() const noexcept { return m_count; }
+
+    void add_ref() const noexcept {
+        check_thread();
+        ++m_count;
+    }
+
+    /** Deletes this object if the reference count becomes zero. */
+    void release() const noexcept {
+        check_thread();
+        if (--m_count == 0)
+            delete this;
+    }
+
+}; // class ref_counted
+
+/**
+ * A ref_ptr is a smart pointer that shares the ownership of a {@link
+ * ref_counted} object. It is lighter than std::shared_ptr: it is as large as
+ * a raw pointer and needs no separate control block. It does not support weak
+ * references.
+ *
+ * @tparam T Type of the pointed-to object, which must be derived from
+ * ref_counted (optionally const-qualified).
+ */
+template<typename T>
+class ref_ptr {
+
+private:
+
+    T *m_pointer;
+
+    template<typename U>
+    friend class ref_ptr;
+
+    template<typename U>
+    using enable_if_convertible = typename std::enable_if<
+            std::is_convertible<U *, T *>::value>::type;
+
+public:
+
+    using element_type = T;
+
+    constexpr ref_ptr() noexcept : m_pointer(nullptr) { }
+
+    constexpr ref_ptr(std::nullptr_t) noexcept : m_pointer(nullptr) { }
+
+    /** Shares the ownership of the argument object, which may be null. */
+    explicit ref_ptr(T *p) noexcept : m_pointer(p) {
+        if (p != nullptr)
+            p->add_ref();
+    }
+
+    ref_ptr(const ref_ptr &p) noexcept : ref_ptr(p.m_pointer) { }
+
+    ref_ptr(ref_ptr &&p) noexcept : m_pointer(p.m_pointer) {
+        p.m_pointer = nullptr;
+    }
+
+    template<typename U, typename = enable_if_convertible<U>>
+    ref_ptr(const ref_ptr<U> &p) noexcept : ref_ptr(p.m_pointer) { }
+
+    template<typename U, typename = enable_if_convertible<U>>
+    ref_ptr(ref_ptr<U> &&p) noexcept : m_pointer(p.m_pointer) {
+        p.m_pointer = nullptr;
+    }
+
+    ~ref_ptr() {
+        if (m_pointer != nullptr)
+            m_pointer->release();
+    }
+
+    ref_ptr &operator=(const ref_ptr &p) noexcept {
+        ref_ptr(p).swap(*this);
+        return *this;
+    }
+
+    ref_ptr &operator=(ref_ptr &&p) noexcept {
+        ref_ptr(std::move(p)).swap(*this);
+        return *this;
+    }
+
+    void swap(ref_ptr &p) noexcept {
+        std::swap(m_pointer, p.m_pointer);
+    }
+
+    /** Makes this pointer null. */
+    void reset() noexcept {
+        ref_ptr().swap(*this);
+    }
+
+    T *get() const noexcept { return m_pointer; }
+    T &operator*() const noexcept { return *m_pointer; }
+    T *operator->() const noexcept { return m_pointer; }
+
+    explicit operator bool() const noexcept { return m_pointer != nullptr; }
+
+    /** Returns the reference count of the object or zero if null. */
+    std::size_t use_count() const noexcept {
+        return m_pointer == nullptr ? 0 : m_pointer->ref_count();
+    }
+
+    bool unique() const noexcept { return use_count() == 1; }
+
+}; // template<typename T> class ref_ptr
+
+template<typename T>
+void swap(ref_ptr<T> &a, ref_ptr<T> &b) noexcept {
+    a.swap(b);
+}
+
+template<typename T, typename U>
+bool operator==(const ref_ptr<T> &a, const ref_ptr<U> &b) noexcept {
+    return a.get() == b.get();
+}
+
+template<typename T, typename U>
+bool operator!=(const ref_ptr<T> &a, const ref_ptr<U> &b) noexcept {
+    return a.get() != b.get();
+}
+
+template<typename T>
+bool operator==(const ref_ptr<T> &a, std::nullptr_t) noexcept {
+    return a.get() == nullptr;
+}
+
+template<typename T>
+bool operator==(std::nullptr_t, const ref_ptr<T> &a) noexcept {
+    return a.get() == nullptr;
+}
+
+template<typename T>
+bool operator!=(const ref_ptr<T> &a, std::nullptr_t) noexcept {
+    return a.get() != nullptr;
+}
+
+template<typename T>
+bool operator!=(std::nullptr_t, const ref_ptr<T> &a) noexcept {
+    return a.get() != nullptr;
+}
+
+/** Constructs a new object and returns a ref_ptr to it. */
+template<typename T, typename... A>
+ref_ptr<T> make_ref(A &&... a) {
+    return ref_ptr<T>(new T(std::forward<A>(a)...));
+}
+
+} // namespace async
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_async_ref_ptr_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
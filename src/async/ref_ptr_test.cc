@@ -0,0 +1,121 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <utility>
+#include "async/ref_ptr.hh"
+#include "catch.hpp"
+
+namespace {
+
+using sesh::async::make_ref;
+using sesh::async::ref_counted;
+using sesh::async::ref_ptr;
+
+class base : public ref_counted {
+
+public:
+
+    int &destroyed;
+
+    explicit base(int &d) noexcept : destroyed(d) { }
+    ~base() { ++destroyed; }
+
+}; // class base
+
+class derived : public base {
+
+    using base::base;
+
+}; // class derived
+
+TEST_CASE("Ref pointer: default construction") {
+    ref_ptr<base> p;
+    CHECK_FALSE(p);
+    CHECK(p == nullptr);
+    CHECK(p.use_count() == 0);
+}
+
+TEST_CASE("Ref pointer: last reference deletes object") {
+    int destroyed = 0;
+    auto p1 = make_ref<base>(destroyed);
+    CHECK(p1.unique());
+
+    ref_ptr<base> p2 = p1;
+    CHECK(p1 == p2);
+    CHECK(p1.use_count() == 2);
+
+    p1.reset();
+    CHECK(p1 == nullptr);
+    CHECK(p2.unique());
+    CHECK(destroyed == 0);
+
+    p2.reset();
+    CHECK(destroyed == 1);
+}
+
+TEST_CASE("Ref pointer: move") {
+    int destroyed = 0;
+    auto p1 = make_ref<base>(destroyed);
+    base *raw = p1.get();
+
+    ref_ptr<base> p2 = std::move(p1);
+    CHECK(p1 == nullptr);
+    CHECK(p2.get() == raw);
+    CHECK(p2.unique());
+
+    p1 = std::move(p2);
+    CHECK(p1.get() == raw);
+    CHECK(p2 == nullptr);
+    CHECK(destroyed == 0);
+}
+
+TEST_CASE("Ref pointer: conversion to base") {
+    int destroyed = 0;
+    ref_ptr<derived> p1 = make_ref<derived>(destroyed);
+    ref_ptr<const base> p2 = p1;
+    CHECK(p1 == p2);
+    CHECK(p2.use_count() == 2);
+
+    ref_ptr<base> p3 = std::move(p1);
+    CHECK(p1 == nullptr);
+    CHECK(p2.use_count() == 2);
+
+    p2.reset();
+    p3.reset();
+    CHECK(destroyed == 1);
+}
+
+TEST_CASE("Ref pointer: raw pointer shares reference count") {
+    int destroyed = 0;
+    auto p1 = make_ref<base>(destroyed);
+    ref_ptr<base> p2(p1.get());
+    CHECK(p2.use_count() == 2);
+}
+
+TEST_CASE("Ref pointer: copied object has own reference count") {
+    int destroyed = 0;
+    auto p1 = make_ref<base>(destroyed);
+    auto p2 = make_ref<base>(*p1);
+    CHECK(p1.unique());
+    CHECK(p2.unique());
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
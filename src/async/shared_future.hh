@@ -21,8 +21,9 @@
 #include "buildconfig.h"
 
 #include <cstddef>
-#include <memory>
 #include "async/future.hh"
+#include "async/ref_ptr.hh"
+#include "common/either.hh"
 
 namespace sesh {
 namespace async {
@@ -40,7 +41,7 @@ private:
     class impl;
 
     /** May be null. */
-    std::shared_ptr<impl> m_impl;
+    ref_ptr<impl> m_impl;
 
 public:
 
@@ -77,6 +78,14 @@ public:
     /** True if this future is valid. */
     explicit operator bool() const noexcept;
 
+    /**
+     * Returns a pointer to the result of this shared future if the result has
+     * already been set by the associated promise. Returns null otherwise. The
+     * behavior is undefined if this future instance has no associated
+     * promise.
+     */
+    const common::trial<T> *peek() const noexcept;
+
     /**
      * Adds a callback function to receive the result from the associated
      * promise.
@@ -28,6 +28,7 @@
 #include <utility>
 #include <vector>
 #include "async/future.tcc"
+#include "async/ref_ptr.hh"
 #include "common/either.hh"
 #include "common/function_helper.hh"
 #include "common/identity.hh"
@@ -37,7 +38,7 @@ namespace async {
 namespace future_impl {
 
 template<typename T>
-class shared_future_base<T>::impl {
+class shared_future_base<T>::impl : public ref_counted {
 
 public:
 
@@ -92,6 +93,11 @@ private:
 
 public:
 
+    /** Returns a pointer to the result or null if it is not yet set. */
+    const common::trial<T> *result() const noexcept {
+        return m_result ? &*m_result : nullptr;
+    }
+
     void set_result(common::trial<T> &&);
 
     void add_callback(callback_pointer &&);
@@ -142,7 +148,7 @@ shared_future_base<T>::shared_future_base(future<T> &&f) : m_impl() {
     if (!f.is_valid())
         return;
 
-    m_impl = std::make_shared<impl>();
+    m_impl = make_ref<impl>();
 
     auto &impl = m_impl;
     std::move(f).then([impl](common::trial<T> &&t) {
@@ -172,6 +178,11 @@ shared_future_base<T>::operator bool() const noexcept {
     return is_valid();
 }
 
+template<typename T>
+const common::trial<T> *shared_future_base<T>::peek() const noexcept {
+    return m_impl->result();
+}
+
 template<typename T>
 template<typename Function>
 typename std::enable_if<std::is_void<typename std::result_of<
@@ -22,6 +22,7 @@
 #include "async/delay.hh"
 #include "async/future.hh"
 #include "async/promise.hh"
+#include "async/ref_ptr.hh"
 #include "async/shared_future.hh"
 #include "catch.hpp"
 #include "common/either.hh"
@@ -35,6 +36,7 @@ using sesh::async::make_failed_future_of;
 using sesh::async::make_future;
 using sesh::async::make_future_of;
 using sesh::async::make_promise_future_pair;
+using sesh::async::make_ref;
 using sesh::async::promise;
 using sesh::async::shared_future;
 using sesh::common::nop;
@@ -65,13 +67,25 @@ TEST_CASE("Shared future: construction from future and invalidness") {
 }
 
 TEST_CASE("Shared future: construction from future and validness") {
-    auto d = std::make_shared<delay<int>>();
+    auto d = make_ref<delay<int>>();
     const shared_future<int> f((future<int>(d)));
     d = nullptr;
     CHECK(f.is_valid());
     CHECK(f);
 }
 
+TEST_CASE("Shared future: peek") {
+    auto pf = make_promise_future_pair<int>();
+    const shared_future<int> f(std::move(pf.second));
+    CHECK(f.peek() == nullptr);
+
+    std::move(pf.first).set_result(5);
+    const trial<int> *t = f.peek();
+    REQUIRE(t != nullptr);
+    REQUIRE(*t);
+    CHECK(**t == 5);
+}
+
 TEST_CASE("Shared future: is default constructible") {
     shared_future<int> f;
     (void) f;
@@ -96,10 +110,10 @@ TEST_CASE("Shared future: is mutually comparable") {
     CHECK_FALSE(invalid1 != invalid2);
 
     const shared_future<int> valid1 =
-                future<int>(std::make_shared<delay<int>>());
+                future<int>(make_ref<delay<int>>());
     const shared_future<int> copy1(valid1);
     const shared_future<int> valid2 =
-                future<int>(std::make_shared<delay<int>>());
+                future<int>(make_ref<delay<int>>());
     CHECK(valid1 == copy1);
     CHECK_FALSE(valid1 != copy1);
     CHECK_FALSE(valid1 == valid2);
@@ -117,7 +131,7 @@ TEST_CASE("Shared future: is comparable with null pointer") {
     CHECK_FALSE(nullptr != invalid);
 
     const shared_future<int> valid =
-                future<int>(std::make_shared<delay<int>>());
+                future<int>(make_ref<delay<int>>());
     CHECK_FALSE(valid == nullptr);
     CHECK_FALSE(nullptr == valid);
     CHECK(valid != nullptr);
@@ -125,14 +139,14 @@ TEST_CASE("Shared future: is comparable with null pointer") {
 }
 
 TEST_CASE("Shared future: validness after adding callback") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     const shared_future<int> f = future<int>(d);
     f.then(nop());
     CHECK(f.is_valid());
 }
 
 TEST_CASE("Shared future: callbacks added before setting result") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     const shared_future<int> f = future<int>(d);
 
     int i = 0, j = 0;
@@ -149,7 +163,7 @@ TEST_CASE("Shared future: callbacks added before setting result") {
 }
 
 TEST_CASE("Shared future: callbacks added after setting result") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     const shared_future<int> f = future<int>(d);
     d->set_result(1);
 
@@ -165,7 +179,7 @@ TEST_CASE("Shared future: callbacks added after setting result") {
 }
 
 TEST_CASE("Shared future: then") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     const shared_future<int> f1 = future<int>(dly);
     std::pair<promise<double>, future<double>> pf2 =
             make_promise_future_pair<double>();
@@ -194,7 +208,7 @@ TEST_CASE("Shared future: then") {
 }
 
 TEST_CASE("Shared future: map") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     const shared_future<int> f1 = future<int>(dly);
     std::pair<promise<double>, future<double>> pf2 =
             make_promise_future_pair<double>();
@@ -221,7 +235,7 @@ TEST_CASE("Shared future: map") {
 }
 
 TEST_CASE("Shared future: recover, success") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     const shared_future<int> f1 = future<int>(d);
     std::pair<promise<int>, future<int>> pf2 = make_promise_future_pair<int>();
 
@@ -240,7 +254,7 @@ TEST_CASE("Shared future: recover, success") {
 }
 
 TEST_CASE("Shared future: recover, failure") {
-    const auto dly = std::make_shared<delay<int>>();
+    const auto dly = make_ref<delay<int>>();
     const shared_future<int> f1 = future<int>(dly);
 
     int i = 0;
@@ -277,7 +291,7 @@ TEST_CASE("Shared future: recover, failure") {
 }
 
 TEST_CASE("Shared future: forward") {
-    const auto d = std::make_shared<delay<int>>();
+    const auto d = make_ref<delay<int>>();
     const shared_future<int> f1 = future<int>(d);
     std::pair<promise<int>, future<int>> pf2 = make_promise_future_pair<int>();
     std::pair<promise<int>, future<int>> pf3 = make_promise_future_pair<int>();
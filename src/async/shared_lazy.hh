@@ -21,15 +21,17 @@
 #include "buildconfig.h"
 
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include "async/lazy.hh"
+#include "async/ref_ptr.hh"
 
 namespace sesh {
 namespace async {
 
 /**
  * A shared lazy is contains a {@link lazy} that is shared with other shared
- * lazy objects. It is basically a shared pointer to a lazy object, but the
+ * lazy objects. It is basically a {@link ref_ptr} to a lazy object, but the
  * pointer can never be null.
  *
  * @tparam T Type of lazily computed value (optionally const-qualified).
@@ -59,45 +61,61 @@ public:
 
 private:
 
-    std::shared_ptr<lazy_type> m_shared_ptr;
+    class node : public ref_counted {
+
+    public:
+
+        class lazy<typename std::remove_const<T>::type> value;
+
+        template<typename... A>
+        explicit node(A &&... a) : value(std::forward<A>(a)...) { }
+
+    }; // class node
+
+    /** Owner of the lazy object. */
+    ref_ptr<const ref_counted> m_owner;
+
+    lazy_type *m_lazy;
+
+    explicit shared_lazy(const ref_ptr<node> &n) noexcept :
+            m_owner(n), m_lazy(std::addressof(n->value)) { }
 
 public:
 
     /**
      * Constructs a shared lazy that contains a new default-constructed lazy.
      */
-    shared_lazy() : m_shared_ptr(std::make_shared<lazy_type>()) { }
+    shared_lazy() : shared_lazy(make_ref<node>()) { }
 
     /** Constructs a shared lazy value with an already computed value. */
-    shared_lazy(const result_type &v) :
-            m_shared_ptr(std::make_shared<lazy_type>(v)) { }
+    shared_lazy(const result_type &v) : shared_lazy(make_ref<node>(v)) { }
 
     /** Constructs a shared lazy value with an already computed value. */
     shared_lazy(result_type &&v) :
-            m_shared_ptr(std::make_shared<lazy_type>(std::move(v))) { }
+            shared_lazy(make_ref<node>(std::move(v))) { }
 
     /**
      * Constructs a lazy value with a value computing function. The function
      * will be called once when the value is needed.
      */
     explicit shared_lazy(const result_maker &f) :
-            m_shared_ptr(std::make_shared<lazy_type>(f)) { }
+            shared_lazy(make_ref<node>(f)) { }
 
     /**
      * Constructs a lazy value with a value computing function. The function
      * will be called once when the value is needed.
      */
     explicit shared_lazy(result_maker &&f) :
-            m_shared_ptr(std::make_shared<lazy_type>(std::move(f))) { }
+            shared_lazy(make_ref<node>(std::move(f))) { }
 
     /**
      * Constructs a lazy value with an existing lazy object to be shared.
-     * @param p Shared pointer managing the shared lazy object @c l.
+     * @param p Pointer to the object that owns the shared lazy object @c l.
      * @param l Lazy object to be shared.
      */
     template<typename U>
-    shared_lazy(const std::shared_ptr<U> &p, lazy_type &l) noexcept :
-            m_shared_ptr(p, std::addressof(l)) { }
+    shared_lazy(const ref_ptr<U> &p, lazy_type &l) noexcept :
+            m_owner(p), m_lazy(std::addressof(l)) { }
 
     shared_lazy(const shared_lazy &) = default;
     shared_lazy &operator=(const shared_lazy &) = default;
@@ -105,12 +123,8 @@ public:
     // constructor and assignment operator are always used to ensure the shared
     // lazy always has a non-null pointer.
 
-    const std::shared_ptr<lazy_type> &shared_ptr() const noexcept {
-        return m_shared_ptr;
-    }
-
     lazy_type &lazy() const noexcept {
-        return *shared_ptr();
+        return *m_lazy;
     }
 
     /** Returns true iff the value has been computed. */
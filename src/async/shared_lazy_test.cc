@@ -19,11 +19,14 @@
 
 #include <utility>
 #include "catch.hpp"
+#include "async/ref_ptr.hh"
 #include "async/shared_lazy.hh"
 
 namespace {
 
 using sesh::async::lazy;
+using sesh::async::make_ref;
+using sesh::async::ref_counted;
 using sesh::async::shared_lazy;
 
 struct move_only {
@@ -57,11 +60,17 @@ TEST_CASE("Shared lazy with already computed value (const)") {
     CHECK(l->get() == 3);
 }
 
-TEST_CASE("Shared lazy with existing shared pointer") {
-    const auto p = std::make_shared<const lazy<int>>();
-    shared_lazy<const int> l(p, *p);
+TEST_CASE("Shared lazy with existing owner") {
+    class owner : public ref_counted {
+    public:
+        const lazy<int> value;
+    };
+
+    const auto p = make_ref<const owner>();
+    shared_lazy<const int> l(p, p->value);
+    CHECK(p.use_count() == 2);
     (void) *l;
-    CHECK((**p).get() == int());
+    CHECK((*p->value).get() == int());
 }
 
 TEST_CASE("Shared lazy value computation") {
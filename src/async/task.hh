@@ -0,0 +1,202 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_async_task_hh
+#define INCLUDED_async_task_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <exception>
+#include <utility>
+#include "async/future.hh"
+#include "async/promise.hh"
+#include "async/ref_ptr.hh"
+#include "common/either.hh"
+#include "common/pool_allocator.hh"
+
+namespace sesh {
+namespace async {
+
+/**
+ * Starts a task of the argument type. The task is constructed from the
+ * arguments and its <code>start</code> member function is called. The
+ * returned future receives the result the task completes with.
+ *
+ * If the constructor or the start function throws, the exception is set to
+ * the returned future.
+ */
+template<typename Task, typename... Arg>
+future<typename Task::result_type> start_task(Arg &&...);
+
+/**
+ * A task is an asynchronous operation that awaits futures one at a time and
+ * eventually completes the future returned from {@link start_task}. It plays
+ * the role of a coroutine frame: the derived class keeps the variables that
+ * live across awaits as its data members and splits the operation into
+ * member functions, each of which resumes the operation when an awaited
+ * future receives its result.
+ *
+ * Awaiting a future does not allocate any shared state: the task is set as
+ * the callback of the awaited future, so it is the only object allocated for
+ * the whole operation, however many futures it awaits. In contrast, every
+ * hop of a <code>then(...).unwrap()</code> chain allocates two more futures.
+ * Unless SESH_NO_DELAY_POOL is defined, tasks are allocated from the memory
+ * pool of the current thread (see {@link common::memory_pool}).
+ *
+ * The derived class must have a public member function <code>void
+ * start()</code>, which begins the operation. The start function and every
+ * resuming function must either await a future or complete the task before
+ * returning. If none of them does, the task is destroyed without completing
+ * and the future returned from start_task never receives a result. An
+ * exception thrown from the functions completes the task with the exception.
+ * If the task has already completed, the exception is ignored: it is neither
+ * rethrown from a continuation nor from start_task.
+ *
+ * If the awaited future already has a result, the resuming function is called
+ * before the await function returns.
+ *
+ * @tparam T The result type of the task.
+ * @tparam Derived The derived class (CRTP).
+ */
+template<typename T, typename Derived>
+class task : public ref_counted {
+
+public:
+
+    using result_type = T;
+
+#ifndef SESH_NO_DELAY_POOL
+
+    static void *operator new(std::size_t size) {
+        return common::memory_pool::instance().allocate(size);
+    }
+
+    static void operator delete(void *p, std::size_t size) noexcept {
+        common::memory_pool::instance().deallocate(p, size);
+    }
+
+#endif // #ifndef SESH_NO_DELAY_POOL
+
+private:
+
+    /** Callback that resumes a task with the result of an awaited future. */
+    template<typename U>
+    class resumer {
+
+    public:
+
+        ref_ptr<Derived> target;
+        void (Derived::*function)(common::trial<U> &&);
+
+        void operator()(common::trial<U> &&t) const {
+            Derived &d = *target;
+            try {
+                (d.*function)(std::move(t));
+            } catch (...) {
+                static_cast<task &>(d).fail_with_current_exception();
+            }
+        }
+
+    }; // template<typename U> class resumer
+
+    promise<T> m_promise;
+
+    template<typename Task, typename... Arg>
+    friend future<typename Task::result_type> start_task(Arg &&...);
+
+protected:
+
+    task() = default;
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    /** Checks if this task has not yet completed. */
+    bool is_running() const noexcept { return m_promise.is_valid(); }
+
+    /**
+     * Awaits the argument future. When the future receives a result, the
+     * argument member function is called with it. This task is kept alive
+     * until then.
+     *
+     * The behavior is undefined if the future is invalid.
+     */
+    template<typename U>
+    void await(
+            future<U> &&f, void (Derived::*resume)(common::trial<U> &&)) {
+        std::move(f).then(resumer<U>{
+                ref_ptr<Derived>(static_cast<Derived *>(this)), resume});
+    }
+
+    /**
+     * Completes this task with the result constructed from the arguments.
+     * The behavior is undefined if this task has already completed.
+     */
+    template<typename... Arg>
+    void complete(Arg &&... arg) {
+        std::move(m_promise).set_result(std::forward<Arg>(arg)...);
+    }
+
+    /**
+     * Completes this task with the result of the argument future, which is
+     * usually returned from another asynchronous operation. The behavior is
+     * undefined if this task has already completed.
+     */
+    void complete_with(future<T> &&f) {
+        std::move(f).forward(std::move(m_promise));
+    }
+
+    /**
+     * Completes this task with the current exception. This function can be
+     * called in a catch clause only. If this task has already completed, the
+     * exception is ignored.
+     */
+    void fail_with_current_exception() {
+        if (!is_running())
+            return;
+        std::move(m_promise).fail_with_current_exception();
+    }
+
+}; // template<typename T, typename Derived> class task
+
+template<typename Task, typename... Arg>
+future<typename Task::result_type> start_task(Arg &&... arg) {
+    using T = typename Task::result_type;
+
+    ref_ptr<Task> t;
+    try {
+        t = make_ref<Task>(std::forward<Arg>(arg)...);
+    } catch (...) {
+        return make_failed_future<T>(std::current_exception());
+    }
+
+    auto pf = make_promise_future_pair<T>();
+    t->m_promise = std::move(pf.first);
+    try {
+        t->start();
+    } catch (...) {
+        t->fail_with_current_exception();
+    }
+    return std::move(pf.second);
+}
+
+} // namespace async
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_async_task_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
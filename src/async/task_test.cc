@@ -0,0 +1,242 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <exception>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "async/promise.hh"
+#include "async/task.hh"
+#include "catch.hpp"
+#include "common/either.hh"
+
+namespace {
+
+using sesh::async::future;
+using sesh::async::make_failed_future_of;
+using sesh::async::make_future_of;
+using sesh::async::make_promise_future_pair;
+using sesh::async::promise;
+using sesh::async::start_task;
+using sesh::async::task;
+using sesh::common::trial;
+
+/** Sums up the results of the futures, awaiting them from the back. */
+class summer : public task<int, summer> {
+
+public:
+
+    std::vector<future<int>> inputs;
+    int &destroyed;
+    int sum = 0;
+
+    summer(std::vector<future<int>> &&fs, int &d) :
+            inputs(std::move(fs)), destroyed(d) { }
+
+    ~summer() { ++destroyed; }
+
+    void start() { proceed(); }
+
+private:
+
+    void proceed() {
+        if (inputs.empty()) {
+            complete(sum);
+            return;
+        }
+        future<int> f = std::move(inputs.back());
+        inputs.pop_back();
+        await(std::move(f), &summer::add);
+    }
+
+    void add(trial<int> &&t) {
+        sum += t.get();
+        proceed();
+    }
+
+}; // class summer
+
+/** Completes with the argument future. */
+class forwarder : public task<int, forwarder> {
+
+public:
+
+    future<int> input;
+
+    explicit forwarder(future<int> &&f) : input(std::move(f)) { }
+
+    void start() { complete_with(std::move(input)); }
+
+}; // class forwarder
+
+/** Throws in the start function. */
+class thrower : public task<int, thrower> {
+
+public:
+
+    void start() { throw 1.0; }
+
+}; // class thrower
+
+/** Throws after completing in the start function or a resuming function. */
+class late_thrower : public task<int, late_thrower> {
+
+public:
+
+    future<int> input;
+
+    explicit late_thrower(future<int> &&f) : input(std::move(f)) { }
+
+    void start() {
+        if (!input.is_valid()) {
+            complete(1);
+            throw 2.0;
+        }
+        await(std::move(input), &late_thrower::resume);
+    }
+
+private:
+
+    void resume(trial<int> &&t) {
+        complete(t.get());
+        throw 3.0;
+    }
+
+}; // class late_thrower
+
+double exception_of(trial<int> &&t) {
+    try {
+        t.get();
+    } catch (double d) {
+        return d;
+    }
+    return 0.0;
+}
+
+TEST_CASE("Task: completes synchronously with ready futures") {
+    std::vector<future<int>> fs;
+    fs.push_back(make_future_of(1));
+    fs.push_back(make_future_of(2));
+    fs.push_back(make_future_of(3));
+    int destroyed = 0;
+    int result = 0;
+    start_task<summer>(std::move(fs), destroyed).then(
+            [&result](trial<int> &&t) { result = t.get(); });
+    CHECK(result == 6);
+    CHECK(destroyed == 1);
+}
+
+TEST_CASE("Task: resumes when awaited future receives result") {
+    auto pf1 = make_promise_future_pair<int>();
+    auto pf2 = make_promise_future_pair<int>();
+    std::vector<future<int>> fs;
+    fs.push_back(std::move(pf2.second));
+    fs.push_back(std::move(pf1.second));
+    int destroyed = 0;
+    int result = 0;
+    start_task<summer>(std::move(fs), destroyed).then(
+            [&result](trial<int> &&t) { result = t.get(); });
+
+    std::move(pf1.first).set_result(10);
+    CHECK(result == 0);
+    CHECK(destroyed == 0);
+    std::move(pf2.first).set_result(20);
+    CHECK(result == 30);
+    CHECK(destroyed == 1);
+}
+
+TEST_CASE("Task: exception from awaited future completes task") {
+    auto pf = make_promise_future_pair<int>();
+    std::vector<future<int>> fs;
+    fs.push_back(make_future_of(1));
+    fs.push_back(std::move(pf.second));
+    int destroyed = 0;
+    double result = 0.0;
+    start_task<summer>(std::move(fs), destroyed).then(
+            [&result](trial<int> &&t) {
+        result = exception_of(std::move(t));
+    });
+
+    std::move(pf.first).fail(std::make_exception_ptr(2.0));
+    CHECK(result == 2.0);
+    CHECK(destroyed == 1);
+}
+
+TEST_CASE("Task: task is destroyed if awaited future is abandoned") {
+    auto pf = make_promise_future_pair<int>();
+    std::vector<future<int>> fs;
+    fs.push_back(std::move(pf.second));
+    int destroyed = 0;
+    bool called = false;
+    start_task<summer>(std::move(fs), destroyed).then(
+            [&called](trial<int> &&) { called = true; });
+
+    CHECK(destroyed == 0);
+    pf.first.invalidate();
+    CHECK(destroyed == 1);
+    CHECK_FALSE(called);
+}
+
+TEST_CASE("Task: completing with future") {
+    auto pf = make_promise_future_pair<int>();
+    int result = 0;
+    start_task<forwarder>(std::move(pf.second)).then(
+            [&result](trial<int> &&t) { result = t.get(); });
+    CHECK(result == 0);
+    std::move(pf.first).set_result(5);
+    CHECK(result == 5);
+}
+
+TEST_CASE("Task: completing with failed future") {
+    double result = 0.0;
+    start_task<forwarder>(make_failed_future_of<int>(3.0)).then(
+            [&result](trial<int> &&t) {
+        result = exception_of(std::move(t));
+    });
+    CHECK(result == 3.0);
+}
+
+TEST_CASE("Task: exception from start function completes task") {
+    double result = 0.0;
+    start_task<thrower>().then([&result](trial<int> &&t) {
+        result = exception_of(std::move(t));
+    });
+    CHECK(result == 1.0);
+}
+
+TEST_CASE("Task: exception from start function after completion") {
+    int result = 0;
+    start_task<late_thrower>(future<int>()).then(
+            [&result](trial<int> &&t) { result = t.get(); });
+    CHECK(result == 1);
+}
+
+TEST_CASE("Task: exception from resuming function after completion") {
+    auto pf = make_promise_future_pair<int>();
+    int result = 0;
+    start_task<late_thrower>(std::move(pf.second)).then(
+            [&result](trial<int> &&t) { result = t.get(); });
+    CHECK(result == 0);
+    std::move(pf.first).set_result(4);
+    CHECK(result == 4);
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -25,6 +25,11 @@
 
 #define CATCH_CONFIG_SFINAE
 
+/* We need ppoll, which is a GNU extension in glibc. */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+
 #ifdef __CYGWIN__
 /* We need POSIX API functions that are not covered by ANSI. */
 #undef __STRICT_ANSI__
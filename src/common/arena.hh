@@ -0,0 +1,273 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_common_arena_hh
+#define INCLUDED_common_arena_hh
+
+#include "buildconfig.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sesh {
+namespace common {
+
+/**
+ * An arena is a region of memory from which objects are allocated by bumping
+ * a pointer. Objects allocated in an arena are never freed individually. They
+ * are all destroyed when the arena is destroyed, in the reverse order of
+ * creation.
+ *
+ * Allocating from an arena is much cheaper than from the free store, so the
+ * arena is suitable for many small objects that share the same lifetime, such
+ * as the nodes of a syntax tree. Use {@link make_shared_in} to create objects
+ * that are accessed through shared pointers.
+ *
+ * An arena is not thread-safe.
+ */
+class arena {
+
+public:
+
+    /** Size of memory blocks the arena allocates from the free store. */
+    constexpr static std::size_t block_size = 4096;
+
+private:
+
+    class destructor_entry {
+
+    public:
+
+        void (*destroy)(void *);
+        void *object;
+        destructor_entry *next;
+
+    }; // class destructor_entry
+
+    template<typename T>
+    static void destroy(void *object) {
+        static_cast<T *>(object)->~T();
+    }
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    void *m_current = nullptr;
+    std::size_t m_remaining = 0;
+
+    /** Most recently registered entry. */
+    destructor_entry *m_destructors = nullptr;
+
+    void *allocate_block(std::size_t size) {
+        m_blocks.emplace_back(new char[size]);
+        return m_blocks.back().get();
+    }
+
+public:
+
+    arena() = default;
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    ~arena() {
+        for (destructor_entry *e = m_destructors; e != nullptr; e = e->next)
+            e->destroy(e->object);
+    }
+
+    /** Number of memory blocks allocated so far. */
+    std::size_t block_count() const noexcept { return m_blocks.size(); }
+
+    /**
+     * Allocates memory. The memory is valid until the arena is destroyed.
+     *
+     * @param alignment must not be larger than the alignment of
+     * std::max_align_t.
+     */
+    void *allocate(std::size_t size, std::size_t alignment) {
+        assert(alignment <= alignof(std::max_align_t));
+
+        if (void *p = std::align(alignment, size, m_current, m_remaining)) {
+            m_current = static_cast<char *>(p) + size;
+            m_remaining -= size;
+            return p;
+        }
+
+        // Large objects get a block of their own so that the rest of the
+        // current block is not wasted.
+        if (size > block_size / 4)
+            return allocate_block(size);
+
+        m_current = allocate_block(block_size);
+        m_remaining = block_size;
+        return allocate(size, alignment);
+    }
+
+    /**
+     * Constructs an object in this arena. If the object is not trivially
+     * destructible, it is destroyed when the arena is destroyed.
+     */
+    template<typename T, typename... A>
+    T *create(A &&... a) {
+        destructor_entry *e = nullptr;
+        if (!std::is_trivially_destructible<T>::value)
+            e = new (allocate(sizeof *e, alignof(destructor_entry)))
+                    destructor_entry{&destroy<T>, nullptr, m_destructors};
+
+        T *object = new (allocate(sizeof(T), alignof(T)))
+                T(std::forward<A>(a)...);
+
+        if (e != nullptr) {
+            e->object = object;
+            m_destructors = e;
+        }
+        return object;
+    }
+
+}; // class arena
+
+/**
+ * Constructs an object in the argument arena and returns a shared pointer to
+ * it. The returned pointer shares ownership of the arena rather than the
+ * object, so creating the pointer does not allocate a control block. The
+ * arena is kept alive as long as any of such pointers exist.
+ *
+ * The object must not contain pointers that own the arena, or the arena would
+ * keep itself alive forever. Use {@link make_shared_with} for such objects.
+ */
+template<typename T, typename... A>
+std::shared_ptr<T> make_shared_in(const std::shared_ptr<arena> &a, A &&... v) {
+    return std::shared_ptr<T>(a, a->create<T>(std::forward<A>(v)...));
+}
+
+namespace arena_impl {
+
+template<typename T>
+class arena_holder {
+
+public:
+
+    /** Declared before the value so that the arena outlives the value. */
+    std::shared_ptr<arena> owner;
+
+    T value;
+
+    template<typename... A>
+    arena_holder(const std::shared_ptr<arena> &a, A &&... v) :
+            owner(a), value(std::forward<A>(v)...) { }
+
+}; // template<typename T> class arena_holder
+
+} // namespace arena_impl
+
+/**
+ * Constructs an object in the free store together with a pointer that owns
+ * the argument arena, and returns a shared pointer to the object. The arena
+ * is kept alive until the object is destroyed.
+ *
+ * This is for objects that contain pointers created by {@link make_shared_in},
+ * such as the root of a tree whose descendants are allocated in the arena.
+ * The object itself is not in the arena, so the pointers it contains do not
+ * form an ownership cycle.
+ */
+template<typename T, typename... A>
+std::shared_ptr<T> make_shared_with(
+        const std::shared_ptr<arena> &a, A &&... v) {
+    auto holder = std::make_shared<arena_impl::arena_holder<T>>(
+            a, std::forward<A>(v)...);
+    return std::shared_ptr<T>(holder, &holder->value);
+}
+
+/**
+ * An allocator that allocates from an arena. A default-constructed allocator
+ * has no arena and allocates from the free store.
+ *
+ * A container that is copy-constructed from a container using an arena gets
+ * a default-constructed allocator, so the copy never refers to the arena.
+ *
+ * @tparam T Value type.
+ */
+template<typename T>
+class arena_allocator {
+
+public:
+
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::true_type;
+
+private:
+
+    class arena *m_arena = nullptr;
+
+public:
+
+    arena_allocator() = default;
+
+    explicit arena_allocator(class arena *a) noexcept : m_arena(a) { }
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U> &other) noexcept :
+            m_arena(other.arena()) { }
+
+    /** Nullable pointer to the arena. */
+    class arena *arena() const noexcept { return m_arena; }
+
+    T *allocate(std::size_t n) {
+        if (m_arena != nullptr)
+            return static_cast<T *>(
+                    m_arena->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t) noexcept {
+        if (m_arena == nullptr)
+            ::operator delete(p);
+    }
+
+    arena_allocator select_on_container_copy_construction() const noexcept {
+        return arena_allocator();
+    }
+
+}; // template<typename T> class arena_allocator
+
+template<typename T, typename U>
+bool operator==(const arena_allocator<T> &a, const arena_allocator<U> &b)
+        noexcept {
+    return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const arena_allocator<T> &a, const arena_allocator<U> &b)
+        noexcept {
+    return !(a == b);
+}
+
+/** Vector whose elements may be allocated in an arena. */
+template<typename T>
+using arena_vector = std::vector<T, arena_allocator<T>>;
+
+} // namespace common
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_common_arena_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,146 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "catch.hpp"
+#include "common/arena.hh"
+
+namespace {
+
+using sesh::common::arena;
+using sesh::common::arena_allocator;
+using sesh::common::arena_vector;
+using sesh::common::make_shared_in;
+using sesh::common::make_shared_with;
+
+class recorder {
+
+public:
+
+    std::vector<int> &destroyed;
+    int id;
+
+    recorder(std::vector<int> &d, int i) : destroyed(d), id(i) { }
+    ~recorder() { destroyed.push_back(id); }
+
+}; // class recorder
+
+class node {
+
+public:
+
+    std::vector<std::shared_ptr<recorder>> children;
+
+}; // class node
+
+TEST_CASE("Arena: allocation is aligned") {
+    arena a;
+    a.allocate(1, 1);
+    void *p = a.allocate(sizeof(double), alignof(double));
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    CHECK((address % alignof(double)) == 0);
+    CHECK(a.block_count() == 1);
+}
+
+TEST_CASE("Arena: large allocation gets own block") {
+    arena a;
+    void *p1 = a.allocate(8, 1);
+    a.allocate(arena::block_size, 1);
+    void *p2 = a.allocate(8, 1);
+    CHECK(a.block_count() == 2);
+    auto distance = static_cast<char *>(p2) - static_cast<char *>(p1);
+    CHECK(distance == 8);
+}
+
+TEST_CASE("Arena: objects are destroyed in reverse order") {
+    std::vector<int> destroyed;
+    {
+        arena a;
+        a.create<recorder>(destroyed, 1);
+        a.create<int>(0);
+        a.create<recorder>(destroyed, 2);
+        CHECK(destroyed.empty());
+    }
+    CHECK(destroyed == (std::vector<int>{2, 1}));
+}
+
+TEST_CASE("Arena: shared pointers keep arena alive") {
+    std::vector<int> destroyed;
+    auto a = std::make_shared<arena>();
+    std::weak_ptr<arena> w = a;
+    auto p = make_shared_in<recorder>(a, destroyed, 1);
+    auto q = make_shared_in<recorder>(a, destroyed, 2);
+    CHECK(p->id == 1);
+    CHECK(q->id == 2);
+
+    a.reset();
+    q.reset();
+    CHECK_FALSE(w.expired());
+    CHECK(destroyed.empty());
+
+    p.reset();
+    CHECK(w.expired());
+    CHECK(destroyed == (std::vector<int>{2, 1}));
+}
+
+TEST_CASE("Arena: object beside arena may own pointers into it") {
+    std::vector<int> destroyed;
+    auto a = std::make_shared<arena>();
+    std::weak_ptr<arena> w = a;
+    auto n = make_shared_with<node>(a);
+    n->children.push_back(make_shared_in<recorder>(a, destroyed, 1));
+    n->children.push_back(make_shared_in<recorder>(a, destroyed, 2));
+    a.reset();
+
+    std::shared_ptr<recorder> child = n->children[0];
+    n.reset();
+    CHECK_FALSE(w.expired());
+    CHECK(child->id == 1);
+    CHECK(destroyed.empty());
+
+    child.reset();
+    CHECK(w.expired());
+    CHECK(destroyed == (std::vector<int>{2, 1}));
+}
+
+TEST_CASE("Arena allocator: vector in arena and its copy") {
+    arena a;
+    arena_vector<int> v((arena_allocator<int>(&a)));
+    v.push_back(1);
+    v.push_back(2);
+    CHECK(a.block_count() == 1);
+
+    arena_vector<int> copy(v);
+    CHECK(copy == v);
+    CHECK(copy.get_allocator().arena() == nullptr);
+
+    arena_vector<int> moved(std::move(v));
+    CHECK(moved.get_allocator().arena() == &a);
+
+    copy = std::move(moved);
+    CHECK(copy.get_allocator().arena() == nullptr);
+    CHECK(copy == (arena_vector<int>{1, 2}));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,215 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_common_pool_allocator_hh
+#define INCLUDED_common_pool_allocator_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <new>
+
+namespace sesh {
+namespace common {
+
+/** Counters that tell how well the memory pool of a thread works. */
+class pool_statistics {
+
+public:
+
+    /** Number of allocations served from the pool. */
+    std::size_t hits = 0;
+
+    /** Number of allocations that went to the free store. */
+    std::size_t misses = 0;
+
+}; // class pool_statistics
+
+/**
+ * A memory pool keeps freed blocks of small sizes in per-size-class free
+ * lists so that they can be reused without calling the free store. Each block
+ * is allocated separately from the free store, so a block allocated by one
+ * thread can be freed to the pool of another thread.
+ *
+ * There is one pool per thread (see {@link memory_pool::instance}), so the
+ * pool need not be synchronized.
+ */
+class memory_pool {
+
+public:
+
+    /** Granularity of block sizes. */
+    constexpr static std::size_t size_unit = alignof(std::max_align_t);
+
+    /** Number of size classes. Larger blocks are not pooled. */
+    constexpr static std::size_t class_count = 16;
+
+    /** Maximum number of free blocks kept in each size class. */
+    constexpr static std::size_t max_free_count = 256;
+
+private:
+
+    class free_block {
+
+    public:
+
+        free_block *next;
+
+    }; // class free_block
+
+    class free_list {
+
+    public:
+
+        free_block *head = nullptr;
+        std::size_t count = 0;
+
+    }; // class free_list
+
+    free_list m_lists[class_count];
+    pool_statistics m_statistics;
+
+    static std::size_t class_index(std::size_t size) noexcept {
+        return (size + size_unit - 1) / size_unit - 1;
+    }
+
+public:
+
+    memory_pool() = default;
+    memory_pool(const memory_pool &) = delete;
+    memory_pool &operator=(const memory_pool &) = delete;
+
+    ~memory_pool() {
+        for (free_list &l : m_lists) {
+            while (free_block *b = l.head) {
+                l.head = b->next;
+                ::operator delete(b);
+            }
+        }
+    }
+
+    /** Returns the pool of the current thread. */
+    static memory_pool &instance() {
+        static thread_local memory_pool pool;
+        return pool;
+    }
+
+    const pool_statistics &statistics() const noexcept {
+        return m_statistics;
+    }
+
+    /** Allocates a block of the argument size. */
+    void *allocate(std::size_t size) {
+        if (size == 0 || size > size_unit * class_count) {
+            ++m_statistics.misses;
+            return ::operator new(size);
+        }
+
+        std::size_t i = class_index(size);
+        free_list &l = m_lists[i];
+        if (free_block *b = l.head) {
+            l.head = b->next;
+            --l.count;
+            ++m_statistics.hits;
+            return b;
+        }
+
+        ++m_statistics.misses;
+        return ::operator new((i + 1) * size_unit);
+    }
+
+    /**
+     * Frees a block. The size must be the same as that passed to {@link
+     * #allocate}.
+     */
+    void deallocate(void *p, std::size_t size) noexcept {
+        if (size == 0 || size > size_unit * class_count) {
+            ::operator delete(p);
+            return;
+        }
+
+        free_list &l = m_lists[class_index(size)];
+        if (l.count >= max_free_count) {
+            ::operator delete(p);
+            return;
+        }
+
+        l.head = new (p) free_block{l.head};
+        ++l.count;
+    }
+
+}; // class memory_pool
+
+/** Returns the pool statistics of the current thread. */
+inline const pool_statistics &thread_pool_statistics() {
+    return memory_pool::instance().statistics();
+}
+
+/**
+ * An allocator that allocates from the memory pool of the current thread. All
+ * instances are interchangeable.
+ *
+ * This allocator is intended for small objects that are frequently created
+ * and destroyed with std::allocate_shared.
+ *
+ * @tparam T Value type. Its alignment must not be larger than that of
+ * std::max_align_t.
+ */
+template<typename T>
+class pool_allocator {
+
+public:
+
+    using value_type = T;
+
+    pool_allocator() = default;
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U> &) noexcept { }
+
+    T *allocate(std::size_t n) {
+        static_assert(
+                alignof(T) <= memory_pool::size_unit,
+                "over-aligned types cannot be pooled");
+        return static_cast<T *>(
+                memory_pool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        memory_pool::instance().deallocate(p, n * sizeof(T));
+    }
+
+}; // template<typename T> class pool_allocator
+
+template<typename T, typename U>
+constexpr bool operator==(const pool_allocator<T> &, const pool_allocator<U> &)
+        noexcept {
+    return true;
+}
+
+template<typename T, typename U>
+constexpr bool operator!=(const pool_allocator<T> &, const pool_allocator<U> &)
+        noexcept {
+    return false;
+}
+
+} // namespace common
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_common_pool_allocator_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,103 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstdint>
+#include <memory>
+#include "async/future.hh"
+#include "catch.hpp"
+#include "common/pool_allocator.hh"
+
+namespace {
+
+using sesh::async::make_promise_future_pair;
+using sesh::common::memory_pool;
+using sesh::common::pool_allocator;
+using sesh::common::pool_statistics;
+using sesh::common::thread_pool_statistics;
+
+TEST_CASE("Memory pool: freed block is reused") {
+    memory_pool pool;
+    void *p1 = pool.allocate(24);
+    CHECK(pool.statistics().misses == 1);
+    CHECK(pool.statistics().hits == 0);
+    pool.deallocate(p1, 24);
+
+    void *p2 = pool.allocate(20);
+    CHECK(p2 == p1);
+    CHECK(pool.statistics().misses == 1);
+    CHECK(pool.statistics().hits == 1);
+    pool.deallocate(p2, 20);
+}
+
+TEST_CASE("Memory pool: blocks of different size classes are not mixed") {
+    memory_pool pool;
+    void *p1 = pool.allocate(memory_pool::size_unit);
+    pool.deallocate(p1, memory_pool::size_unit);
+
+    void *p2 = pool.allocate(memory_pool::size_unit + 1);
+    CHECK(pool.statistics().misses == 2);
+    CHECK(pool.statistics().hits == 0);
+    pool.deallocate(p2, memory_pool::size_unit + 1);
+}
+
+TEST_CASE("Memory pool: large blocks are not pooled") {
+    constexpr auto size = memory_pool::size_unit * memory_pool::class_count;
+    memory_pool pool;
+    void *p1 = pool.allocate(size + 1);
+    pool.deallocate(p1, size + 1);
+    void *p2 = pool.allocate(size + 1);
+    CHECK(pool.statistics().misses == 2);
+    CHECK(pool.statistics().hits == 0);
+    pool.deallocate(p2, size + 1);
+}
+
+TEST_CASE("Pool allocator: allocation is aligned") {
+    pool_allocator<long double> a;
+    long double *p = a.allocate(1);
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    CHECK((address % alignof(long double)) == 0);
+    a.deallocate(p, 1);
+}
+
+TEST_CASE("Pool allocator: shared objects reuse blocks") {
+    pool_allocator<int> a;
+    std::allocate_shared<int>(a, 1);
+    pool_statistics s1 = thread_pool_statistics();
+    std::allocate_shared<int>(a, 2);
+    pool_statistics s2 = thread_pool_statistics();
+    CHECK(s2.hits == s1.hits + 1);
+    CHECK(s2.misses == s1.misses);
+}
+
+#ifndef SESH_NO_DELAY_POOL
+
+TEST_CASE("Pool allocator: promise-future pairs are pooled") {
+    make_promise_future_pair<int>();
+    pool_statistics s1 = thread_pool_statistics();
+    make_promise_future_pair<int>();
+    pool_statistics s2 = thread_pool_statistics();
+    CHECK(s2.hits == s1.hits + 1);
+    CHECK(s2.misses == s1.misses);
+}
+
+#endif // #ifndef SESH_NO_DELAY_POOL
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
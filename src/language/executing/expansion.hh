@@ -20,8 +20,7 @@
 
 #include "buildconfig.h"
 
-#include <vector>
-#include "language/executing/word_char.hh"
+#include "language/executing/word_char_buffer.hh"
 
 namespace sesh {
 namespace language {
@@ -35,7 +34,7 @@ class expansion {
 
 public:
 
-    std::vector<word_char> characters;
+    word_char_buffer characters;
 
 }; // class expansion
 
@@ -31,13 +31,11 @@ using sesh::common::xstring;
 } // namespace
 
 void append(
-        std::vector<word_char> &wcs,
+        word_char_buffer &wcs,
         const xstring &s,
         bool is_literal,
         bool is_quoted) {
-    wcs.reserve(wcs.size() + s.size());
-    for (xstring::value_type c : s)
-        wcs.push_back({c, is_literal, is_quoted});
+    wcs.append(s, is_literal, is_quoted);
 }
 
 } // namespace executing
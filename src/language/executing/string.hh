@@ -20,25 +20,24 @@
 
 #include "buildconfig.h"
 
-#include <vector>
 #include "common/xstring.hh"
-#include "language/executing/word_char.hh"
+#include "language/executing/word_char_buffer.hh"
 
 namespace sesh {
 namespace language {
 namespace executing {
 
-/** Appends characters from a string to word char vector. */
+/** Appends characters from a string to word char buffer. */
 void append(
-        std::vector<word_char> &,
+        word_char_buffer &,
         const common::xstring &,
         bool is_literal,
         bool is_quoted);
 
-/** Converts a string into a word char vector with the specified flags. */
-inline std::vector<word_char> expand(
+/** Converts a string into a word char buffer with the specified flags. */
+inline word_char_buffer expand(
         const common::xstring &s, bool is_literal, bool is_quoted) {
-    std::vector<word_char> wcs;
+    word_char_buffer wcs;
     append(wcs, s, is_literal, is_quoted);
     return wcs;
 }
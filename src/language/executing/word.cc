@@ -22,13 +22,12 @@
 #include <memory>
 #include "async/continuation.hh"
 #include "async/future.hh"
+#include "async/task.hh"
 #include "common/container_helper.hh"
 #include "common/either.hh"
-#include "common/shared_function.hh"
 #include "environment/world.hh"
 #include "language/executing/expansion.hh"
 #include "language/executing/field.hh"
-#include "language/executing/word_char.hh"
 #include "language/executing/word_component.hh"
 #include "language/syntax/word.hh"
 
@@ -40,18 +39,16 @@ namespace {
 
 using sesh::async::continuation;
 using sesh::async::future;
-using sesh::async::make_future_of;
 using sesh::async::make_promise_future_pair;
 using sesh::async::promise;
-using sesh::common::move;
+using sesh::async::start_task;
+using sesh::async::task;
 using sesh::common::move_transform;
-using sesh::common::shared_function;
-using sesh::common::transform;
 using sesh::common::trial;
 using sesh::environment::world;
 using sesh::language::syntax::word;
 
-using components = std::vector<word::component_pointer>;
+using components = word::component_list;
 
 void join(std::vector<expansion> &to, std::vector<expansion> &&from) {
     if (from.empty())
@@ -61,21 +58,22 @@ void join(std::vector<expansion> &to, std::vector<expansion> &&from) {
         return;
     }
 
-    move(from.back().characters, to.front().characters);
+    to.front().characters.append(std::move(from.back().characters));
     // TODO: std::move(++from.begin(), from.end(), std::back_inserter(to));
 }
 
 field to_field(expansion &&e) {
     field f;
-    transform(
-            e.characters,
-            f.characters,
-            [](word_char wc) { return wc.character; });
+    f.characters = e.characters.release_characters();
     return f;
 }
 
-class four_expansion_state :
-        public std::enable_shared_from_this<four_expansion_state> {
+/**
+ * Expands the word components one by one, joining the results. The task is
+ * the only object allocated for the whole expansion.
+ */
+class four_expansion_task :
+        public task<expansion_result, four_expansion_task> {
 
 private:
 
@@ -87,7 +85,7 @@ private:
 
 public:
 
-    four_expansion_state(
+    four_expansion_task(
             const std::shared_ptr<world> &w,
             bool is_quoted,
             std::shared_ptr<const components> &&cs) :
@@ -99,29 +97,33 @@ public:
         m_result.words.try_emplace();
     }
 
-    future<expansion_result> proceed() {
-        if (m_next_component == m_components->end())
-            return make_future_of(std::move(m_result));
+    void start() {
+        if (m_next_component == m_components->end()) {
+            complete(std::move(m_result));
+            return;
+        }
 
         auto f = expand(m_world, m_is_quoted, *m_next_component);
         ++m_next_component;
-        return std::move(f)
-                .map(shared_function<four_expansion_state>(shared_from_this()))
-                .unwrap();
+        await(std::move(f), &four_expansion_task::accept);
     }
 
+private:
+
     /** Accepts result of word component expansion. */
-    future<expansion_result> operator()(expansion_result &&er) {
+    void accept(trial<expansion_result> &&t) {
+        expansion_result &er = t.get();
         // TODO merge er into m_result
         if (!er.words) {
             m_result.words.clear();
-            return make_future_of(std::move(m_result));
+            complete(std::move(m_result));
+            return;
         }
         join(*m_result.words, std::move(*er.words));
-        return proceed();
+        start();
     }
 
-}; // class four_expansion_state
+}; // class four_expansion_task
 
 } // namespace
 
@@ -129,11 +131,10 @@ future<expansion_result> expand_four(
         const std::shared_ptr<world> &world,
         bool is_quoted,
         const std::shared_ptr<const word> &w) {
-    auto es = std::make_shared<four_expansion_state>(
+    return start_task<four_expansion_task>(
             world,
             is_quoted,
             std::shared_ptr<const components>(w, &w->components));
-    return es->proceed();
 }
 
 future<multiple_field_result> expand_to_multiple_fields(
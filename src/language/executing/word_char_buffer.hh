@@ -0,0 +1,133 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_executing_word_char_buffer_hh
+#define INCLUDED_language_executing_word_char_buffer_hh
+
+#include "buildconfig.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "common/xstring.hh"
+#include "language/executing/word_char.hh"
+
+namespace sesh {
+namespace language {
+namespace executing {
+
+/**
+ * A word char buffer is a sequence of {@link word_char}s stored as a
+ * structure of arrays: the characters are in a contiguous string and the
+ * literal and quoted flags are in packed bit vectors. A character takes the
+ * size of an xchar plus two bits, about half the size of a word_char.
+ *
+ * Characters are appended in bulk with the same flags. The characters can be
+ * moved out as a string without converting each character.
+ */
+class word_char_buffer {
+
+public:
+
+    using size_type = common::xstring::size_type;
+
+private:
+
+    common::xstring m_characters;
+    std::vector<bool> m_is_literal;
+    std::vector<bool> m_is_quoted;
+
+public:
+
+    size_type size() const noexcept { return m_characters.size(); }
+    bool empty() const noexcept { return m_characters.empty(); }
+
+    /** Returns the characters without the flags. */
+    const common::xstring &characters() const noexcept {
+        return m_characters;
+    }
+
+    bool is_literal(size_type i) const { return m_is_literal[i]; }
+    bool is_quoted(size_type i) const { return m_is_quoted[i]; }
+
+    /** Returns the i'th character with its flags. */
+    word_char operator[](size_type i) const {
+        return {m_characters[i], is_literal(i), is_quoted(i)};
+    }
+
+    /** Like operator[], but throws std::out_of_range for a bad index. */
+    word_char at(size_type i) const {
+        if (i >= size())
+            throw std::out_of_range("word_char_buffer::at");
+        return (*this)[i];
+    }
+
+    void reserve(size_type n) {
+        m_characters.reserve(n);
+        m_is_literal.reserve(n);
+        m_is_quoted.reserve(n);
+    }
+
+    /** Appends all the characters of the string with the same flags. */
+    void append(const common::xstring &s, bool is_literal, bool is_quoted) {
+        m_characters += s;
+        m_is_literal.insert(m_is_literal.end(), s.size(), is_literal);
+        m_is_quoted.insert(m_is_quoted.end(), s.size(), is_quoted);
+    }
+
+    /** Appends all the characters of the argument buffer. */
+    void append(const word_char_buffer &b) {
+        m_characters += b.m_characters;
+        m_is_literal.insert(
+                m_is_literal.end(),
+                b.m_is_literal.begin(),
+                b.m_is_literal.end());
+        m_is_quoted.insert(
+                m_is_quoted.end(),
+                b.m_is_quoted.begin(),
+                b.m_is_quoted.end());
+    }
+
+    /** Appends all the characters of the argument buffer. */
+    void append(word_char_buffer &&b) {
+        if (empty())
+            *this = std::move(b);
+        else
+            append(b);
+    }
+
+    /**
+     * Moves the characters out of this buffer, discarding the flags. The
+     * buffer is left empty.
+     */
+    common::xstring release_characters() noexcept {
+        common::xstring s = std::move(m_characters);
+        m_characters.clear();
+        m_is_literal.clear();
+        m_is_quoted.clear();
+        return s;
+    }
+
+}; // class word_char_buffer
+
+} // namespace executing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_executing_word_char_buffer_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
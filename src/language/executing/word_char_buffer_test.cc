@@ -0,0 +1,76 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <stdexcept>
+#include <utility>
+#include "catch.hpp"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/executing/word_char_buffer.hh"
+
+namespace {
+
+using sesh::common::xstring;
+using sesh::language::executing::word_char_buffer;
+
+TEST_CASE("Word char buffer: append keeps flags per character") {
+    word_char_buffer b;
+    CHECK(b.empty());
+    b.append(L("ab"), true, false);
+    b.append(L("c"), false, true);
+    REQUIRE(b.size() == 3);
+    CHECK(b.characters() == L("abc"));
+
+    CHECK(b[0].character == L('a'));
+    CHECK(b[0].is_literal);
+    CHECK_FALSE(b[0].is_quoted);
+    CHECK(b[1].is_literal);
+    CHECK(b.at(2).character == L('c'));
+    CHECK_FALSE(b.at(2).is_literal);
+    CHECK(b.at(2).is_quoted);
+    CHECK_THROWS_AS(b.at(3), std::out_of_range);
+}
+
+TEST_CASE("Word char buffer: append buffer") {
+    word_char_buffer b1, b2;
+    b1.append(L("a"), true, true);
+    b2.append(L("b"), false, false);
+    b1.append(b2);
+    REQUIRE(b1.size() == 2);
+    CHECK(b1[1].character == L('b'));
+    CHECK_FALSE(b1[1].is_literal);
+    CHECK_FALSE(b1[1].is_quoted);
+
+    word_char_buffer b3;
+    b3.append(std::move(b1));
+    CHECK(b3.characters() == L("ab"));
+    CHECK(b3[0].is_quoted);
+}
+
+TEST_CASE("Word char buffer: release characters") {
+    word_char_buffer b;
+    b.append(L("foo"), true, false);
+    xstring s = b.release_characters();
+    CHECK(s == L("foo"));
+    CHECK(b.empty());
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
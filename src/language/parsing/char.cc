@@ -21,7 +21,6 @@
 #include <functional>
 #include <utility>
 #include "async/future.hh"
-#include "common/constant_function.hh"
 #include "common/copy.hh"
 #include "common/xchar.hh"
 #include "common/xstring.hh"
@@ -31,7 +30,6 @@
 namespace {
 
 using sesh::async::future;
-using sesh::common::constant;
 using sesh::common::copy;
 using sesh::common::xchar;
 using sesh::common::xchar_traits;
@@ -49,7 +47,7 @@ class char_tester {
 
 public:
 
-    std::function<char_predicate> predicate;
+    char_test predicate;
     class context context;
 
     result<xchar> operator()(const stream_value &sv) {
@@ -62,9 +60,9 @@ public:
 
 } // namespace
 
-auto test_char(const std::function<char_predicate> &p, const state &s)
+auto test_char(const char_test &p, const state &s)
         -> future<result<xchar>> {
-    return s.rest->get().map(char_tester{p, s.context});
+    return s.rest.map(char_tester{p, s.context});
 }
 
 future<result<xchar>> parse_char(xchar c, const state &s) {
@@ -73,7 +71,7 @@ future<result<xchar>> parse_char(xchar c, const state &s) {
 }
 
 future<result<xchar>> accept_char(const state &s) {
-    return test_char(constant(true), s);
+    return test_char(char_test(), s);
 }
 
 } // namespace parsing
@@ -20,7 +20,6 @@
 
 #include "buildconfig.h"
 
-#include <functional>
 #include "async/future.hh"
 #include "common/xchar.hh"
 #include "language/parsing/char_predicate.hh"
@@ -38,7 +37,7 @@ namespace parsing {
  *
  * This parser never returns any report even on failure.
  */
-auto test_char(const std::function<char_predicate> &, const state &)
+auto test_char(const char_test &, const state &)
         -> async::future<result<common::xchar>>;
 
 /**
@@ -0,0 +1,86 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "char_class.hh"
+
+#include <cstddef>
+#include <locale>
+#include "common/integer_sequence.hh"
+#include "common/xchar.hh"
+
+namespace {
+
+using sesh::common::index_sequence;
+using sesh::common::make_index_sequence;
+using sesh::common::xchar;
+using sesh::language::parsing::ascii_char_class_table;
+using sesh::language::parsing::char_class;
+using sesh::language::parsing::char_class_set;
+
+constexpr bool is_any_of(std::size_t c, const char *chars) noexcept {
+    return *chars != '\0' &&
+            (static_cast<std::size_t>(*chars) == c || is_any_of(c, chars + 1));
+}
+
+constexpr char_class_set classify_ascii(std::size_t c) noexcept {
+    return
+            c == ' ' || c == '\t' ?
+                    char_class::blank | char_class::delimiter :
+            c == '\n' ?
+                    char_class::newline | char_class::delimiter :
+            is_any_of(c, ";&|<>()") ?
+                    char_class_set(char_class::delimiter) :
+            is_any_of(c, "\"$'\\`") ?
+                    char_class_set(char_class::special) :
+            '0' <= c && c <= '9' ?
+                    char_class_set(char_class::digit) :
+            char_class_set();
+}
+
+template<std::size_t... c>
+constexpr ascii_char_class_table make_table(index_sequence<c...>) noexcept {
+    return {{classify_ascii(c)...}};
+}
+
+} // namespace
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+constexpr ascii_char_class_table ascii_char_classes =
+        make_table(make_index_sequence<ascii_char_class_table::size>());
+
+static_assert(
+        ascii_char_classes.classes['a'].empty(),
+        "Letters have no classes");
+static_assert(
+        ascii_char_classes.classes['7'] == char_class::digit,
+        "Digits are digits");
+
+char_class_set classify_non_ascii(xchar x, const context &c) {
+    if (c.ctype_facet().is(std::ctype_base::blank, x))
+        return char_class::blank;
+    return char_class_set();
+}
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
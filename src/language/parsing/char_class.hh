@@ -0,0 +1,138 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_char_class_hh
+#define INCLUDED_language_parsing_char_class_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <type_traits>
+#include "common/xchar.hh"
+#include "language/parsing/parser.hh"
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+/** Classes of characters that are significant to the parsers. */
+enum class char_class : unsigned char {
+    /** Space, tab and other locale-dependent blank characters. */
+    blank,
+    /** Characters that end a token: space, tab, newline and ;&|<>(). */
+    delimiter,
+    /** Characters that start word components other than raw strings. */
+    special,
+    newline,
+    /** ASCII decimal digits. */
+    digit,
+};
+
+/** A set of character classes that can be computed at compile time. */
+class char_class_set {
+
+private:
+
+    unsigned char m_bits;
+
+    constexpr static unsigned char bit(char_class c) noexcept {
+        return static_cast<unsigned char>(1u << static_cast<unsigned>(c));
+    }
+
+    constexpr explicit char_class_set(unsigned bits) noexcept :
+            m_bits(static_cast<unsigned char>(bits)) { }
+
+public:
+
+    /** Constructs an empty set. */
+    constexpr char_class_set() noexcept : m_bits(0) { }
+
+    /** Constructs a set of the single class. */
+    constexpr char_class_set(char_class c) noexcept : m_bits(bit(c)) { }
+
+    constexpr bool empty() const noexcept { return m_bits == 0; }
+
+    constexpr bool contains(char_class c) const noexcept {
+        return (m_bits & bit(c)) != 0;
+    }
+
+    constexpr bool intersects(char_class_set s) const noexcept {
+        return (m_bits & s.m_bits) != 0;
+    }
+
+    constexpr char_class_set operator|(char_class_set s) const noexcept {
+        return char_class_set(static_cast<unsigned>(m_bits | s.m_bits));
+    }
+
+    constexpr bool operator==(char_class_set s) const noexcept {
+        return m_bits == s.m_bits;
+    }
+
+    constexpr bool operator!=(char_class_set s) const noexcept {
+        return m_bits != s.m_bits;
+    }
+
+}; // class char_class_set
+
+constexpr inline char_class_set operator|(char_class l, char_class r)
+        noexcept {
+    return char_class_set(l) | r;
+}
+
+/** Classes of the characters that end a token. */
+constexpr char_class_set token_delimiters =
+        char_class::blank | char_class::delimiter;
+
+/** The classes of the ASCII characters, indexed by the character values. */
+class ascii_char_class_table {
+
+public:
+
+    constexpr static std::size_t size = 0x80;
+
+    char_class_set classes[size];
+
+}; // class ascii_char_class_table
+
+/** The table built at compile time. */
+extern const ascii_char_class_table ascii_char_classes;
+
+/**
+ * Returns the classes of a non-ASCII character. The result depends on the
+ * locale of the context.
+ */
+char_class_set classify_non_ascii(common::xchar, const context &);
+
+/**
+ * Returns the classes of the argument character. ASCII characters are looked
+ * up in the table, which does not depend on the locale.
+ */
+inline char_class_set classify(common::xchar x, const context &c) {
+    using unsigned_xchar = std::make_unsigned<common::xchar>::type;
+    auto u = static_cast<unsigned_xchar>(x);
+    if (u < ascii_char_class_table::size)
+        return ascii_char_classes.classes[u];
+    return classify_non_ascii(x, c);
+}
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_char_class_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,154 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <locale>
+#include "catch.hpp"
+#include "common/xchar.hh"
+#include "language/parsing/char_class.hh"
+#include "language/parsing/char_predicate.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/parser_test_helper.hh"
+
+namespace {
+
+using sesh::common::xchar;
+using sesh::language::parsing::any_of;
+using sesh::language::parsing::char_class;
+using sesh::language::parsing::char_class_set;
+using sesh::language::parsing::char_test;
+using sesh::language::parsing::classify;
+using sesh::language::parsing::context;
+using sesh::language::parsing::default_context_stub;
+using sesh::language::parsing::is_blank;
+using sesh::language::parsing::is_token_char;
+using sesh::language::parsing::none_of;
+using sesh::language::parsing::token_delimiters;
+
+/** Ctype facet that regards e with acute accent as blank. */
+class blank_e_acute_ctype : public std::ctype<xchar> {
+
+protected:
+
+    bool do_is(mask m, char_type c) const override {
+        if (c == L('\u00E9'))
+            return (m & blank) != 0;
+        return std::ctype<xchar>::do_is(m, c);
+    }
+
+}; // class blank_e_acute_ctype
+
+TEST_CASE("Character class set") {
+    char_class_set s;
+    CHECK(s.empty());
+    s = char_class::blank | char_class::digit;
+    CHECK_FALSE(s.empty());
+    CHECK(s.contains(char_class::blank));
+    CHECK(s.contains(char_class::digit));
+    CHECK_FALSE(s.contains(char_class::newline));
+    CHECK(s.intersects(char_class::digit | char_class::special));
+    CHECK_FALSE(s.intersects(char_class::special));
+}
+
+TEST_CASE("Classes of ASCII characters") {
+    const context c = default_context_stub();
+    CHECK(classify(L(' '), c) == (char_class::blank | char_class::delimiter));
+    CHECK(classify(L('\t'), c) ==
+            (char_class::blank | char_class::delimiter));
+    CHECK(classify(L('\n'), c) ==
+            (char_class::newline | char_class::delimiter));
+    for (xchar x : {L(';'), L('&'), L('|'), L('<'), L('>'), L('('), L(')')})
+        CHECK(classify(x, c) == char_class::delimiter);
+    for (xchar x : {L('"'), L('$'), L('\''), L('\\'), L('`')})
+        CHECK(classify(x, c) == char_class::special);
+    for (xchar x = L('0'); x <= L('9'); ++x)
+        CHECK(classify(x, c) == char_class::digit);
+    for (xchar x : {L('\0'), L('a'), L('Z'), L('#'), L('/'), L('\x7F')})
+        CHECK(classify(x, c).empty());
+}
+
+TEST_CASE("Classes of non-ASCII characters") {
+    const context c = default_context_stub();
+    CHECK_FALSE(classify(L('\u00E9'), c).intersects(
+            char_class::delimiter | char_class::special |
+            char_class::newline | char_class::digit));
+}
+
+TEST_CASE("Classes of non-ASCII characters follow locale change") {
+    context c = default_context_stub();
+    CHECK_FALSE(classify(L('\u00E9'), c).intersects(char_class::blank));
+    CHECK(&c.ctype_facet() ==
+            &std::use_facet<std::ctype<xchar>>(c.locale()));
+
+    c.set_locale(std::locale(c.locale(), new blank_e_acute_ctype));
+    CHECK(&c.ctype_facet() ==
+            &std::use_facet<std::ctype<xchar>>(c.locale()));
+    CHECK(classify(L('\u00E9'), c) == char_class::blank);
+}
+
+TEST_CASE("Character predicates") {
+    const context c = default_context_stub();
+    CHECK(is_blank(L(' '), c));
+    CHECK_FALSE(is_blank(L('\n'), c));
+    CHECK(is_token_char(L('a'), c));
+    CHECK(is_token_char(L('$'), c));
+    CHECK_FALSE(is_token_char(L(' '), c));
+    CHECK_FALSE(is_token_char(L(';'), c));
+}
+
+TEST_CASE("Default character test accepts any character") {
+    const context c = default_context_stub();
+    char_test t;
+    CHECK(t(L('a'), c));
+    CHECK(t(L(' '), c));
+    CHECK(t(L('\0'), c));
+}
+
+TEST_CASE("Character test of classes") {
+    const context c = default_context_stub();
+    char_test blank = any_of(char_class::blank);
+    CHECK(blank(L(' '), c));
+    CHECK_FALSE(blank(L('a'), c));
+
+    char_test token = none_of(token_delimiters);
+    CHECK(token(L('a'), c));
+    CHECK(token(L('"'), c));
+    CHECK_FALSE(token(L(' '), c));
+    CHECK_FALSE(token(L('|'), c));
+
+    char_test raw = token.excluding(char_class::special);
+    CHECK(raw(L('a'), c));
+    CHECK_FALSE(raw(L('"'), c));
+    CHECK_FALSE(raw(L('|'), c));
+}
+
+TEST_CASE("Character test of predicate") {
+    const context c = default_context_stub();
+    char_test t = [](xchar x, const context &) { return x != L('a'); };
+    CHECK_FALSE(t(L('a'), c));
+    CHECK(t(L('$'), c));
+
+    char_test t2 = t.excluding(char_class::special);
+    CHECK_FALSE(t2(L('a'), c));
+    CHECK_FALSE(t2(L('$'), c));
+    CHECK(t2(L('b'), c));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
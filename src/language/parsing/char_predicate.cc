@@ -18,15 +18,12 @@
 #include "buildconfig.h"
 #include "char_predicate.hh"
 
-#include <locale>
 #include "common/xchar.hh"
-#include "common/xstring.hh"
+#include "language/parsing/char_class.hh"
 
 namespace {
 
-using sesh::common::contains;
 using sesh::common::xchar;
-using sesh::common::xstring;
 
 } // namespace
 
@@ -35,17 +32,11 @@ namespace language {
 namespace parsing {
 
 bool is_blank(xchar x, const context &c) {
-#if HAVE_STD__ISBLANK
-    return std::isblank(x, c.locale);
-#else
-    (void) c.locale;
-    return x == L(' ') || x == L('\t');
-#endif // #if HAVE_STD__ISBLANK
+    return classify(x, c).contains(char_class::blank);
 }
 
 bool is_token_char(xchar x, const context &c) {
-    static const xstring delimiters = L(" \t\n;&|<>()");
-    return !contains(delimiters, x) && !is_blank(x, c);
+    return !classify(x, c).intersects(token_delimiters);
 }
 
 } // namespace parsing
@@ -20,7 +20,11 @@
 
 #include "buildconfig.h"
 
+#include <functional>
+#include <type_traits>
+#include <utility>
 #include "common/xchar.hh"
+#include "language/parsing/char_class.hh"
 #include "language/parsing/parser.hh"
 
 namespace sesh {
@@ -32,6 +36,75 @@ using char_predicate = bool(common::xchar, const context &);
 extern char_predicate is_blank;
 extern char_predicate is_token_char;
 
+/**
+ * A character test decides whether a parser accepts a character. It
+ * consists of required and excluded character classes and an optional
+ * predicate. A character is accepted if it belongs to none of the excluded
+ * classes, belongs to any of the required classes (unless no class is
+ * required), and satisfies the predicate (if any).
+ *
+ * Tests made up of classes only are a table lookup for ASCII characters and
+ * involve no indirect call, so parsers should prefer them to predicates.
+ * Any callable that is convertible to <code>std::function&lt;{@link
+ * char_predicate}></code> is implicitly converted to a test.
+ */
+class char_test {
+
+private:
+
+    char_class_set m_required;
+    char_class_set m_excluded;
+    std::function<char_predicate> m_predicate;
+
+public:
+
+    /** Constructs a test that accepts any character. */
+    char_test() = default;
+
+    char_test(char_class_set required, char_class_set excluded) noexcept :
+            m_required(required), m_excluded(excluded), m_predicate() { }
+
+    template<
+            typename P,
+            typename = typename std::enable_if<
+                    !std::is_same<
+                            typename std::decay<P>::type, char_test>::value &&
+                    std::is_constructible<
+                            std::function<char_predicate>, P>::value
+            >::type>
+    char_test(P &&p) :
+            m_required(), m_excluded(), m_predicate(std::forward<P>(p)) { }
+
+    /** Returns a copy of this test that also rejects the classes. */
+    char_test excluding(char_class_set classes) const {
+        char_test t = *this;
+        t.m_excluded = t.m_excluded | classes;
+        return t;
+    }
+
+    bool operator()(common::xchar x, const context &c) const {
+        if (!m_required.empty() || !m_excluded.empty()) {
+            char_class_set classes = classify(x, c);
+            if (classes.intersects(m_excluded))
+                return false;
+            if (!m_required.empty() && !classes.intersects(m_required))
+                return false;
+        }
+        return !m_predicate || m_predicate(x, c);
+    }
+
+}; // class char_test
+
+/** Returns a test that accepts characters in any of the classes. */
+inline char_test any_of(char_class_set classes) noexcept {
+    return char_test(classes, char_class_set());
+}
+
+/** Returns a test that accepts characters in none of the classes. */
+inline char_test none_of(char_class_set classes) noexcept {
+    return char_test(char_class_set(), classes);
+}
+
 } // namespace parsing
 } // namespace language
 } // namespace sesh
@@ -0,0 +1,134 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_cursor_hh
+#define INCLUDED_language_parsing_cursor_hh
+
+#include "buildconfig.h"
+
+#include "common/xchar.hh"
+#include "language/source/fragment.hh"
+#include "language/source/stream.hh"
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+/** Thrown when the stream has no chunk available synchronously. */
+class stream_not_ready {
+};
+
+/**
+ * A cursor is a position in a stream. It refers to the streams and chunks by
+ * plain pointers, so copying and advancing a cursor is cheap. The stream
+ * nodes must be kept alive by the stream the parsing started with.
+ *
+ * A cursor reads chunks only if they are already available. Member functions
+ * that need a chunk that is not yet available (that is, the shared future of
+ * the chunk has no result yet) or whose computation failed throw {@link
+ * stream_not_ready}.
+ */
+class cursor {
+
+private:
+
+    /** Stream whose node contains the current chunk. */
+    const source::stream *m_base;
+
+    /** Offset of the current character in the current chunk. */
+    source::stream::size_type m_offset;
+
+    /** Current chunk. Null until resolved. */
+    const source::stream_chunk *m_chunk;
+
+    const source::stream_chunk &chunk() {
+        if (m_chunk == nullptr) {
+            const auto &future = *m_base->node();
+            if (!future)
+                throw stream_not_ready();
+            auto chunk = future->peek();
+            if (chunk == nullptr || !*chunk)
+                throw stream_not_ready();
+            m_chunk = &**chunk;
+        }
+        return *m_chunk;
+    }
+
+public:
+
+    explicit cursor(const source::stream &s) noexcept :
+            m_base(&s), m_offset(s.offset()), m_chunk(nullptr) { }
+
+    /** Returns a pointer to the current character or null at end of input. */
+    const common::xchar *peek() {
+        const source::stream_chunk &c = chunk();
+        if (c.begin == nullptr)
+            return nullptr;
+        return &c.begin.head->value[c.begin.index + m_offset];
+    }
+
+    /**
+     * Returns the number of characters that are contiguous in memory from the
+     * current character to the end of the current chunk.
+     */
+    source::stream::size_type contiguous_length() {
+        const source::stream_chunk &c = chunk();
+        if (c.begin == nullptr)
+            return 0;
+        return c.length - m_offset;
+    }
+
+    /**
+     * Moves forward by the argument number of characters, which must be
+     * positive and not exceed the contiguous length.
+     */
+    void advance(source::stream::size_type n = 1) {
+        const source::stream_chunk &c = chunk();
+        if (m_offset + n < c.length) {
+            m_offset += n;
+            return;
+        }
+        m_base = &c.rest;
+        m_offset = m_base->offset();
+        m_chunk = nullptr;
+    }
+
+    /** Returns the position of the current character. */
+    source::fragment_position position() {
+        const source::stream_chunk &c = chunk();
+        if (c.begin == nullptr)
+            return c.begin;
+        return source::fragment_position(
+                c.begin.head, c.begin.index + m_offset);
+    }
+
+    /** Returns the stream that starts at the current character. */
+    source::stream to_stream() const {
+        if (m_offset == m_base->offset())
+            return *m_base;
+        return source::stream(m_base->node(), m_offset);
+    }
+
+}; // class cursor
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_cursor_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -41,7 +41,7 @@ namespace parsing {
 
 future<result<empty>> parse_eof(const state &s) {
     auto &c = s.context;
-    return s.rest->get().map([c](const stream_value &sv) -> result<empty> {
+    return s.rest.map([c](const stream_value &sv) -> result<empty> {
         if (sv.first != nullptr)
             return {};
         return product<empty>{empty(), {sv.second, c}};
@@ -0,0 +1,323 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_fused_combinator_hh
+#define INCLUDED_language_parsing_fused_combinator_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "language/parsing/char_class.hh"
+#include "language/parsing/cursor.hh"
+#include "language/parsing/parser.hh"
+
+/*
+ * Fused parsers are statically-typed counterparts of the parser functions
+ * that return futures. A fused parser is a class that has a member type
+ * value_type and a const function call operator
+ *
+ *     bool operator()(cursor &c, const context &x, value_type &v) const;
+ *
+ * that parses the characters at the cursor. If parsing succeeds, the operator
+ * stores the result to v, advances the cursor past the parsed characters, and
+ * returns true. Otherwise, it returns false without moving the cursor, in
+ * which case v may have been partially modified. The value v must be passed
+ * in the state its default constructor leaves it in (or in an equivalent
+ * state such as an empty container with a custom allocator).
+ *
+ * Combinators are class templates that take other parsers as type arguments,
+ * so a grammar composed of them is a single type whose parsing code is
+ * inlined as a whole. No future, std::function or heap-allocated state is
+ * involved. The parsers have no reports; the caller has to report errors if
+ * parsing fails. Since a cursor reads only available chunks, fused parsers
+ * throw {@link stream_not_ready} if the source is not yet in memory.
+ */
+
+namespace sesh {
+namespace language {
+namespace parsing {
+namespace fused {
+
+/**
+ * Parses a character that satisfies the predicate. The predicate type must
+ * have a const function call operator that takes a character and a context
+ * and returns a bool.
+ */
+template<typename Predicate>
+class char_parser {
+
+public:
+
+    using value_type = common::xchar;
+
+    Predicate predicate;
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        const common::xchar *p = c.peek();
+        if (p == nullptr || !predicate(*p, x))
+            return false;
+        v = *p;
+        c.advance();
+        return true;
+    }
+
+}; // template<typename Predicate> class char_parser
+
+/** Parses the character given as the template argument. */
+template<common::xchar C>
+class literal {
+
+public:
+
+    using value_type = common::xchar;
+
+    bool operator()(cursor &c, const context &, value_type &v) const {
+        const common::xchar *p = c.peek();
+        if (p == nullptr || *p != C)
+            return false;
+        v = C;
+        c.advance();
+        return true;
+    }
+
+}; // template<common::xchar C> class literal
+
+namespace combinator_impl {
+
+constexpr inline char_class_set union_of() noexcept {
+    return char_class_set();
+}
+
+template<typename... C>
+constexpr char_class_set union_of(char_class c, C... cs) noexcept {
+    return char_class_set(c) | union_of(cs...);
+}
+
+/** Appends results of the parser to the container until it fails. */
+template<typename P, typename Container>
+void append_all(
+        const P &p, cursor &c, const context &x, Container &results) {
+    for (;;) {
+        typename P::value_type v{};
+        if (!p(c, x, v))
+            return;
+        results.push_back(std::move(v));
+    }
+}
+
+} // namespace combinator_impl
+
+/** Predicate for {@link char_parser} that accepts any of the classes. */
+template<char_class... C>
+class any_of_classes {
+
+public:
+
+    bool operator()(common::xchar c, const context &x) const {
+        return classify(c, x).intersects(combinator_impl::union_of(C...));
+    }
+
+}; // template<char_class... C> class any_of_classes
+
+/** Predicate for {@link char_parser} that rejects all of the classes. */
+template<char_class... C>
+class none_of_classes {
+
+public:
+
+    bool operator()(common::xchar c, const context &x) const {
+        return !classify(c, x).intersects(combinator_impl::union_of(C...));
+    }
+
+}; // template<char_class... C> class none_of_classes
+
+/**
+ * Applies the parsers in a row. The result is a tuple of the results of all
+ * the parsers. If any of the parsers fails, the cursor is moved back to
+ * where the join started.
+ */
+template<typename... P>
+class join {
+
+public:
+
+    using value_type = std::tuple<typename P::value_type...>;
+
+    std::tuple<P...> parsers;
+
+private:
+
+    template<std::size_t I>
+    using index = std::integral_constant<std::size_t, I>;
+
+    bool parse_from(
+            cursor &, const context &, value_type &, index<sizeof...(P)>)
+            const {
+        return true;
+    }
+
+    template<std::size_t I>
+    bool parse_from(
+            cursor &c,
+            const context &x,
+            value_type &v,
+            index<I>) const {
+        return std::get<I>(parsers)(c, x, std::get<I>(v)) &&
+                parse_from(c, x, v, index<I + 1>());
+    }
+
+public:
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        cursor start = c;
+        if (parse_from(c, x, v, index<0>()))
+            return true;
+        c = start;
+        return false;
+    }
+
+}; // template<typename... P> class join
+
+/**
+ * Applies the parser repeatedly until it fails. The results are appended to
+ * the container, which must have the <code>push_back</code> method. The
+ * repeat as a whole always succeeds. Like {@link parsing::repeat}, the parser
+ * must not succeed without consuming any characters.
+ */
+template<
+        typename P,
+        typename Container = std::vector<typename P::value_type>>
+class repeat {
+
+public:
+
+    using value_type = Container;
+
+    P parser;
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        combinator_impl::append_all(parser, c, x, v);
+        return true;
+    }
+
+}; // template<typename P, typename Container> class repeat
+
+/**
+ * Like {@link repeat}, but fails if the parser does not succeed at least once.
+ */
+template<
+        typename P,
+        typename Container = std::vector<typename P::value_type>>
+class one_or_more {
+
+public:
+
+    using value_type = Container;
+
+    P parser;
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        typename P::value_type first{};
+        if (!parser(c, x, first))
+            return false;
+        v.push_back(std::move(first));
+        combinator_impl::append_all(parser, c, x, v);
+        return true;
+    }
+
+}; // template<typename P, typename Container> class one_or_more
+
+/**
+ * Always succeeds by wrapping the result of the parser in a maybe. The maybe
+ * is empty if the parser fails.
+ */
+template<typename P>
+class option {
+
+public:
+
+    using value_type = common::maybe<typename P::value_type>;
+
+    P parser;
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        typename P::value_type result{};
+        if (parser(c, x, result))
+            v.try_emplace(std::move(result));
+        else
+            v.clear();
+        return true;
+    }
+
+}; // template<typename P> class option
+
+/**
+ * Converts the result of the parser with the function. The function type
+ * must have a const function call operator that takes an rvalue reference to
+ * the result of the parser.
+ */
+template<typename P, typename F>
+class map_value {
+
+public:
+
+    using value_type = typename std::decay<typename std::result_of<
+            const F &(typename P::value_type &&)>::type>::type;
+
+    P parser;
+    F function;
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        typename P::value_type result{};
+        if (!parser(c, x, result))
+            return false;
+        v = function(std::move(result));
+        return true;
+    }
+
+}; // template<typename P, typename F> class map_value
+
+/** Function for {@link map_value} that extracts an element of a tuple. */
+template<std::size_t I>
+class element {
+
+public:
+
+    template<
+            typename Tuple,
+            typename T = typename std::tuple_element<
+                    I, typename std::decay<Tuple>::type>::type>
+    T operator()(Tuple &&t) const {
+        return std::move(std::get<I>(t));
+    }
+
+}; // template<std::size_t I> class element
+
+} // namespace fused
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_fused_combinator_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
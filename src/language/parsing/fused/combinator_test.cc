@@ -0,0 +1,156 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/parsing/char_class.hh"
+#include "language/parsing/cursor.hh"
+#include "language/parsing/fused/combinator.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/parser_test_helper.hh"
+#include "language/source/stream.hh"
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::common::xchar;
+using sesh::common::xstring;
+using sesh::language::parsing::char_class;
+using sesh::language::parsing::context;
+using sesh::language::parsing::cursor;
+using sesh::language::parsing::default_context_stub;
+using sesh::language::parsing::fused::any_of_classes;
+using sesh::language::parsing::fused::char_parser;
+using sesh::language::parsing::fused::element;
+using sesh::language::parsing::fused::join;
+using sesh::language::parsing::fused::literal;
+using sesh::language::parsing::fused::map_value;
+using sesh::language::parsing::fused::one_or_more;
+using sesh::language::parsing::fused::option;
+using sesh::language::parsing::fused::repeat;
+using sesh::language::parsing::stream_stub;
+using sesh::language::source::stream;
+
+using digit = char_parser<any_of_classes<char_class::digit>>;
+
+/** Returns the number of characters from the cursor to the end of input. */
+std::size_t rest_length(cursor c) {
+    std::size_t n = 0;
+    for (; c.peek() != nullptr; c.advance())
+        ++n;
+    return n;
+}
+
+/**
+ * Applies the parser to the source and checks the number of remaining
+ * characters.
+ */
+template<typename P>
+bool parse(
+        const xstring &source,
+        typename P::value_type &v,
+        std::size_t expected_rest_length) {
+    const stream s = stream_stub(source);
+    const context x = default_context_stub();
+    cursor c(s);
+    bool succeeded = P()(c, x, v);
+    CHECK(rest_length(c) == expected_rest_length);
+    return succeeded;
+}
+
+TEST_CASE("Fused literal parses the character") {
+    xchar v = L('\0');
+    CHECK(parse<literal<L('a')>>(L("ab"), v, 1));
+    CHECK(v == L('a'));
+}
+
+TEST_CASE("Fused literal rejects other characters") {
+    xchar v = L('\0');
+    CHECK_FALSE(parse<literal<L('a')>>(L("ba"), v, 2));
+    CHECK_FALSE(parse<literal<L('a')>>(L(""), v, 0));
+}
+
+TEST_CASE("Fused char parser tests the class of the character") {
+    xchar v = L('\0');
+    CHECK(parse<digit>(L("1a"), v, 1));
+    CHECK(v == L('1'));
+    CHECK_FALSE(parse<digit>(L("a1"), v, 2));
+}
+
+TEST_CASE("Fused join parses in a row") {
+    using p = join<literal<L('a')>, digit, literal<L('b')>>;
+    p::value_type v{};
+    CHECK(parse<p>(L("a1bc"), v, 1));
+    CHECK(v == std::make_tuple(L('a'), L('1'), L('b')));
+}
+
+TEST_CASE("Fused join backtracks on failure") {
+    using p = join<literal<L('a')>, digit, literal<L('b')>>;
+    p::value_type v{};
+    CHECK_FALSE(parse<p>(L("a1c"), v, 3));
+}
+
+TEST_CASE("Fused repeat collects results") {
+    repeat<digit>::value_type v;
+    CHECK(parse<repeat<digit>>(L("123a"), v, 1));
+    CHECK(v == (std::vector<xchar>{L('1'), L('2'), L('3')}));
+}
+
+TEST_CASE("Fused repeat succeeds without results") {
+    using p = repeat<digit, xstring>;
+    p::value_type v;
+    CHECK(parse<p>(L("a"), v, 1));
+    CHECK(v.empty());
+}
+
+TEST_CASE("Fused one-or-more requires a result") {
+    using p = one_or_more<digit, xstring>;
+    p::value_type v;
+    CHECK(parse<p>(L("12"), v, 0));
+    CHECK(v == L("12"));
+    v.clear();
+    CHECK_FALSE(parse<p>(L("a"), v, 1));
+}
+
+TEST_CASE("Fused option wraps the result") {
+    option<digit>::value_type v;
+    CHECK(parse<option<digit>>(L("1"), v, 0));
+    REQUIRE(v);
+    CHECK(*v == L('1'));
+
+    option<digit>::value_type v2;
+    CHECK(parse<option<digit>>(L("a"), v2, 1));
+    CHECK_FALSE(v2);
+}
+
+TEST_CASE("Fused map converts the result") {
+    using p = map_value<join<literal<L('a')>, digit>, element<1>>;
+    xchar v = L('\0');
+    CHECK(parse<p>(L("a2"), v, 0));
+    CHECK(v == L('2'));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,194 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_fused_grammar_hh
+#define INCLUDED_language_parsing_fused_grammar_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <utility>
+#include "common/constant_function.hh"
+#include "common/empty.hh"
+#include "common/visitor.hh"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/parsing/blackhole.hh"
+#include "language/parsing/char_class.hh"
+#include "language/parsing/cursor.hh"
+#include "language/parsing/fused/combinator.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/token_run.hh"
+#include "language/syntax/raw_string.hh"
+#include "language/syntax/simple_command.hh"
+#include "language/syntax/word.hh"
+#include "language/syntax/word_component.hh"
+
+/*
+ * The grammar below is the same as that of the asynchronous parser functions
+ * of the same names.
+ */
+
+namespace sesh {
+namespace language {
+namespace parsing {
+namespace fused {
+
+/** Same as {@link parsing::skip_line_continuation}. */
+using line_continuation = join<literal<L('\\')>, literal<L('\n')>>;
+
+/** Same as {@link parsing::skip_line_continuations}. */
+using line_continuations = repeat<line_continuation, blackhole>;
+
+/** Same as {@link parsing::test_char_after_line_continuations}. */
+template<typename P>
+using after_line_continuations =
+        map_value<join<line_continuations, P>, element<1>>;
+
+/** Parses a blank character, possibly after line continuations. */
+using blank = after_line_continuations<
+        char_parser<any_of_classes<char_class::blank>>>;
+
+/** Same as {@link parsing::skip_comment}. */
+using comment = map_value<
+        join<
+            literal<L('#')>,
+            repeat<
+                char_parser<none_of_classes<char_class::newline>>,
+                common::xstring>>,
+        element<1>>;
+
+/** Same as {@link parsing::skip_whitespaces}. */
+using whitespaces = map_value<
+        join<repeat<blank, blackhole>, line_continuations, option<comment>>,
+        common::constant_function<common::empty>>;
+
+/** Predicate for characters of raw strings in a word. */
+using raw_string_char = none_of_classes<
+        char_class::blank, char_class::delimiter, char_class::special>;
+
+/**
+ * Parses the characters of a raw string in a word. Runs of plain token
+ * characters that are contiguous in memory are consumed at once. The result
+ * is the same as that of
+ * <code>one_or_more&lt;after_line_continuations&lt;char_parser&lt;
+ * raw_string_char>>, common::xstring></code>.
+ */
+class raw_string_chars {
+
+public:
+
+    using value_type = common::xstring;
+
+    bool operator()(cursor &c, const context &x, value_type &v) const {
+        after_line_continuations<char_parser<raw_string_char>> one_char;
+        for (;;) {
+            if (std::size_t length = c.contiguous_length()) {
+                const common::xchar *begin = c.peek();
+                std::size_t n = count_plain_token_chars(begin, begin + length);
+                if (n > 0) {
+                    v.append(begin, n);
+                    c.advance(n);
+                    continue;
+                }
+            }
+            common::xchar ch;
+            if (!one_char(c, x, ch))
+                break;
+            v.push_back(ch);
+        }
+        return !v.empty();
+    }
+
+}; // class raw_string_chars
+
+/** Function for {@link map_value} that constructs a raw string. */
+class to_raw_string {
+
+public:
+
+    syntax::raw_string operator()(common::xstring &&s) const {
+        return syntax::raw_string{std::move(s)};
+    }
+
+}; // class to_raw_string
+
+/** Function for {@link map_value} that constructs a word component. */
+class to_word_component {
+
+public:
+
+    template<typename T>
+    syntax::word::component_pointer operator()(T &&t) const {
+        return common::make_shared_visitable<syntax::word_component>(
+                std::forward<T>(t));
+    }
+
+}; // class to_word_component
+
+/** Function for {@link map_value} that constructs a word. */
+class to_word {
+
+public:
+
+    syntax::word operator()(syntax::word::component_list &&cl) const {
+        return syntax::word{std::move(cl)};
+    }
+
+}; // class to_word
+
+/** Function for {@link map_value} that constructs a simple command. */
+class to_simple_command {
+
+public:
+
+    syntax::simple_command operator()(
+            syntax::simple_command::word_list &&wl) const {
+        return syntax::simple_command{std::move(wl)};
+    }
+
+}; // class to_simple_command
+
+/** Same as {@link parsing::parse_raw_string} for raw strings in a word. */
+using raw_string = map_value<raw_string_chars, to_raw_string>;
+
+/** Same as {@link parsing::parse_word_component} for a word. */
+using word_component = map_value<raw_string, to_word_component>;
+
+/** Same as {@link parsing::parse_word} for a word token. */
+using word = map_value<
+        one_or_more<word_component, syntax::word::component_list>,
+        to_word>;
+
+/**
+ * Same as {@link parsing::parse_simple_command} except that no report is
+ * returned if the command is empty.
+ */
+using simple_command = map_value<
+        one_or_more<
+            map_value<join<word, whitespaces>, element<0>>,
+            syntax::simple_command::word_list>,
+        to_simple_command>;
+
+} // namespace fused
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_fused_grammar_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,133 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "allocation_counter.hh"
+#include "common/either.hh"
+#include "common/xstring.hh"
+#include "language/parsing/cursor.hh"
+#include "language/parsing/fused/grammar.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/simple_command.hh"
+#include "language/source/fragment.hh"
+#include "language/source/stream.hh"
+#include "language/syntax/simple_command.hh"
+
+/*
+ * Compares the throughput of parsing a simple command with the parser
+ * functions that return futures and with the fused parsers. The command has
+ * words of various lengths separated by blanks and line continuations and
+ * ends with a comment.
+ */
+
+namespace {
+
+using sesh::allocation_count;
+using sesh::common::trial;
+using sesh::common::xstring;
+using sesh::language::parsing::context;
+using sesh::language::parsing::cursor;
+using sesh::language::parsing::parse_simple_command;
+using sesh::language::parsing::result;
+using sesh::language::parsing::simple_command_parse;
+using sesh::language::parsing::state;
+using sesh::language::source::fragment;
+using sesh::language::source::fragment_position;
+using sesh::language::source::stream;
+using sesh::language::source::stream_of;
+using sesh::language::syntax::simple_command;
+
+namespace fused = sesh::language::parsing::fused;
+
+using clock = std::chrono::steady_clock;
+
+xstring make_command(std::size_t word_count) {
+    xstring command;
+    for (std::size_t i = 0; i < word_count; ++i) {
+        command.append(i % 7 + 1, L('w'));
+        command += i % 5 == 4 ? L(" \\\n\t") : L(" ");
+    }
+    command += L("# comment\n");
+    return command;
+}
+
+std::size_t parse_asynchronously(const state &s) {
+    std::size_t word_count = 0;
+    parse_simple_command(s).then([&](
+            trial<result<simple_command_parse>> &&t) {
+        if (t->product)
+            word_count =
+                    t->product->value.value<simple_command>().words.size();
+    });
+    return word_count;
+}
+
+std::size_t parse_fused(const state &s) {
+    fused::simple_command::value_type sc;
+    cursor c(s.rest);
+    if (!fused::simple_command()(c, s.context, sc))
+        return 0;
+    return sc.words.size();
+}
+
+template<typename Parse>
+void run(
+        const char *name,
+        Parse parse,
+        const state &s,
+        std::size_t length,
+        std::size_t repeat_count) {
+    std::size_t start_count = allocation_count();
+    clock::time_point start = clock::now();
+    std::size_t word_count = 0;
+    for (std::size_t i = 0; i < repeat_count; ++i)
+        word_count += parse(s);
+    double ms = std::chrono::duration<double, std::milli>(
+            clock::now() - start).count();
+    std::size_t allocations = allocation_count() - start_count;
+    double chars = static_cast<double>(length) * repeat_count;
+
+    std::cout << name << '\t' << word_count / repeat_count << '\t' <<
+            static_cast<double>(allocations) / chars << '\t' <<
+            chars / ms / 1000 << '\n';
+}
+
+void run(std::size_t word_count, std::size_t repeat_count) {
+    const xstring command = make_command(word_count);
+    const stream rest = stream_of(fragment_position(
+            std::make_shared<fragment>(command)));
+    const state s{rest, context{{}, 0}};
+    run("future", parse_asynchronously, s, command.length(), repeat_count);
+    run("fused", parse_fused, s, command.length(), repeat_count);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "parser\twords\tallocs/char\tthroughput(Mchars/s)\n";
+    run(16, 4096);
+    run(256, 256);
+    return 0;
+}
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
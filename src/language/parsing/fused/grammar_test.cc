@@ -0,0 +1,113 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include "catch.hpp"
+#include "common/empty.hh"
+#include "common/xstring.hh"
+#include "language/parsing/cursor.hh"
+#include "language/parsing/fused/grammar.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/parser_test_helper.hh"
+#include "language/source/stream.hh"
+#include "language/syntax/raw_string.hh"
+#include "language/syntax/simple_command.hh"
+#include "language/syntax/simple_command_test_helper.hh"
+
+namespace {
+
+using sesh::common::empty;
+using sesh::common::xstring;
+using sesh::language::parsing::context;
+using sesh::language::parsing::cursor;
+using sesh::language::parsing::default_context_stub;
+using sesh::language::parsing::fused::comment;
+using sesh::language::parsing::fused::line_continuations;
+using sesh::language::parsing::fused::raw_string;
+using sesh::language::parsing::fused::simple_command;
+using sesh::language::parsing::fused::whitespaces;
+using sesh::language::parsing::stream_stub;
+using sesh::language::source::stream;
+using sesh::language::syntax::expect_raw_string_simple_command;
+
+/** Returns the number of characters from the cursor to the end of input. */
+std::size_t rest_length(cursor c) {
+    std::size_t n = 0;
+    for (; c.peek() != nullptr; c.advance())
+        ++n;
+    return n;
+}
+
+/**
+ * Applies the parser to the stream and checks the number of remaining
+ * characters.
+ */
+template<typename P>
+bool parse(
+        const stream &s,
+        typename P::value_type &v,
+        std::size_t expected_rest_length) {
+    const context x = default_context_stub();
+    cursor c(s);
+    bool succeeded = P()(c, x, v);
+    CHECK(rest_length(c) == expected_rest_length);
+    return succeeded;
+}
+
+TEST_CASE("Fused line continuations are skipped") {
+    line_continuations::value_type v;
+    CHECK(parse<line_continuations>(stream_stub(L("\\\n\\\n\\")), v, 1));
+}
+
+TEST_CASE("Fused comment parses until newline") {
+    xstring v;
+    CHECK(parse<comment>(stream_stub(L("# a b\\\nc")), v, 2));
+    CHECK(v == L(" a b\\"));
+    xstring v2;
+    CHECK_FALSE(parse<comment>(stream_stub(L("a#")), v2, 2));
+}
+
+TEST_CASE("Fused whitespaces skip blanks, continuations and comment") {
+    empty v;
+    CHECK(parse<whitespaces>(stream_stub(L(" \\\n\t\\\n# c\nx")), v, 2));
+    CHECK(parse<whitespaces>(stream_stub(L("x")), v, 1));
+}
+
+TEST_CASE("Fused raw string spans chunks and line continuations") {
+    raw_string::value_type v;
+    const stream s = stream_stub(L("ab\\"), stream_stub(L("\ncd;")));
+    CHECK(parse<raw_string>(s, v, 1));
+    CHECK(v.value == L("abcd"));
+}
+
+TEST_CASE("Fused simple command parses words") {
+    simple_command::value_type v;
+    const stream s = stream_stub(L("ec\\\nho  a\\\n\tb # comment\n;"));
+    CHECK(parse<simple_command>(s, v, 2));
+    expect_raw_string_simple_command(v, {L("echo"), L("a"), L("b")});
+}
+
+TEST_CASE("Fused simple command fails without words") {
+    simple_command::value_type v;
+    CHECK_FALSE(parse<simple_command>(stream_stub(L(";")), v, 1));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -21,7 +21,6 @@
 #include <functional>
 #include <tuple>
 #include "async/future.hh"
-#include "common/constant_function.hh"
 #include "common/xchar.hh"
 #include "common/xstring.hh"
 #include "language/parsing/char.hh"
@@ -32,7 +31,6 @@
 namespace {
 
 using sesh::async::future;
-using sesh::common::constant;
 using sesh::common::xchar;
 using sesh::common::xchar_traits;
 
@@ -43,7 +41,7 @@ namespace language {
 namespace parsing {
 
 future<result<xchar>> test_char_after_line_continuations(
-        const std::function<char_predicate> &p, const state &s) {
+        const char_test &p, const state &s) {
     using namespace std::placeholders;
     return map_value(
             join(skip_line_continuations, std::bind(test_char, p, _1))(s),
@@ -59,7 +57,7 @@ future<result<xchar>> parse_char_after_line_continuations(
 }
 
 future<result<xchar>> accept_char_after_line_continuations(const state &s) {
-    return test_char_after_line_continuations(constant(true), s);
+    return test_char_after_line_continuations(char_test(), s);
 }
 
 } // namespace parsing
@@ -37,7 +37,7 @@ namespace parsing {
  * This parser never returns any report even on failure.
  */
 auto test_char_after_line_continuations(
-        const std::function<char_predicate> &, const state &)
+        const char_test &, const state &)
         -> async::future<result<common::xchar>>;
 
 /**
@@ -32,6 +32,7 @@
 #include "async/future.hh"
 #include "common/empty.hh"
 #include "common/function_helper.hh"
+#include "common/xchar.hh"
 #include "language/source/stream.hh"
 #include "ui/message/report.hh"
 
@@ -42,19 +43,46 @@ namespace parsing {
 /** Data that may affect how source code is parsed. */
 class context {
 
-public:
+private:
+
+    std::locale m_locale;
+
+    /** Cache of the ctype facet of m_locale. Null until looked up. */
+    mutable const std::ctype<common::xchar> *m_ctype_facet = nullptr;
 
-    std::locale locale;
+public:
 
     /**
      * Dummy data. Will be replaced with pending_here_documents and aliases.
      */
-    int dummy;
+    int dummy = 0;
 
     // TODO pending_here_documents;
 
     // TODO aliases
 
+    context() = default;
+
+    context(const std::locale &l, int dummy) : m_locale(l), dummy(dummy) { }
+
+    const std::locale &locale() const noexcept { return m_locale; }
+
+    void set_locale(const std::locale &l) {
+        m_locale = l;
+        m_ctype_facet = nullptr;
+    }
+
+    /**
+     * Returns the ctype facet of the locale. The facet is looked up on the
+     * first call and cached until the locale is changed.
+     */
+    const std::ctype<common::xchar> &ctype_facet() const {
+        if (m_ctype_facet == nullptr)
+            m_ctype_facet = &std::use_facet<std::ctype<common::xchar>>(
+                    m_locale);
+        return *m_ctype_facet;
+    }
+
 }; // class context
 
 /** State in syntax parsing. */
@@ -25,13 +25,13 @@
 #include <utility>
 #include "async/future_test_helper.hh"
 #include "catch.hpp"
-#include "common/copy.hh"
 #include "common/either.hh"
 #include "common/nop.hh"
 #include "common/xstring.hh"
 #include "language/parsing/parser.hh"
 #include "language/source/fragment.hh"
 #include "language/source/fragment_test_helper.hh"
+#include "language/source/location.hh"
 #include "language/source/stream.hh"
 #include "ui/message/format.hh"
 #include "ui/message/report.hh"
@@ -198,7 +198,7 @@ void check_parser_success_rest(
                 using T = common::trial<source::stream_value>;
                 const source::stream &s2 = r.product->state.rest;
                 bool called = false;
-                s2->get().then([&](const T &t) {
+                s2.get().then([&](const T &t) {
                     REQUIRE(t);
                     CHECK(t->first == std::next(fp, source_to_parse.length()));
                     called = true;
@@ -221,9 +221,9 @@ void check_parser_no_excess(
         P &&parse,
         const source::fragment::value_type &src,
         const context &c = default_context_stub()) {
-    auto failing_stream = source::stream([]() -> source::stream_value_future {
+    auto failing_stream = source::stream([]() -> source::stream_chunk_future {
         FAIL("The parser is reading too much source code");
-        return source::empty_stream_value_future();
+        return source::empty_stream_chunk_future();
     });
     check_parser(
             std::forward<P>(parse),
@@ -395,7 +395,7 @@ void check_parser_single_report(
                         ui::message::report(
                             expected_category,
                             ui::message::format<>(expected_message),
-                            common::copy(fp_report_point)));
+                            source::location_of(fp_report_point)));
             });
 }
 
@@ -40,7 +40,7 @@ namespace sesh {
 namespace language {
 namespace parsing {
 
-auto parse_raw_string(const std::function<char_predicate> &p, const state &s)
+auto parse_raw_string(const char_test &p, const state &s)
         -> future<result<raw_string>> {
     using std::placeholders::_1;
     return map_value(
@@ -20,7 +20,6 @@
 
 #include "buildconfig.h"
 
-#include <functional>
 #include "async/future.hh"
 #include "common/xchar.hh"
 #include "language/parsing/char_predicate.hh"
@@ -39,7 +38,7 @@ namespace parsing {
  * returns no reports.
  */
 auto parse_raw_string(
-        const std::function<char_predicate> &, const state &)
+        const char_test &, const state &)
         -> async::future<result<syntax::raw_string>>;
 
 } // namespace parsing
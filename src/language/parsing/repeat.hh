@@ -20,14 +20,17 @@
 
 #include "buildconfig.h"
 
-#include <algorithm>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <vector>
 #include "async/future.hh"
+#include "async/promise.hh"
 #include "common/container_helper.hh"
+#include "common/either.hh"
 #include "common/empty.hh"
 #include "language/parsing/parser.hh"
+#include "ui/message/report.hh"
 
 namespace sesh {
 namespace language {
@@ -35,58 +38,146 @@ namespace parsing {
 
 namespace repeat_impl {
 
+/**
+ * A repeater applies the parser in a loop as long as the results of the
+ * parser are available synchronously. When the parser returns a future whose
+ * result is not yet available, the loop is suspended and resumed by the
+ * callback that receives the result. The results and reports are accumulated
+ * in the repeater, which is shared by the callbacks, so they are never moved
+ * between iterations.
+ */
 template<typename Parser, typename ResultList>
-class repeater {
+class repeater :
+        public std::enable_shared_from_this<repeater<Parser, ResultList>> {
 
 public:
 
-    Parser parser;
-    class state state;
-    ResultList results;
-    std::vector<ui::message::report> reports;
-
-    template<typename T>
-    async::future<result<ResultList>> operator()(product<T> &&p) {
-        state = std::move(p.state);
-        results.push_back(std::move(p.value));
-        return (*this)();
+    using value_type = typename result_type_of<Parser>::type;
+    using result_type = result<ResultList>;
+
+private:
+
+    class receiver {
+
+    public:
+
+        std::shared_ptr<repeater> self;
+
+        void operator()(common::trial<result<value_type>> &&t) {
+            self->receive(std::move(t));
+        }
+
+    }; // class receiver
+
+    Parser m_parser;
+    class state m_state;
+    ResultList m_results;
+    std::vector<ui::message::report> m_reports;
+    async::promise<result_type> m_promise;
+
+    /** True if the repeat fails unless the parser succeeds at least once. */
+    bool m_nonempty;
+
+    /** True while the loop is waiting for a result in the run function. */
+    bool m_looping = false;
+
+    /** True if the loop received the result it was waiting for. */
+    bool m_received = false;
+
+    /** True if the loop should continue after receiving the result. */
+    bool m_continuing = false;
+
+    /**
+     * Accepts a result of the parser. Returns true if the parser should be
+     * applied again. Otherwise, the result of the repeat is set to the
+     * promise.
+     */
+    bool accept(common::trial<result<value_type>> &&t) noexcept {
+        try {
+            result<value_type> &r = t.get();
+            common::move(r.reports, m_reports);
+            if (r.product) {
+                m_state = std::move(r.product->state);
+                m_results.push_back(std::move(r.product->value));
+                m_nonempty = false;
+                return true;
+            }
+            if (m_nonempty)
+                std::move(m_promise).set_result(
+                        common::empty(), std::move(m_reports));
+            else
+                std::move(m_promise).set_result(
+                        product<ResultList>{
+                                std::move(m_results), std::move(m_state)},
+                        std::move(m_reports));
+        } catch (...) {
+            std::move(m_promise).fail_with_current_exception();
+        }
+        return false;
     }
 
-    template<typename T>
-    async::future<result<ResultList>> operator()(result<T> &&r) {
-        common::move(r.reports, reports);
-        if (!r.product)
-            return async::make_future<result<ResultList>>(
-                    product<ResultList>{std::move(results), std::move(state)},
-                    std::move(reports));
-        return (*this)(std::move(*r.product));
+    void receive(common::trial<result<value_type>> &&t) noexcept {
+        bool continuing = accept(std::move(t));
+        if (m_looping) {
+            m_received = true;
+            m_continuing = continuing;
+        } else if (continuing) {
+            run();
+        }
     }
 
-    async::future<result<ResultList>> operator()() {
-        return parser(state).map(std::move(*this)).unwrap();
-    }
-
-}; // template<typename Parser, typename ResultList> class repeater
-
-template<typename Parser, typename ResultList>
-class nonempty_repeater {
-
 public:
 
-    using repeater_type = class repeater<Parser, ResultList>;
-
-    repeater_type repeater;
-
-    template<typename T>
-    async::future<result<ResultList>> operator()(result<T> &&r) {
-        if (!r.product)
-            return async::make_future<result<ResultList>>(
-                    common::empty(), std::move(r.reports));
-        common::move(r.reports, repeater.reports);
-        return repeater(std::move(*r.product));
+    template<typename P>
+    repeater(
+            P &&p,
+            const class state &s,
+            ResultList &&results,
+            async::promise<result_type> &&promise,
+            bool nonempty) :
+            m_parser(std::forward<P>(p)),
+            m_state(s),
+            m_results(std::move(results)),
+            m_reports(),
+            m_promise(std::move(promise)),
+            m_nonempty(nonempty) { }
+
+    /**
+     * Applies the parser repeatedly until its result is not available
+     * synchronously or the repeat finishes.
+     */
+    void run() noexcept {
+        std::shared_ptr<repeater> self = this->shared_from_this();
+        do {
+            m_looping = true;
+            m_received = false;
+            try {
+                m_parser(m_state).then(receiver{self});
+            } catch (...) {
+                m_looping = false;
+                std::move(m_promise).fail_with_current_exception();
+                return;
+            }
+            m_looping = false;
+        } while (m_received && m_continuing);
     }
 
-}; // template<typename Parser, typename ResultList> class nonempty_repeater
+}; // template<typename Parser, typename ResultList> class repeater
+
+template<typename P, typename ResultList>
+async::future<result<ResultList>> start(
+        P &&p, const state &s, ResultList &&results, bool nonempty) {
+    using repeater_type =
+            repeater<typename std::decay<P>::type, ResultList>;
+    auto pf = async::make_promise_future_pair<result<ResultList>>();
+    std::make_shared<repeater_type>(
+            std::forward<P>(p),
+            s,
+            std::forward<ResultList>(results),
+            std::move(pf.first),
+            nonempty)->run();
+    return std::move(pf.second);
+}
 
 } // namespace repeat_impl
 
@@ -115,9 +206,8 @@ template<
         typename ResultList = std::vector<typename result_type_of<P>::type>>
 async::future<result<ResultList>> repeat(
         P &&p, const state &s, ResultList &&results = ResultList()) {
-    repeat_impl::repeater<typename std::decay<P>::type, ResultList> r{
-            std::forward<P>(p), s, std::forward<ResultList>(results), {}};
-    return r();
+    return repeat_impl::start(
+            std::forward<P>(p), s, std::forward<ResultList>(results), false);
 }
 
 /**
@@ -130,10 +220,8 @@ template<
         typename ResultList = std::vector<typename result_type_of<P>::type>>
 async::future<result<ResultList>> one_or_more(
         P &&p, const state &s, ResultList &&results = ResultList()) {
-    using Parser = typename std::decay<P>::type;
-    repeat_impl::nonempty_repeater<Parser, ResultList> r{{
-            std::forward<P>(p), s, std::forward<ResultList>(results), {}}};
-    return r.repeater.parser(s).map(std::move(r)).unwrap();
+    return repeat_impl::start(
+            std::forward<P>(p), s, std::forward<ResultList>(results), true);
 }
 
 } // namespace parsing
@@ -0,0 +1,116 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "allocation_counter.hh"
+#include "common/either.hh"
+#include "common/xstring.hh"
+#include "language/parsing/char_class.hh"
+#include "language/parsing/char_predicate.hh"
+#include "language/parsing/comment.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/word.hh"
+#include "language/source/fragment.hh"
+#include "language/source/stream.hh"
+#include "language/syntax/word.hh"
+
+/*
+ * Measures the time and memory allocations needed to parse a long word and a
+ * long comment line. Both parsers repeat a character parser for each
+ * character, so the cost of the repeat dominates.
+ */
+
+namespace {
+
+using sesh::allocation_count;
+using sesh::common::trial;
+using sesh::common::xstring;
+using sesh::language::parsing::context;
+using sesh::language::parsing::none_of;
+using sesh::language::parsing::parse_word;
+using sesh::language::parsing::result;
+using sesh::language::parsing::skip_comment;
+using sesh::language::parsing::state;
+using sesh::language::parsing::token_delimiters;
+using sesh::language::source::fragment;
+using sesh::language::source::fragment_position;
+using sesh::language::source::stream_of;
+using sesh::language::syntax::word;
+
+using clock = std::chrono::steady_clock;
+
+state make_state(const xstring &source) {
+    return state{
+            stream_of(fragment_position(std::make_shared<fragment>(source))),
+            context{{}, 0}};
+}
+
+bool parse_long_word(const state &s) {
+    bool succeeded = false;
+    parse_word(none_of(token_delimiters), s).then(
+            [&](trial<result<word>> &&t) {
+        succeeded = t->product && !t->product->value.components.empty();
+    });
+    return succeeded;
+}
+
+bool parse_long_comment(const state &s) {
+    bool succeeded = false;
+    skip_comment(s).then([&](trial<result<xstring>> &&t) {
+        succeeded = static_cast<bool>(t->product);
+    });
+    return succeeded;
+}
+
+template<typename Parse>
+void run(const char *name, Parse parse, const xstring &source) {
+    const state s = make_state(source);
+
+    std::size_t start_count = allocation_count();
+    clock::time_point start = clock::now();
+    bool succeeded = parse(s);
+    double ms = std::chrono::duration<double, std::milli>(
+            clock::now() - start).count();
+    double allocations = allocation_count() - start_count;
+
+    std::cout << name << '\t' << source.length() << '\t' << succeeded <<
+            '\t' << allocations / source.length() << '\t' << ms << '\n';
+}
+
+void run(std::size_t length) {
+    run("word", parse_long_word, xstring(length, L('w')) + L(' '));
+    run("comment", parse_long_comment, L('#') + xstring(length, L('c')) +
+            L('\n'));
+}
+
+} // namespace
+
+int main() {
+    std::cout << "parser\tchars\tsucceeded\tallocs/char\ttime(ms)\n";
+    run(1000);
+    run(10000);
+    run(100000);
+    return 0;
+}
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
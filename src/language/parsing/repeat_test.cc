@@ -19,8 +19,12 @@
 
 #include <functional>
 #include <locale>
+#include <utility>
+#include <vector>
 #include "async/future.hh"
+#include "async/promise.hh"
 #include "catch.hpp"
+#include "common/either.hh"
 #include "common/xchar.hh"
 #include "common/xstring.hh"
 #include "language/parsing/char.hh"
@@ -35,6 +39,9 @@ namespace {
 
 using sesh::async::future;
 using sesh::async::make_future_of;
+using sesh::async::make_promise_future_pair;
+using sesh::async::promise;
+using sesh::common::trial;
 using sesh::common::xchar;
 using sesh::common::xstring;
 using sesh::language::parsing::check_parser_failure;
@@ -49,6 +56,7 @@ using sesh::language::parsing::product;
 using sesh::language::parsing::repeat;
 using sesh::language::parsing::result;
 using sesh::language::parsing::state;
+using sesh::language::parsing::stream_stub;
 using sesh::language::parsing::test_char;
 using sesh::ui::message::category;
 using sesh::ui::message::report;
@@ -91,7 +99,7 @@ TEST_CASE("repeat passes context") {
             {},
             {std::locale(), 0},
             [](const context &c) {
-                CHECK(c.locale == std::locale());
+                CHECK(c.locale() == std::locale());
                 CHECK(c.dummy == 2);
             });
 }
@@ -157,6 +165,41 @@ TEST_CASE("repeat accumulates reports from repeated parsing") {
             });
 }
 
+TEST_CASE("repeat does not nest for synchronous results") {
+    using namespace std::placeholders;
+    check_parser_success_result(
+            [](const state &s) {
+                return repeat(
+                        std::bind(test_char, is_a_or_b, _1), s, xstring());
+            },
+            xstring(100000, L('a')),
+            [](const xstring &s) { CHECK(s.length() == 100000); });
+}
+
+TEST_CASE("repeat resumes when parser result becomes available") {
+    std::vector<promise<result<int>>> promises;
+    auto parser = [&promises](const state &) {
+        auto pf = make_promise_future_pair<result<int>>();
+        promises.push_back(std::move(pf.first));
+        return std::move(pf.second);
+    };
+    const state s{stream_stub(), {}};
+    std::vector<int> values;
+    repeat(parser, s).then([&values](trial<result<std::vector<int>>> &&t) {
+        REQUIRE(t->product);
+        values = std::move(t->product->value);
+    });
+
+    REQUIRE(promises.size() == 1);
+    std::move(promises[0]).set_result(product<int>{1, s});
+    REQUIRE(promises.size() == 2);
+    std::move(promises[1]).set_result(product<int>{2, s});
+    REQUIRE(promises.size() == 3);
+    CHECK(values.empty());
+    std::move(promises[2]).set_result();
+    CHECK(values == (std::vector<int>{1, 2}));
+}
+
 future<result<int>> failer(const state &) {
     result<int> r;
     r.reports.emplace_back(category::error);
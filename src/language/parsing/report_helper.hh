@@ -23,8 +23,8 @@
 #include <utility>
 #include <vector>
 #include "async/future.hh"
-#include "common/copy.hh"
 #include "language/parsing/parser.hh"
+#include "language/source/location.hh"
 #include "language/source/stream.hh"
 #include "ui/message/category.hh"
 #include "ui/message/format.hh"
@@ -46,7 +46,7 @@ public:
 
     result<R> operator()(const source::stream_value &sv) {
         r.reports.emplace_back(
-                c, std::move(f), common::copy(sv.first), std::move(rs));
+                c, std::move(f), source::location_of(sv.first), std::move(rs));
         return std::move(r);
     }
 
@@ -68,7 +68,7 @@ async::future<result<R>> add_report(
         ui::message::format<> &&f,
         const source::stream &s,
         std::vector<std::shared_ptr<const ui::message::report>> &&rs = {}) {
-    return s->get().map(
+    return s.map(
             report_adder<R>{std::move(r), c, std::move(f), std::move(rs)});
 }
 
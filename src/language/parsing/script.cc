@@ -0,0 +1,264 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "script.hh"
+
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "common/constant_function.hh"
+#include "common/container_helper.hh"
+#include "common/either.hh"
+#include "common/empty.hh"
+#include "common/xchar.hh"
+#include "language/parsing/and_or_list.hh"
+#include "language/parsing/blackhole.hh"
+#include "language/parsing/char.hh"
+#include "language/parsing/eof.hh"
+#include "language/parsing/joiner.hh"
+#include "language/parsing/mapper.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/repeat.hh"
+#include "language/parsing/report_helper.hh"
+#include "language/parsing/whitespace.hh"
+#include "language/syntax/and_or_list.hh"
+#include "ui/message/category.hh"
+#include "ui/message/format.hh"
+#include "ui/message/report.hh"
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+namespace {
+
+using sesh::async::future;
+using sesh::async::make_future;
+using sesh::async::make_future_of;
+using sesh::common::empty;
+using sesh::common::maybe;
+using sesh::common::xchar;
+using sesh::language::syntax::and_or_list;
+using sesh::ui::message::category;
+using sesh::ui::message::format;
+using sesh::ui::message::report;
+
+using next_parse = maybe<and_or_list_parse>;
+
+bool is_separator(xchar c, const context &) noexcept {
+    return c == L(';') || c == L('\n');
+}
+
+auto skip_blank_line(const state &s)
+        -> future<result<std::tuple<empty, xchar>>> {
+    using std::placeholders::_1;
+    static const auto p = join(
+            skip_whitespaces, std::bind(parse_char, L('\n'), _1));
+    return p(s);
+}
+
+future<result<blackhole>> skip_blank_lines(const state &s) {
+    return repeat(skip_blank_line, s, blackhole());
+}
+
+/** Keeps the state before the end of input, which can be parsed further. */
+class eof_state_keeper {
+
+public:
+
+    state s;
+
+    result<empty> operator()(result<empty> &&r) {
+        if (r.product)
+            r.product->state = std::move(s);
+        return std::move(r);
+    }
+
+}; // class eof_state_keeper
+
+/** Like parse_eof, but does not consume the end of input. */
+future<result<empty>> test_eof(const state &s) {
+    return parse_eof(s).map(eof_state_keeper{s});
+}
+
+class eof_expecter {
+
+public:
+
+    state s;
+
+    future<result<empty>> operator()(result<empty> &&r) {
+        if (r.product)
+            return make_future_of(std::move(r));
+        return add_report(
+                std::move(r),
+                category::error,
+                format<>(L("a newline or semicolon is expected")),
+                s.rest);
+    }
+
+}; // class eof_expecter
+
+class separator_checker {
+
+public:
+
+    state s;
+
+    future<result<empty>> operator()(result<xchar> &&r) {
+        if (r.product)
+            return make_future<result<empty>>(
+                    product<empty>{empty(), std::move(r.product->state)},
+                    std::move(r.reports));
+        return test_eof(s).map(eof_expecter{s}).unwrap();
+    }
+
+}; // class separator_checker
+
+/** Parses a newline or semicolon, or the end of input. */
+future<result<empty>> parse_separator(const state &s) {
+    return test_char(is_separator, s).map(separator_checker{s}).unwrap();
+}
+
+class and_or_list_mapper {
+
+public:
+
+    std::vector<report> reports;
+
+    result<next_parse> operator()(
+            result<std::tuple<and_or_list_parse, empty>> &&r) {
+        common::move(r.reports, reports);
+        if (!r.product)
+            return result<next_parse>(empty(), std::move(reports));
+        product<next_parse> p{next_parse(), std::move(r.product->state)};
+        p.value.try_emplace(std::move(std::get<0>(r.product->value)));
+        return result<next_parse>(std::move(p), std::move(reports));
+    }
+
+}; // class and_or_list_mapper
+
+class eof_checker {
+
+public:
+
+    state s;
+    std::vector<report> reports;
+
+    future<result<next_parse>> operator()(result<empty> &&r) {
+        common::move(r.reports, reports);
+        if (r.product)
+            return make_future<result<next_parse>>(
+                    product<next_parse>{next_parse(), std::move(s)},
+                    std::move(reports));
+
+        static const auto p = join(parse_and_or_list, parse_separator);
+        return p(s).map(and_or_list_mapper{std::move(reports)});
+    }
+
+}; // class eof_checker
+
+class blank_skipper {
+
+public:
+
+    future<result<next_parse>> operator()(
+            result<std::tuple<blackhole, empty>> &&r) const {
+        if (!r.product)
+            return make_future<result<next_parse>>(
+                    empty(), std::move(r.reports));
+
+        auto &s = r.product->state;
+        return test_eof(s).map(
+                eof_checker{s, std::move(r.reports)}).unwrap();
+    }
+
+}; // class blank_skipper
+
+class progress_checker {
+
+public:
+
+    state s;
+    std::vector<report> reports;
+
+    result<empty> operator()(bool continuing) {
+        if (!continuing)
+            return result<empty>(empty(), std::move(reports));
+        return result<empty>(
+                product<empty>{empty(), std::move(s)}, std::move(reports));
+    }
+
+}; // class progress_checker
+
+class and_or_list_passer {
+
+public:
+
+    std::shared_ptr<and_or_list_handler> handler;
+
+    future<result<empty>> operator()(result<next_parse> &&r) const {
+        if (!r.product || !r.product->value)
+            return make_future<result<empty>>(empty(), std::move(r.reports));
+
+        // TODO handle keywords and aliases
+        auto &aol = (*r.product->value).value<and_or_list>();
+        return (*handler)(std::move(aol)).map(progress_checker{
+                std::move(r.product->state), std::move(r.reports)});
+    }
+
+}; // class and_or_list_passer
+
+/** Parses and handles one and-or list. Fails when parsing should stop. */
+class script_step {
+
+public:
+
+    std::shared_ptr<and_or_list_handler> handler;
+
+    future<result<empty>> operator()(const state &s) const {
+        return parse_next_and_or_list(s).map(
+                and_or_list_passer{handler}).unwrap();
+    }
+
+}; // class script_step
+
+} // namespace
+
+future<result<next_parse>> parse_next_and_or_list(const state &s) {
+    static const auto p = join(skip_blank_lines, skip_whitespaces);
+    return p(s).map(blank_skipper()).unwrap();
+}
+
+future<result<empty>> parse_script(
+        const state &s, and_or_list_handler &&h) {
+    auto step = script_step{
+            std::make_shared<and_or_list_handler>(std::move(h))};
+    return map_value(
+            repeat(std::move(step), s, blackhole()),
+            constant(empty()));
+}
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,77 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_script_hh
+#define INCLUDED_language_parsing_script_hh
+
+#include "buildconfig.h"
+
+#include <functional>
+#include "async/future.hh"
+#include "common/either.hh"
+#include "common/empty.hh"
+#include "language/parsing/and_or_list.hh"
+#include "language/parsing/parser.hh"
+#include "language/syntax/and_or_list.hh"
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+/**
+ * Parses the next top-level and-or list in a script. Blank lines and comments
+ * before the and-or list are skipped. The and-or list must be followed by a
+ * newline or semicolon, which is consumed, or the end of input.
+ *
+ * At the end of input, the parser succeeds with an empty maybe. If the and-or
+ * list is not followed by a separator, the parser fails with an error.
+ */
+extern parser<common::maybe<and_or_list_parse>> parse_next_and_or_list;
+
+/**
+ * A handler receives a top-level and-or list that has been parsed. The
+ * returned future receives true if parsing should continue.
+ */
+using and_or_list_handler =
+        std::function<async::future<bool>(syntax::and_or_list &&)>;
+
+/**
+ * Parses a script and passes each top-level and-or list to the handler as
+ * soon as it has been parsed. The next and-or list is parsed after the future
+ * returned from the handler receives true. The handler may execute the
+ * and-or list before the rest of the script is read.
+ *
+ * The and-or lists are not accumulated. Only the state after the last parsed
+ * and-or list is kept while waiting for more input, so the source code that
+ * has been parsed can be released if the stream does not refer to the rest of
+ * the input (see {@link source::stream_of_reader}).
+ *
+ * The returned future receives the state after the last and-or list for
+ * which the handler returned true. Parsing ends at the end of input, on a
+ * syntax error, or when the handler returns false. Syntax errors are
+ * indicated by error reports in the result.
+ */
+async::future<result<common::empty>> parse_script(
+        const state &, and_or_list_handler &&);
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_script_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,167 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "async/promise.hh"
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/empty.hh"
+#include "common/xstring.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/parser_test_helper.hh"
+#include "language/parsing/script.hh"
+#include "language/source/fragment.hh"
+#include "language/source/stream.hh"
+#include "language/syntax/and_or_list.hh"
+#include "language/syntax/and_or_list_test_helper.hh"
+#include "ui/message/category.hh"
+
+namespace {
+
+using sesh::async::future;
+using sesh::async::make_future_of;
+using sesh::async::make_promise_future_pair;
+using sesh::async::promise;
+using sesh::common::empty;
+using sesh::common::trial;
+using sesh::common::xstring;
+using sesh::language::parsing::default_context_stub;
+using sesh::language::parsing::parse_script;
+using sesh::language::parsing::result;
+using sesh::language::parsing::state;
+using sesh::language::parsing::stream_stub;
+using sesh::language::source::fragment;
+using sesh::language::source::fragment_position;
+using sesh::language::source::fragment_reader;
+using sesh::language::source::stream_of_reader;
+using sesh::language::syntax::and_or_list;
+using sesh::language::syntax::expect_raw_string_and_or_list;
+using sesh::ui::message::category;
+
+/**
+ * Parses the script, collecting the and-or lists. The handler returns false
+ * after receiving the and-or lists of the argument count.
+ */
+result<empty> parse(
+        const xstring &source,
+        std::vector<and_or_list> &lists,
+        std::size_t max_count = -1) {
+    result<empty> r;
+    bool called = false;
+    parse_script(
+            state{stream_stub(source), default_context_stub()},
+            [&lists, max_count](and_or_list &&aol) {
+                lists.push_back(std::move(aol));
+                return make_future_of(lists.size() < max_count);
+            }).then([&](trial<result<empty>> &&t) {
+        REQUIRE(t);
+        r = std::move(*t);
+        called = true;
+    });
+    REQUIRE(called);
+    return r;
+}
+
+TEST_CASE("Script: and-or lists are passed in order") {
+    std::vector<and_or_list> lists;
+    auto r = parse(L("\n  # comment\na b\nc; d # e\n\n"), lists);
+    CHECK(r.product);
+    CHECK(r.reports.empty());
+    REQUIRE(lists.size() == 3);
+    expect_raw_string_and_or_list(lists[0], {L("a"), L("b")});
+    expect_raw_string_and_or_list(lists[1], {L("c")});
+    expect_raw_string_and_or_list(lists[2], {L("d")});
+}
+
+TEST_CASE("Script: last and-or list may end at end of input") {
+    std::vector<and_or_list> lists;
+    auto r = parse(L("a\nb"), lists);
+    CHECK(r.product);
+    CHECK(lists.size() == 2);
+}
+
+TEST_CASE("Script: empty script") {
+    std::vector<and_or_list> lists;
+    auto r = parse(L("  \n\n# comment"), lists);
+    CHECK(r.product);
+    CHECK(r.reports.empty());
+    CHECK(lists.empty());
+}
+
+TEST_CASE("Script: handler stops parsing") {
+    std::vector<and_or_list> lists;
+    auto r = parse(L("a\nb\nc\n"), lists, 2);
+    CHECK(r.product);
+    CHECK(lists.size() == 2);
+}
+
+TEST_CASE("Script: and-or list must be followed by separator") {
+    std::vector<and_or_list> lists;
+    auto r = parse(L("a\nb )\nc\n"), lists);
+    CHECK(lists.size() == 1);
+    REQUIRE(r.reports.size() == 1);
+    CHECK(r.reports[0].category == category::error);
+}
+
+TEST_CASE("Script: parsed source is released") {
+    std::vector<promise<fragment_position>> requests;
+    auto reader = std::make_shared<fragment_reader>([&requests]() {
+        auto pf = make_promise_future_pair<fragment_position>();
+        requests.push_back(std::move(pf.first));
+        return std::move(pf.second);
+    });
+
+    std::vector<std::weak_ptr<const fragment>> fragments;
+    std::size_t count = 0;
+    bool called = false;
+    parse_script(
+            state{stream_of_reader(reader), default_context_stub()},
+            [&fragments, &count](and_or_list &&) -> future<bool> {
+                ++count;
+                for (std::size_t i = 0; i + 1 < fragments.size(); ++i)
+                    CHECK(fragments[i].expired());
+                return make_future_of(true);
+            }).then([&](trial<result<empty>> &&t) {
+        REQUIRE(t);
+        CHECK(t->product);
+        called = true;
+    });
+
+    while (!requests.empty()) {
+        auto p = std::move(requests.back());
+        requests.pop_back();
+        if (fragments.size() >= 3) {
+            std::move(p).set_result();
+            continue;
+        }
+        auto f = std::make_shared<const fragment>(L("word\n"));
+        fragments.push_back(f);
+        std::move(p).set_result(f);
+    }
+    CHECK(called);
+    CHECK(count == 3);
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
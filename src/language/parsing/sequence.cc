@@ -22,6 +22,7 @@
 #include "async/future.hh"
 #include "language/parsing/and_or_list.hh"
 #include "language/parsing/mapper.hh"
+#include "language/parsing/synchronous.hh"
 #include "language/syntax/and_or_list.hh"
 #include "language/syntax/sequence.hh"
 
@@ -32,6 +33,7 @@ namespace parsing {
 namespace {
 
 using sesh::async::future;
+using sesh::async::make_future_of;
 using sesh::language::syntax::and_or_list;
 using sesh::language::syntax::sequence;
 
@@ -50,6 +52,9 @@ public:
 } // namespace
 
 future<result<sequence_parse>> parse_sequence(const state &s) {
+    if (auto r = parse_sequence_synchronously(s))
+        return make_future_of(std::move(*r));
+
     return map_value(
             parse_and_or_list(s),
             [](and_or_list_parse &&ap) -> sequence_parse {
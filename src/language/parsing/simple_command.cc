@@ -23,6 +23,7 @@
 #include <utility>
 #include <vector>
 #include "async/future.hh"
+#include "async/task.hh"
 #include "common/container_helper.hh"
 #include "common/either.hh"
 #include "common/empty.hh"
@@ -47,9 +48,12 @@ namespace {
 
 using sesh::async::future;
 using sesh::async::make_future_of;
+using sesh::async::start_task;
+using sesh::async::task;
 using sesh::common::empty;
 using sesh::common::maybe;
 using sesh::common::move;
+using sesh::common::trial;
 using sesh::common::type_tag;
 using sesh::language::syntax::simple_command;
 using sesh::language::syntax::word;
@@ -69,43 +73,55 @@ future<result<std::tuple<token, empty>>> parse_token_and_skip_whitespaces(
     return parser(s);
 }
 
-// defined just below
-future<result<simple_command>> parse_tokens(result<simple_command> &&r);
+/**
+ * Parses tokens one by one, adding them to the simple command. The task is
+ * the only object allocated for the whole command.
+ */
+class token_parser : public task<result<simple_command>, token_parser> {
 
-class token_acceptor {
+private:
+
+    result<simple_command> m_result;
 
 public:
 
-    result<simple_command> result_so_far;
+    explicit token_parser(const state &s) :
+            m_result(
+                    product<simple_command>{simple_command(), s},
+                    std::vector<report>()) { }
+
+    void start() {
+        auto types = acceptable_token_types(m_result.product->value);
+        await(
+                parse_token_and_skip_whitespaces(
+                        types, m_result.product->state),
+                &token_parser::accept);
+    }
+
+private:
 
-    future<result<simple_command>> operator()(
-            result<std::tuple<token, empty>> &&r) {
-        move(r.reports, result_so_far.reports);
-        if (!r.product)
-            return make_future_of(std::move(result_so_far));
+    void accept(trial<result<std::tuple<token, empty>>> &&t) {
+        auto &r = t.get();
+        move(r.reports, m_result.reports);
+        if (!r.product) {
+            complete(std::move(m_result));
+            return;
+        }
 
-        result_so_far.product->state = std::move(r.product->state);
+        m_result.product->state = std::move(r.product->state);
 
         auto &new_token = std::get<0>(r.product->value);
         switch (new_token.tag()) {
         case token::tag<word>():
-            result_so_far.product->value.words.push_back(
+            m_result.product->value.words.push_back(
                     std::move(new_token.value<word>()));
-            return parse_tokens(std::move(result_so_far));
+            start();
+            return;
         }
         UNREACHABLE();
     }
 
-}; // class token_acceptor
-
-future<result<simple_command>> parse_tokens(result<simple_command> &&r) {
-    if (!r.product)
-        return make_future_of(std::move(r));
-
-    auto types = acceptable_token_types(r.product->value);
-    auto r2 = parse_token_and_skip_whitespaces(types, r.product->state);
-    return std::move(r2).map(token_acceptor{std::move(r)}).unwrap();
-}
+}; // class token_parser
 
 future<result<simple_command_parse>> accept_nonempty_command(
         result<simple_command> &&from) {
@@ -127,10 +143,7 @@ future<result<simple_command_parse>> accept_nonempty_command(
 }
 
 future<result<simple_command_parse>> parse_simple_command(const state &s) {
-    auto r = parse_tokens(result<simple_command>(
-                product<simple_command>{simple_command(), s},
-                std::vector<report>()));
-    return std::move(r).map(accept_nonempty_command).unwrap();
+    return start_task<token_parser>(s).map(accept_nonempty_command).unwrap();
 }
 
 } // namespace parsing
@@ -0,0 +1,171 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "synchronous.hh"
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "common/arena.hh"
+#include "common/either.hh"
+#include "common/empty.hh"
+#include "common/visitor.hh"
+#include "language/parsing/cursor.hh"
+#include "language/parsing/fused/grammar.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/sequence.hh"
+#include "language/source/location.hh"
+#include "language/syntax/and_or_list.hh"
+#include "language/syntax/command.hh"
+#include "language/syntax/pipeline.hh"
+#include "language/syntax/raw_string.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/simple_command.hh"
+#include "language/syntax/word.hh"
+#include "language/syntax/word_component.hh"
+#include "ui/message/category.hh"
+#include "ui/message/format.hh"
+#include "ui/message/report.hh"
+
+namespace {
+
+using sesh::common::arena;
+using sesh::common::arena_allocator;
+using sesh::common::empty;
+using sesh::common::make_shared_in;
+using sesh::common::make_shared_with;
+using sesh::common::maybe;
+using sesh::common::visitable_value;
+using sesh::language::parsing::context;
+using sesh::language::parsing::cursor;
+using sesh::language::parsing::product;
+using sesh::language::parsing::result;
+using sesh::language::parsing::sequence_parse;
+using sesh::language::parsing::state;
+using sesh::language::parsing::stream_not_ready;
+using sesh::language::source::location_of;
+using sesh::language::syntax::and_or_list;
+using sesh::language::syntax::command;
+using sesh::language::syntax::command_visitor;
+using sesh::language::syntax::pipeline;
+using sesh::language::syntax::raw_string;
+using sesh::language::syntax::sequence;
+using sesh::language::syntax::simple_command;
+using sesh::language::syntax::word;
+using sesh::language::syntax::word_component_visitor;
+using sesh::ui::message::category;
+using sesh::ui::message::format;
+using sesh::ui::message::report;
+
+namespace fused = sesh::language::parsing::fused;
+
+/**
+ * Parser functions below correspond to the asynchronous parsers of the same
+ * names. They are built on the fused parsers, which advance the cursor only
+ * if they succeed.
+ *
+ * The word components and the vectors of the syntax tree are built in an
+ * arena. The commands are allocated beside the arena, so that they can
+ * contain the component pointers, which own the arena, without forming an
+ * ownership cycle.
+ */
+class synchronous_parser {
+
+private:
+
+    const context &m_context;
+    std::shared_ptr<arena> m_arena = std::make_shared<arena>();
+
+    template<typename T>
+    arena_allocator<T> allocator() const noexcept {
+        return arena_allocator<T>(m_arena.get());
+    }
+
+    word parse_word(cursor &c) {
+        using component = visitable_value<word_component_visitor, raw_string>;
+        word w{word::component_list(allocator<word::component_pointer>())};
+        for (raw_string rs; fused::raw_string()(c, m_context, rs); ) {
+            w.components.push_back(
+                    make_shared_in<component>(m_arena, std::move(rs)));
+            rs = raw_string();
+        }
+        return w;
+    }
+
+    void skip_whitespaces(cursor &c) {
+        empty e;
+        fused::whitespaces()(c, m_context, e);
+    }
+
+public:
+
+    explicit synchronous_parser(const context &c) noexcept : m_context(c) { }
+
+    result<sequence_parse> parse_sequence(cursor &c) {
+        simple_command sc{simple_command::word_list(allocator<word>())};
+        for (;;) {
+            word w = parse_word(c);
+            if (w.components.empty())
+                break;
+            skip_whitespaces(c);
+            sc.words.push_back(std::move(w));
+        }
+
+        if (sc.empty()) {
+            std::vector<report> reports;
+            reports.emplace_back(
+                    category::error,
+                    format<>(L("empty command")),
+                    location_of(c.position()));
+            return result<sequence_parse>(empty(), std::move(reports));
+        }
+
+        pipeline p(pipeline::exit_status_mode_type::straight);
+        using simple = visitable_value<command_visitor, simple_command>;
+        p.commands.push_back(
+                make_shared_with<simple>(m_arena, std::move(sc)));
+        and_or_list aol;
+        aol.first = std::move(p);
+        sequence s;
+        s.and_or_lists.push_back(std::move(aol));
+        return product<sequence_parse>{
+                std::move(s), state{c.to_stream(), m_context}};
+    }
+
+}; // class synchronous_parser
+
+} // namespace
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+maybe<result<sequence_parse>> parse_sequence_synchronously(const state &s) {
+    try {
+        cursor c(s.rest);
+        return synchronous_parser(s.context).parse_sequence(c);
+    } catch (stream_not_ready &) {
+        return maybe<result<sequence_parse>>();
+    }
+}
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,57 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_synchronous_hh
+#define INCLUDED_language_parsing_synchronous_hh
+
+#include "buildconfig.h"
+
+#include "common/either.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/sequence.hh"
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+/**
+ * Parses a sequence without going through futures. The grammar is the same as
+ * {@link parse_sequence}: this function returns the same result and reads the
+ * same characters from the stream as the asynchronous parser would do.
+ *
+ * This function is useful when the whole source code is already in memory.
+ * The characters are read directly from the chunks of the stream, so no future
+ * or stream node is created during parsing. The word components of the syntax
+ * tree and the vectors in it are allocated in an arena. The arena is owned by
+ * the command and word component pointers in the resultant sequence, so any
+ * of them may outlive the others.
+ *
+ * If the stream needs a chunk that is not yet available (that is, the shared
+ * future of the chunk has no result yet) or whose computation failed, this
+ * function gives up and returns an empty maybe. The caller should then parse
+ * the state with the asynchronous parser instead.
+ */
+common::maybe<result<sequence_parse>> parse_sequence_synchronously(
+        const state &);
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_synchronous_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,224 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <memory>
+#include <utility>
+#include "async/future.hh"
+#include "async/future_test_helper.hh"
+#include "async/promise.hh"
+#include "catch.hpp"
+#include "common/visitor.hh"
+#include "common/visitor_test_helper.hh"
+#include "common/xchar.hh"
+#include "language/parsing/parser.hh"
+#include "language/parsing/parser_test_helper.hh"
+#include "language/parsing/sequence.hh"
+#include "language/parsing/synchronous.hh"
+#include "language/source/fragment.hh"
+#include "language/source/stream.hh"
+#include "language/syntax/raw_string.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/sequence_test_helper.hh"
+#include "language/syntax/simple_command.hh"
+#include "language/syntax/word.hh"
+#include "ui/message/category.hh"
+
+namespace {
+
+using sesh::async::future;
+using sesh::async::make_future_of;
+using sesh::async::make_promise_future_pair;
+using sesh::common::make_checking_visitor;
+using sesh::language::parsing::check_parser_no_excess;
+using sesh::language::parsing::check_parser_single_report;
+using sesh::language::parsing::check_parser_success_rest;
+using sesh::language::parsing::check_parser_success_result;
+using sesh::language::parsing::default_context_stub;
+using sesh::language::parsing::parse_sequence;
+using sesh::language::parsing::parse_sequence_synchronously;
+using sesh::language::parsing::result;
+using sesh::language::parsing::sequence_parse;
+using sesh::language::parsing::state;
+using sesh::language::parsing::stream_stub;
+using sesh::language::source::empty_stream;
+using sesh::language::source::fragment;
+using sesh::language::source::fragment_position;
+using sesh::language::source::stream;
+using sesh::language::source::stream_chunk;
+using sesh::language::source::stream_chunk_future;
+using sesh::language::source::stream_node;
+using sesh::language::syntax::expect_raw_string_sequence;
+using sesh::language::syntax::raw_string;
+using sesh::language::syntax::sequence;
+using sesh::language::syntax::simple_command;
+using sesh::language::syntax::word;
+using sesh::ui::message::category;
+
+future<result<sequence_parse>> parse_synchronously(const state &s) {
+    auto r = parse_sequence_synchronously(s);
+    REQUIRE(r);
+    return make_future_of(std::move(*r));
+}
+
+void check_words(
+        const sequence_parse &sp,
+        std::initializer_list<sesh::common::xstring> words) {
+    REQUIRE(sp.tag() == sp.tag<sequence>());
+    expect_raw_string_sequence(sp.value<sequence>(), words);
+}
+
+TEST_CASE("Synchronous parser parses words") {
+    check_parser_success_result(
+            parse_synchronously,
+            L("ec\\\nho  a\\\n\tb # comment"),
+            [](const sequence_parse &sp) {
+                check_words(sp, {L("echo"), L("a"), L("b")});
+            });
+}
+
+TEST_CASE("Synchronous parser skips parsed words") {
+    check_parser_success_rest(
+            parse_synchronously, L("a \\\n b # c"), L("\n;"));
+}
+
+TEST_CASE("Synchronous parser does not read too much") {
+    check_parser_no_excess(parse_synchronously, L("a b # c\n"));
+}
+
+TEST_CASE("Synchronous parser reports empty command as error") {
+    check_parser_single_report(
+            category::error,
+            L("empty command"),
+            parse_synchronously,
+            {},
+            L(";"));
+}
+
+TEST_CASE("Synchronous parser reads words across fragments") {
+    const state s{
+            stream_stub(L("a\\"), stream_stub(L("\nb c"))),
+            default_context_stub()};
+    expect_result(
+            parse_synchronously(s),
+            [](const result<sequence_parse> &r) {
+                REQUIRE(r.product);
+                check_words(r.product->value, {L("ab"), L("c")});
+            });
+}
+
+TEST_CASE("Synchronous parser reads long words in runs") {
+    const state s{
+            stream_stub(
+                    L("/usr/local/share/sesh"),
+                    stream_stub(L("/\u00E9t\u00E9-\\\nx y;"))),
+            default_context_stub()};
+    expect_result(
+            parse_synchronously(s),
+            [](const result<sequence_parse> &r) {
+                REQUIRE(r.product);
+                check_words(
+                        r.product->value,
+                        {L("/usr/local/share/sesh/\u00E9t\u00E9-x"),
+                                L("y")});
+            });
+}
+
+TEST_CASE("Synchronous parser allocates syntax tree in arena") {
+    const state s{stream_stub(L("a b")), default_context_stub()};
+    auto r = parse_sequence_synchronously(s);
+    REQUIRE(r);
+    REQUIRE(r->product);
+    const sequence_parse &sp = r->product->value;
+    REQUIRE(sp.tag() == sp.tag<sequence>());
+    const auto &commands =
+            sp.value<sequence>().and_or_lists.at(0).first.commands;
+    REQUIRE(commands.size() == 1);
+
+    bool checked = false;
+    const auto check = [&checked](const simple_command &sc) {
+        auto a = sc.words.get_allocator().arena();
+        CHECK(a != nullptr);
+        REQUIRE(sc.words.size() == 2);
+        CHECK(sc.words[0].components.get_allocator().arena() == a);
+        checked = true;
+    };
+    visit(*commands[0], make_checking_visitor<simple_command>(check));
+    CHECK(checked);
+}
+
+TEST_CASE("Synchronous parser: word component outlives syntax tree") {
+    word::component_pointer component;
+    {
+        const state s{stream_stub(L("abc")), default_context_stub()};
+        auto r = parse_sequence_synchronously(s);
+        REQUIRE(r);
+        REQUIRE(r->product);
+        const sequence_parse &sp = r->product->value;
+        REQUIRE(sp.tag() == sp.tag<sequence>());
+        const auto &commands =
+                sp.value<sequence>().and_or_lists.at(0).first.commands;
+        REQUIRE(commands.size() == 1);
+
+        const auto copy = [&component](const simple_command &sc) {
+            REQUIRE(sc.words.size() == 1);
+            REQUIRE(sc.words[0].components.size() == 1);
+            component = sc.words[0].components[0];
+        };
+        visit(*commands[0], make_checking_visitor<simple_command>(copy));
+    }
+
+    bool checked = false;
+    const auto check = [&checked](const raw_string &rs) {
+        CHECK(rs.value == L("abc"));
+        checked = true;
+    };
+    REQUIRE(component != nullptr);
+    visit(*component, make_checking_visitor<raw_string>(check));
+    CHECK(checked);
+}
+
+TEST_CASE("Synchronous parser gives up on stream that is not ready") {
+    auto pf = make_promise_future_pair<stream_chunk>();
+    const state s{
+            stream(stream_node(static_cast<stream_chunk_future>(
+                    std::move(pf.second)))),
+            default_context_stub()};
+    CHECK_FALSE(parse_sequence_synchronously(s));
+
+    bool called = false;
+    expect_result(
+            parse_sequence(s),
+            [&called](const result<sequence_parse> &r) {
+                REQUIRE(r.product);
+                check_words(r.product->value, {L("echo")});
+                called = true;
+            });
+    CHECK_FALSE(called);
+
+    stream_chunk c;
+    c.begin = fragment_position(std::make_shared<fragment>(L("echo")));
+    c.length = 4;
+    c.rest = empty_stream();
+    std::move(pf.first).set_result(std::move(c));
+    CHECK(called);
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
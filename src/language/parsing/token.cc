@@ -23,6 +23,7 @@
 #include "common/empty.hh"
 #include "common/type_tag.hh"
 #include "common/type_tag_set.hh"
+#include "language/parsing/char_class.hh"
 #include "language/parsing/char_predicate.hh"
 #include "language/parsing/mapper.hh"
 #include "language/parsing/word.hh"
@@ -54,7 +55,7 @@ result<token> token_from_word(result<word> &&wr) {
 future<result<token>> parse_token(token_type_set types, const state &s) {
     if (!types[type_tag<word>()])
         return make_future<result<token>>();
-    return parse_word(is_token_char, s).map(token_from_word);
+    return parse_word(none_of(token_delimiters), s).map(token_from_word);
 }
 
 } // namespace parsing
@@ -0,0 +1,155 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "token_run.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "common/xchar.hh"
+
+#if defined __AVX2__ || defined __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using sesh::common::xchar;
+
+/**
+ * Characters in the printable ASCII range that are not plain token
+ * characters. Must match the delimiters and special characters in the table
+ * in char_class.cc.
+ */
+constexpr char non_plain_chars[] = {
+    ';', '&', '|', '<', '>', '(', ')', '"', '$', '\'', '\\', '`',
+};
+
+constexpr std::size_t non_plain_char_count =
+        sizeof non_plain_chars / sizeof *non_plain_chars;
+
+#if defined __AVX2__ || defined __SSE2__
+
+/** Returns the index of the lowest set bit of the non-zero argument. */
+std::size_t lowest_bit_index(unsigned mask) noexcept {
+    std::size_t i = 0;
+    while ((mask & 1u) == 0)
+        mask >>= 1, ++i;
+    return i;
+}
+
+#endif // #if defined __AVX2__ || defined __SSE2__
+
+#if defined __AVX2__
+
+constexpr std::size_t vector_width = 32;
+
+/**
+ * Returns a bit mask of the characters that are not plain token characters
+ * among the 32 characters at the argument address.
+ *
+ * The characters are narrowed to bytes with saturation, so characters
+ * outside the ASCII range become 0x00 or 0xFF and never look plain.
+ */
+unsigned non_plain_mask(const xchar *p) noexcept {
+    auto q = reinterpret_cast<const __m256i *>(p);
+    __m256i words1 = _mm256_packs_epi32(
+            _mm256_loadu_si256(q), _mm256_loadu_si256(q + 1));
+    __m256i words2 = _mm256_packs_epi32(
+            _mm256_loadu_si256(q + 2), _mm256_loadu_si256(q + 3));
+    // Packing works within each 128-bit lane, so restore the order.
+    __m256i x = _mm256_permutevar8x32_epi32(
+            _mm256_packus_epi16(words1, words2),
+            _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+
+    __m256i plain = _mm256_and_si256(
+            _mm256_cmpgt_epi8(x, _mm256_set1_epi8(0x20)),
+            _mm256_cmpgt_epi8(_mm256_set1_epi8(0x7F), x));
+    for (char c : non_plain_chars)
+        plain = _mm256_andnot_si256(
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8(c)), plain);
+    return ~static_cast<unsigned>(_mm256_movemask_epi8(plain));
+}
+
+#elif defined __SSE2__
+
+constexpr std::size_t vector_width = 16;
+
+/**
+ * Returns a bit mask of the characters that are not plain token characters
+ * among the 16 characters at the argument address.
+ *
+ * The characters are narrowed to bytes with saturation, so characters
+ * outside the ASCII range become 0x00 or 0xFF and never look plain.
+ */
+unsigned non_plain_mask(const xchar *p) noexcept {
+    auto q = reinterpret_cast<const __m128i *>(p);
+    __m128i words1 = _mm_packs_epi32(
+            _mm_loadu_si128(q), _mm_loadu_si128(q + 1));
+    __m128i words2 = _mm_packs_epi32(
+            _mm_loadu_si128(q + 2), _mm_loadu_si128(q + 3));
+    __m128i x = _mm_packus_epi16(words1, words2);
+
+    __m128i plain = _mm_and_si128(
+            _mm_cmpgt_epi8(x, _mm_set1_epi8(0x20)),
+            _mm_cmplt_epi8(x, _mm_set1_epi8(0x7F)));
+    for (char c : non_plain_chars)
+        plain = _mm_andnot_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(c)), plain);
+    return ~static_cast<unsigned>(_mm_movemask_epi8(plain)) & 0xFFFFu;
+}
+
+#endif // #if defined __AVX2__
+
+} // namespace
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+bool is_plain_token_char(xchar x) noexcept {
+    if (x <= L(' ') || x >= 0x7F)
+        return false;
+    auto c = static_cast<char>(x);
+    return std::memchr(non_plain_chars, c, non_plain_char_count) == nullptr;
+}
+
+std::size_t count_plain_token_chars(const xchar *begin, const xchar *end)
+        noexcept {
+    const xchar *p = begin;
+#if defined __AVX2__ || defined __SSE2__
+    // The vector code compares 32-bit lanes.
+    if (sizeof(xchar) == sizeof(std::int32_t)) {
+        for (; end - p >= static_cast<std::ptrdiff_t>(vector_width);
+                p += vector_width) {
+            unsigned mask = non_plain_mask(p);
+            if (mask != 0)
+                return static_cast<std::size_t>(p - begin) +
+                        lowest_bit_index(mask);
+        }
+    }
+#endif // #if defined __AVX2__ || defined __SSE2__
+    while (p != end && is_plain_token_char(*p))
+        ++p;
+    return static_cast<std::size_t>(p - begin);
+}
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,54 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_parsing_token_run_hh
+#define INCLUDED_language_parsing_token_run_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include "common/xchar.hh"
+
+namespace sesh {
+namespace language {
+namespace parsing {
+
+/**
+ * Returns whether the argument is a plain token character, that is, a
+ * printable ASCII character other than the delimiters of {@link
+ * is_token_char} and the characters that start word components other than
+ * raw strings (<code>"$'\`</code>). Plain token characters are part of a raw
+ * string in every locale, so a run of them can be consumed at once without
+ * testing each character with a locale-dependent predicate.
+ */
+bool is_plain_token_char(common::xchar) noexcept;
+
+/**
+ * Returns the number of plain token characters at the beginning of the
+ * argument range. The range is scanned 16 or 32 characters at a time with
+ * SSE2 or AVX2 instructions if the compiler targets them.
+ */
+std::size_t count_plain_token_chars(
+        const common::xchar *begin, const common::xchar *end) noexcept;
+
+} // namespace parsing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_parsing_token_run_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
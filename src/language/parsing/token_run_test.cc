@@ -0,0 +1,76 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include "catch.hpp"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/parsing/token_run.hh"
+
+namespace {
+
+using sesh::common::xchar;
+using sesh::common::xstring;
+using sesh::language::parsing::count_plain_token_chars;
+using sesh::language::parsing::is_plain_token_char;
+
+std::size_t count(const xstring &s) {
+    return count_plain_token_chars(s.data(), s.data() + s.size());
+}
+
+TEST_CASE("Plain token characters") {
+    CHECK(is_plain_token_char(L('a')));
+    CHECK(is_plain_token_char(L('/')));
+    CHECK(is_plain_token_char(L('#')));
+    CHECK(is_plain_token_char(L('~')));
+    CHECK(is_plain_token_char(L('!')));
+}
+
+TEST_CASE("Non-plain token characters") {
+    for (xchar c : xstring(L(" \t\n;&|<>()\"$'\\`")))
+        CHECK_FALSE(is_plain_token_char(c));
+    CHECK_FALSE(is_plain_token_char(L('\0')));
+    CHECK_FALSE(is_plain_token_char(L('\x7F')));
+    CHECK_FALSE(is_plain_token_char(L('\u00E9')));
+    CHECK_FALSE(is_plain_token_char(L('\u3000')));
+}
+
+TEST_CASE("Counting plain token characters in empty range") {
+    CHECK(count(xstring()) == 0);
+}
+
+TEST_CASE("Counting plain token characters up to end of range") {
+    CHECK(count(L("abc")) == 3);
+    CHECK(count(L("https://example.com/index.html?q=1")) == 34);
+}
+
+TEST_CASE("Counting plain token characters stops at non-plain ones") {
+    const xstring plain = L("0123456789abcdefghijklmnopqrstuvwxyz");
+    const xstring non_plain = L(" \t\n;&|<>()\"$'\\`\u00E9");
+    for (std::size_t i = 0; i <= plain.size(); ++i) {
+        for (xchar c : non_plain) {
+            xstring s = plain.substr(0, i) + c + plain;
+            CHECK(count(s) == i);
+        }
+    }
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
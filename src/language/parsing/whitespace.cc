@@ -24,6 +24,7 @@
 #include "common/constant_function.hh"
 #include "common/empty.hh"
 #include "language/parsing/blackhole.hh"
+#include "language/parsing/char_class.hh"
 #include "language/parsing/char_predicate.hh"
 #include "language/parsing/comment.hh"
 #include "language/parsing/joiner.hh"
@@ -49,7 +50,10 @@ namespace {
 future<result<blackhole>> skip_blanks(const state &s) {
     using std::placeholders::_1;
     return repeat(
-            std::bind(test_char_after_line_continuations, is_blank, _1),
+            std::bind(
+                    test_char_after_line_continuations,
+                    any_of(char_class::blank),
+                    _1),
             s,
             blackhole());
 }
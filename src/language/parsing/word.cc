@@ -20,7 +20,6 @@
 
 #include <functional>
 #include <utility>
-#include <vector>
 #include "async/future.hh"
 #include "language/parsing/mapper.hh"
 #include "language/parsing/repeat.hh"
@@ -37,16 +36,17 @@ namespace {
 using sesh::async::future;
 using sesh::language::syntax::word;
 
-word to_word(std::vector<word_component_pointer> &&wcps) {
+word to_word(word::component_list &&wcps) {
     return {std::move(wcps)};
 }
 
 }
 
 future<result<word>> parse_word(
-        const std::function<char_predicate> &p, const state &s) {
+        const char_test &p, const state &s) {
     using std::placeholders::_1;
-    auto r = repeat(std::bind(parse_word_component, p, _1), s);
+    auto r = repeat(
+            std::bind(parse_word_component, p, _1), s, word::component_list());
     return map_value(std::move(r), to_word);
 }
 
@@ -39,7 +39,7 @@ namespace parsing {
  * returned. The parser fails with some error report if a syntax error is
  * found.
  */
-extern auto parse_word(const std::function<char_predicate> &, const state &)
+extern auto parse_word(const char_test &, const state &)
         -> async::future<result<syntax::word>>;
 
 } // namespace parsing
@@ -18,12 +18,11 @@
 #include "buildconfig.h"
 #include "word_component.hh"
 
-#include <functional>
 #include <memory>
 #include <utility>
 #include "async/future.hh"
-#include "common/xchar.hh"
-#include "common/xstring.hh"
+#include "language/parsing/char_class.hh"
+#include "language/parsing/char_predicate.hh"
 #include "language/parsing/mapper.hh"
 #include "language/parsing/raw_string.hh"
 #include "language/syntax/raw_string.hh"
@@ -32,10 +31,7 @@
 namespace {
 
 using sesh::async::future;
-using sesh::common::contains;
 using sesh::common::make_shared_visitable;
-using sesh::common::xchar;
-using sesh::common::xstring;
 using sesh::language::syntax::raw_string;
 using sesh::language::syntax::word_component;
 
@@ -47,8 +43,6 @@ namespace parsing {
 
 namespace {
 
-const xstring special_chars = L("\"$'\\`");
-
 template<typename T>
 word_component_pointer to_word_component_pointer(T &&t) {
     return make_shared_visitable<word_component>(std::move(t));
@@ -57,15 +51,11 @@ word_component_pointer to_word_component_pointer(T &&t) {
 }
 
 future<result<word_component_pointer>> parse_word_component(
-        const std::function<char_predicate> &p, const state &s) {
+        const char_test &p, const state &s) {
     // TODO support word component types other than raw string
-
-    std::function<char_predicate> p2 = [p](xchar x, const context &c) {
-        return !contains(special_chars, x) && p(x, c);
-    };
-
     return map_value(
-            parse_raw_string(p2, s), &to_word_component_pointer<raw_string>);
+            parse_raw_string(p.excluding(char_class::special), s),
+            &to_word_component_pointer<raw_string>);
 }
 
 } // namespace parsing
@@ -20,7 +20,6 @@
 
 #include "buildconfig.h"
 
-#include <functional>
 #include <memory>
 #include "async/future.hh"
 #include "language/parsing/char_predicate.hh"
@@ -44,7 +43,7 @@ using word_component_pointer = std::shared_ptr<const syntax::word_component>;
  *
  * If successful, the resultant word component pointer is never null.
  */
-auto parse_word_component(const std::function<char_predicate> &, const state &)
+auto parse_word_component(const char_test &, const state &)
         -> async::future<result<word_component_pointer>>;
 
 } // namespace parsing
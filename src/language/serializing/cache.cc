@@ -0,0 +1,152 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "cache.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/either.hh"
+#include "language/serializing/decoding.hh"
+#include "language/serializing/encoding.hh"
+#include "language/syntax/sequence.hh"
+#include "os/io/mapped_file_api.hh"
+#include "os/time_api.hh"
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::language::serializing::cache_key;
+using sesh::language::serializing::decode_unsigned;
+using sesh::language::serializing::encode_unsigned;
+using sesh::language::serializing::format_version;
+using sesh::language::syntax::sequence;
+using sesh::os::io::mapped_file;
+using sesh::os::time_api;
+
+/** The first bytes of every cache entry. */
+constexpr char magic[] = {'\x7F', 's', 'e', 's', 'h', 'a', 's', 't'};
+
+void encode_key(const cache_key &key, std::vector<char> &bytes) {
+    encode_unsigned(key.path.size(), bytes);
+    bytes.insert(bytes.end(), key.path.begin(), key.path.end());
+    encode_unsigned(
+            static_cast<std::uint64_t>(
+                    key.modification_time.time_since_epoch().count()),
+            bytes);
+    encode_unsigned(key.content_hash, bytes);
+}
+
+maybe<cache_key> decode_key(const char *&begin, const char *end) {
+    const char *p = begin;
+    maybe<std::uint64_t> path_size = decode_unsigned(p, end);
+    if (!path_size || *path_size > static_cast<std::uint64_t>(end - p))
+        return maybe<cache_key>();
+
+    cache_key key;
+    key.path.assign(p, static_cast<std::size_t>(*path_size));
+    p += *path_size;
+
+    maybe<std::uint64_t> time = decode_unsigned(p, end);
+    if (!time)
+        return maybe<cache_key>();
+    key.modification_time = time_api::system_clock_time(
+            std::chrono::nanoseconds(static_cast<std::int64_t>(*time)));
+
+    maybe<std::uint64_t> hash = decode_unsigned(p, end);
+    if (!hash)
+        return maybe<cache_key>();
+    key.content_hash = *hash;
+
+    begin = p;
+    return key;
+}
+
+} // namespace
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+bool operator==(const cache_key &l, const cache_key &r) noexcept {
+    return l.content_hash == r.content_hash &&
+            l.modification_time == r.modification_time &&
+            l.path == r.path;
+}
+
+bool operator!=(const cache_key &l, const cache_key &r) noexcept {
+    return !(l == r);
+}
+
+std::uint64_t hash_content(const char *bytes, std::size_t size) noexcept {
+    std::uint64_t hash = UINT64_C(0xCBF29CE484222325);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= UINT64_C(0x100000001B3);
+    }
+    return hash;
+}
+
+cache_key make_cache_key(std::string path, const mapped_file &f) {
+    return cache_key{
+            std::move(path),
+            f.modification_time(),
+            hash_content(f.data(), f.size())};
+}
+
+std::vector<char> make_cache_entry(const cache_key &key, const sequence &s) {
+    std::vector<char> bytes(std::begin(magic), std::end(magic));
+    bytes.push_back(static_cast<char>(format_version));
+    encode_key(key, bytes);
+    encode_sequence(s, bytes);
+    return bytes;
+}
+
+maybe<sequence> load_cache_entry(
+        const cache_key &key, const char *bytes, std::size_t size) {
+    const char *end = bytes + size;
+    if (size <= sizeof magic || std::memcmp(bytes, magic, sizeof magic) != 0)
+        return maybe<sequence>();
+    bytes += sizeof magic;
+    if (static_cast<unsigned char>(*bytes++) != format_version)
+        return maybe<sequence>();
+
+    maybe<cache_key> stored_key = decode_key(bytes, end);
+    if (!stored_key || *stored_key != key)
+        return maybe<sequence>();
+
+    maybe<sequence> s = decode_sequence(bytes, end);
+    if (bytes != end)
+        return maybe<sequence>();
+    return s;
+}
+
+maybe<sequence> load_cache_entry(const cache_key &key, const mapped_file &f) {
+    return load_cache_entry(key, f.data(), f.size());
+}
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,92 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_serializing_cache_hh
+#define INCLUDED_language_serializing_cache_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "common/either.hh"
+#include "language/syntax/sequence.hh"
+#include "os/io/mapped_file_api.hh"
+#include "os/time_api.hh"
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+/**
+ * A cache key identifies the version of a script file from which a cached
+ * syntax tree was parsed. A cache entry is used only if all the members match
+ * those of the current file.
+ */
+class cache_key {
+
+public:
+
+    /** Path name of the script file. */
+    std::string path;
+
+    /** Last modification time of the script file. */
+    os::time_api::system_clock_time modification_time;
+
+    /** Hash of the script file contents computed by {@link hash_content}. */
+    std::uint64_t content_hash;
+
+}; // class cache_key
+
+bool operator==(const cache_key &, const cache_key &) noexcept;
+bool operator!=(const cache_key &, const cache_key &) noexcept;
+
+/** Computes the 64-bit FNV-1a hash of the bytes. */
+std::uint64_t hash_content(const char *, std::size_t) noexcept;
+
+/** Computes the cache key for the script file that has been mapped. */
+cache_key make_cache_key(std::string path, const os::io::mapped_file &);
+
+/**
+ * Returns the bytes of a cache entry that contains the key and the syntax
+ * tree parsed from the script file identified by the key. The bytes should
+ * be written to a cache file to be loaded later.
+ */
+std::vector<char> make_cache_entry(
+        const cache_key &, const syntax::sequence &);
+
+/**
+ * Loads the syntax tree from the bytes of a cache entry. Returns an empty
+ * maybe if the bytes are not a valid cache entry of the current format
+ * version or the key in the entry does not match the argument key, in which
+ * case the script should be parsed again.
+ */
+common::maybe<syntax::sequence> load_cache_entry(
+        const cache_key &, const char *, std::size_t);
+
+/** Loads the syntax tree from a cache file that has been mapped. */
+common::maybe<syntax::sequence> load_cache_entry(
+        const cache_key &, const os::io::mapped_file &);
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_serializing_cache_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,144 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "language/serializing/cache.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/sequence_test_helper.hh"
+#include "os/io/mapped_file_api.hh"
+#include "os/time_api.hh"
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::language::serializing::cache_key;
+using sesh::language::serializing::hash_content;
+using sesh::language::serializing::load_cache_entry;
+using sesh::language::serializing::make_cache_entry;
+using sesh::language::serializing::make_cache_key;
+using sesh::language::syntax::expect_raw_string_sequence;
+using sesh::language::syntax::make_sequence_stub;
+using sesh::language::syntax::sequence;
+using sesh::os::io::mapped_file;
+using sesh::os::time_api;
+
+class mapped_file_stub : public mapped_file {
+
+public:
+
+    std::string contents;
+    time_api::system_clock_time time;
+
+    const char *data() const noexcept override { return contents.data(); }
+    std::size_t size() const noexcept override { return contents.size(); }
+
+    time_api::system_clock_time modification_time() const noexcept
+            override {
+        return time;
+    }
+
+}; // class mapped_file_stub
+
+cache_key make_key() {
+    return cache_key{
+            "/home/user/.seshrc",
+            time_api::system_clock_time(std::chrono::seconds(1420070400)),
+            0x0123456789ABCDEF};
+}
+
+TEST_CASE("Content hash is FNV-1a") {
+    CHECK(hash_content("", 0) == UINT64_C(0xCBF29CE484222325));
+    CHECK(hash_content("a", 1) == UINT64_C(0xAF63DC4C8601EC8C));
+    CHECK(hash_content("foobar", 6) == UINT64_C(0x85944171F73967E8));
+}
+
+TEST_CASE("Cache key is made from mapped script file") {
+    mapped_file_stub f;
+    f.contents = "echo foo";
+    f.time = time_api::system_clock_time(std::chrono::nanoseconds(123));
+
+    cache_key key = make_cache_key("script", f);
+    CHECK(key.path == "script");
+    CHECK(key.modification_time == f.time);
+    CHECK(key.content_hash == hash_content("echo foo", 8));
+}
+
+TEST_CASE("Cache entry is loaded with same key") {
+    mapped_file_stub f;
+    std::vector<char> entry =
+            make_cache_entry(make_key(), make_sequence_stub(L("echo")));
+    f.contents.assign(entry.begin(), entry.end());
+
+    maybe<sequence> s = load_cache_entry(make_key(), f);
+    REQUIRE(s);
+    expect_raw_string_sequence(*s, {L("echo")});
+}
+
+TEST_CASE("Cache entry is not loaded with different key") {
+    std::vector<char> entry =
+            make_cache_entry(make_key(), make_sequence_stub(L("echo")));
+
+    cache_key key = make_key();
+    key.path += 'x';
+    CHECK_FALSE(load_cache_entry(key, entry.data(), entry.size()));
+
+    key = make_key();
+    key.modification_time += std::chrono::nanoseconds(1);
+    CHECK_FALSE(load_cache_entry(key, entry.data(), entry.size()));
+
+    key = make_key();
+    key.content_hash ^= 1;
+    CHECK_FALSE(load_cache_entry(key, entry.data(), entry.size()));
+}
+
+TEST_CASE("Cache entry of other format version is not loaded") {
+    std::vector<char> entry =
+            make_cache_entry(make_key(), make_sequence_stub(L("echo")));
+    ++entry[8];
+    CHECK_FALSE(load_cache_entry(make_key(), entry.data(), entry.size()));
+}
+
+TEST_CASE("Broken cache entry is not loaded") {
+    std::vector<char> entry =
+            make_cache_entry(make_key(), make_sequence_stub(L("echo")));
+
+    CHECK_FALSE(load_cache_entry(make_key(), entry.data(), 0));
+    CHECK_FALSE(load_cache_entry(
+            make_key(), entry.data(), entry.size() - 1));
+
+    entry[0] = 'S';
+    CHECK_FALSE(load_cache_entry(make_key(), entry.data(), entry.size()));
+}
+
+TEST_CASE("Cache entry with trailing bytes is not loaded") {
+    std::vector<char> entry =
+            make_cache_entry(make_key(), make_sequence_stub(L("echo")));
+    entry.push_back('\0');
+    CHECK_FALSE(load_cache_entry(make_key(), entry.data(), entry.size()));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,244 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "decoding.hh"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "common/arena.hh"
+#include "common/either.hh"
+#include "common/visitor.hh"
+#include "common/xchar.hh"
+#include "language/serializing/tag.hh"
+#include "language/syntax/and_or_list.hh"
+#include "language/syntax/command.hh"
+#include "language/syntax/conditional_pipeline.hh"
+#include "language/syntax/pipeline.hh"
+#include "language/syntax/raw_string.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/simple_command.hh"
+#include "language/syntax/word.hh"
+#include "language/syntax/word_component.hh"
+
+namespace {
+
+using sesh::common::arena;
+using sesh::common::arena_allocator;
+using sesh::common::make_shared_in;
+using sesh::common::make_shared_with;
+using sesh::common::maybe;
+using sesh::common::visitable_value;
+using sesh::common::xchar;
+using sesh::language::serializing::decode_unsigned;
+using sesh::language::serializing::tag;
+using sesh::language::syntax::and_or_list;
+using sesh::language::syntax::command_visitor;
+using sesh::language::syntax::conditional_pipeline;
+using sesh::language::syntax::pipeline;
+using sesh::language::syntax::raw_string;
+using sesh::language::syntax::sequence;
+using sesh::language::syntax::simple_command;
+using sesh::language::syntax::word;
+using sesh::language::syntax::word_component_visitor;
+
+/** Thrown by the decoder when the bytes are malformed. */
+class malformed_bytes { };
+
+class decoder {
+
+private:
+
+    const char *&m_position;
+    const char *const m_end;
+    std::shared_ptr<arena> m_arena = std::make_shared<arena>();
+
+    template<typename T>
+    arena_allocator<T> allocator() const noexcept {
+        return arena_allocator<T>(m_arena.get());
+    }
+
+    std::uint64_t decode_number() {
+        maybe<std::uint64_t> n = decode_unsigned(m_position, m_end);
+        if (!n)
+            throw malformed_bytes();
+        return *n;
+    }
+
+    /**
+     * Decodes the number of elements of a vector. Every element occupies at
+     * least one byte, so a count larger than the remaining bytes is rejected
+     * before any memory is reserved.
+     */
+    std::size_t decode_count() {
+        std::uint64_t n = decode_number();
+        if (n > static_cast<std::uint64_t>(m_end - m_position))
+            throw malformed_bytes();
+        return static_cast<std::size_t>(n);
+    }
+
+    tag decode_tag() {
+        if (m_position == m_end)
+            throw malformed_bytes();
+        return static_cast<tag>(*m_position++);
+    }
+
+    raw_string decode_raw_string() {
+        using unsigned_xchar = std::make_unsigned<xchar>::type;
+        raw_string rs;
+        rs.value.resize(decode_count());
+        for (xchar &c : rs.value) {
+            std::uint64_t n = decode_number();
+            if (n > std::numeric_limits<unsigned_xchar>::max())
+                throw malformed_bytes();
+            c = static_cast<xchar>(static_cast<unsigned_xchar>(n));
+        }
+        return rs;
+    }
+
+    word decode_word() {
+        using component = visitable_value<word_component_visitor, raw_string>;
+        word w{word::component_list(allocator<word::component_pointer>())};
+        w.components.resize(decode_count());
+        for (word::component_pointer &c : w.components) {
+            if (decode_tag() != tag::raw_string)
+                throw malformed_bytes();
+            c = make_shared_in<component>(m_arena, decode_raw_string());
+        }
+        return w;
+    }
+
+    pipeline::command_pointer decode_command() {
+        if (decode_tag() != tag::simple_command)
+            throw malformed_bytes();
+        simple_command sc{simple_command::word_list(allocator<word>())};
+        std::size_t count = decode_count();
+        sc.words.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            sc.words.push_back(decode_word());
+        using simple = visitable_value<command_visitor, simple_command>;
+        return make_shared_with<simple>(m_arena, std::move(sc));
+    }
+
+    pipeline decode_pipeline() {
+        pipeline p;
+        switch (decode_tag()) {
+        case tag::straight:
+            p.exit_status_mode = pipeline::exit_status_mode_type::straight;
+            break;
+        case tag::negated:
+            p.exit_status_mode = pipeline::exit_status_mode_type::negated;
+            break;
+        default:
+            throw malformed_bytes();
+        }
+        p.commands.resize(decode_count());
+        for (pipeline::command_pointer &c : p.commands)
+            c = decode_command();
+        return p;
+    }
+
+    conditional_pipeline::condition_type decode_condition() {
+        switch (decode_tag()) {
+        case tag::and_then:
+            return conditional_pipeline::condition_type::and_then;
+        case tag::or_else:
+            return conditional_pipeline::condition_type::or_else;
+        default:
+            throw malformed_bytes();
+        }
+    }
+
+    and_or_list decode_and_or_list() {
+        and_or_list aol;
+        switch (decode_tag()) {
+        case tag::sequential:
+            aol.synchronicity = and_or_list::synchronicity_type::sequential;
+            break;
+        case tag::asynchronous:
+            aol.synchronicity = and_or_list::synchronicity_type::asynchronous;
+            break;
+        default:
+            throw malformed_bytes();
+        }
+        aol.first = decode_pipeline();
+        std::size_t count = decode_count();
+        aol.rest.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto condition = decode_condition();
+            aol.rest.emplace_back(condition, decode_pipeline());
+        }
+        return aol;
+    }
+
+public:
+
+    decoder(const char *&position, const char *end) noexcept :
+            m_position(position), m_end(end) { }
+
+    sequence decode_sequence() {
+        sequence s;
+        s.and_or_lists.resize(decode_count());
+        for (and_or_list &aol : s.and_or_lists)
+            aol = decode_and_or_list();
+        return s;
+    }
+
+}; // class decoder
+
+} // namespace
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+maybe<std::uint64_t> decode_unsigned(const char *&begin, const char *end) {
+    std::uint64_t n = 0;
+    for (const char *p = begin; p != end; ) {
+        auto byte = static_cast<unsigned char>(*p++);
+        unsigned shift = 7 * static_cast<unsigned>(p - begin - 1);
+        std::uint64_t bits = byte & 0x7F;
+        if (shift >= 64 || (bits << shift) >> shift != bits)
+            return maybe<std::uint64_t>();
+        n |= bits << shift;
+        if ((byte & 0x80) == 0) {
+            begin = p;
+            return n;
+        }
+    }
+    return maybe<std::uint64_t>();
+}
+
+maybe<sequence> decode_sequence(const char *&begin, const char *end) {
+    const char *position = begin;
+    try {
+        sequence s = decoder(position, end).decode_sequence();
+        begin = position;
+        return s;
+    } catch (malformed_bytes &) {
+        return maybe<sequence>();
+    }
+}
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,58 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_serializing_decoding_hh
+#define INCLUDED_language_serializing_decoding_hh
+
+#include "buildconfig.h"
+
+#include <cstdint>
+#include "common/either.hh"
+#include "language/syntax/sequence.hh"
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+/**
+ * Reads an unsigned LEB128 number written by {@link encode_unsigned}. On
+ * success, the begin pointer is advanced past the number. Returns an empty
+ * maybe if the bytes are truncated or the number overflows.
+ */
+common::maybe<std::uint64_t> decode_unsigned(
+        const char *&begin, const char *end);
+
+/**
+ * Reads a sequence written by {@link encode_sequence}. On success, the begin
+ * pointer is advanced past the sequence. Returns an empty maybe if the bytes
+ * are malformed.
+ *
+ * The decoded strings are copied out of the bytes, so the bytes need not
+ * outlive the result. Like the synchronous parser, the decoder allocates the
+ * word components of the tree in an arena owned by the command and word
+ * component pointers.
+ */
+common::maybe<syntax::sequence> decode_sequence(
+        const char *&begin, const char *end);
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_serializing_decoding_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,172 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstdint>
+#include <vector>
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/printing/buffer.hh"
+#include "language/printing/sequence.hh"
+#include "language/serializing/decoding.hh"
+#include "language/serializing/encoding.hh"
+#include "language/syntax/and_or_list.hh"
+#include "language/syntax/conditional_pipeline.hh"
+#include "language/syntax/conditional_pipeline_test_helper.hh"
+#include "language/syntax/pipeline.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/sequence_test_helper.hh"
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::common::xstring;
+using sesh::language::printing::buffer;
+using sesh::language::serializing::decode_sequence;
+using sesh::language::serializing::decode_unsigned;
+using sesh::language::serializing::encode_sequence;
+using sesh::language::serializing::encode_unsigned;
+using sesh::language::syntax::and_or_list;
+using sesh::language::syntax::conditional_pipeline;
+using sesh::language::syntax::expect_raw_string_sequence;
+using sesh::language::syntax::make_and_or_list_stub;
+using sesh::language::syntax::make_conditional_pipeline_stub;
+using sesh::language::syntax::make_sequence_stub;
+using sesh::language::syntax::pipeline;
+using sesh::language::syntax::sequence;
+
+xstring to_string(const sequence &s) {
+    buffer b(buffer::line_mode_type::single_line);
+    print(s, b);
+    return b.to_string();
+}
+
+sequence make_complex_sequence() {
+    sequence s = make_sequence_stub(L("first"));
+    s.and_or_lists[0].first.exit_status_mode =
+            pipeline::exit_status_mode_type::negated;
+    s.and_or_lists[0].rest.push_back(make_conditional_pipeline_stub(L("x")));
+    s.and_or_lists[0].rest.push_back(make_conditional_pipeline_stub(L("y")));
+    s.and_or_lists[0].rest[1].condition =
+            conditional_pipeline::condition_type::or_else;
+    s.and_or_lists.push_back(make_and_or_list_stub(L("second\u00E9")));
+    s.and_or_lists[1].synchronicity =
+            and_or_list::synchronicity_type::asynchronous;
+    return s;
+}
+
+TEST_CASE("Decoding unsigned numbers") {
+    std::vector<char> v;
+    encode_unsigned(0, v);
+    encode_unsigned(300, v);
+    encode_unsigned(UINT64_C(0xFFFFFFFFFFFFFFFF), v);
+
+    const char *p = v.data(), *end = p + v.size();
+    maybe<std::uint64_t> n = decode_unsigned(p, end);
+    REQUIRE(n);
+    CHECK(*n == 0);
+    n = decode_unsigned(p, end);
+    REQUIRE(n);
+    CHECK(*n == 300);
+    n = decode_unsigned(p, end);
+    REQUIRE(n);
+    CHECK(*n == UINT64_C(0xFFFFFFFFFFFFFFFF));
+    CHECK((end - p) == 0);
+}
+
+TEST_CASE("Decoding truncated unsigned number fails") {
+    std::vector<char> v = {'\x80', '\x80'};
+    const char *p = v.data();
+    CHECK_FALSE(decode_unsigned(p, p + v.size()));
+    CHECK((p - v.data()) == 0);
+}
+
+TEST_CASE("Decoding overflowing unsigned number fails") {
+    std::vector<char> v(9, '\xFF');
+    v.push_back('\x02');
+    const char *p = v.data();
+    CHECK_FALSE(decode_unsigned(p, p + v.size()));
+}
+
+TEST_CASE("Decoding encoded sequence") {
+    std::vector<char> v;
+    encode_sequence(make_sequence_stub(L("word")), v);
+    v.push_back('x');
+
+    const char *p = v.data();
+    maybe<sequence> s = decode_sequence(p, p + v.size());
+    REQUIRE(s);
+    expect_raw_string_sequence(*s, {L("word")});
+    CHECK(*p == 'x');
+}
+
+TEST_CASE("Decoded sequence is identical to original") {
+    sequence original = make_complex_sequence();
+    std::vector<char> v;
+    encode_sequence(original, v);
+
+    const char *p = v.data();
+    maybe<sequence> s = decode_sequence(p, p + v.size());
+    REQUIRE(s);
+    CHECK((v.data() + v.size() - p) == 0);
+    CHECK(to_string(*s) == to_string(original));
+    REQUIRE(s->and_or_lists.size() == 2);
+    CHECK(s->and_or_lists[0].first.exit_status_mode ==
+            pipeline::exit_status_mode_type::negated);
+    REQUIRE(s->and_or_lists[0].rest.size() == 2);
+    CHECK(s->and_or_lists[0].rest[0].condition ==
+            conditional_pipeline::condition_type::and_then);
+    CHECK(s->and_or_lists[0].rest[1].condition ==
+            conditional_pipeline::condition_type::or_else);
+    CHECK(s->and_or_lists[1].synchronicity ==
+            and_or_list::synchronicity_type::asynchronous);
+}
+
+TEST_CASE("Decoding truncated sequence fails") {
+    std::vector<char> v;
+    encode_sequence(make_complex_sequence(), v);
+
+    for (std::size_t size = 0; size < v.size(); ++size) {
+        const char *p = v.data();
+        CHECK_FALSE(decode_sequence(p, p + size));
+        CHECK((p - v.data()) == 0);
+    }
+}
+
+TEST_CASE("Decoding sequence with unknown tag fails") {
+    std::vector<char> v;
+    encode_sequence(make_sequence_stub(L("word")), v);
+    v[1] = '\x7F'; // synchronicity
+
+    const char *p = v.data();
+    CHECK_FALSE(decode_sequence(p, p + v.size()));
+}
+
+TEST_CASE("Decoding sequence with too large count fails") {
+    std::vector<char> v;
+    encode_unsigned(UINT64_C(1) << 40, v);
+
+    const char *p = v.data();
+    CHECK_FALSE(decode_sequence(p, p + v.size()));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
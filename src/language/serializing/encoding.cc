@@ -0,0 +1,151 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "encoding.hh"
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "common/visitor.hh"
+#include "common/xchar.hh"
+#include "language/serializing/tag.hh"
+#include "language/syntax/and_or_list.hh"
+#include "language/syntax/command.hh"
+#include "language/syntax/conditional_pipeline.hh"
+#include "language/syntax/pipeline.hh"
+#include "language/syntax/raw_string.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/simple_command.hh"
+#include "language/syntax/word.hh"
+#include "language/syntax/word_component.hh"
+
+namespace {
+
+using sesh::common::xchar;
+using sesh::language::serializing::encode_unsigned;
+using sesh::language::serializing::tag;
+using sesh::language::syntax::and_or_list;
+using sesh::language::syntax::command;
+using sesh::language::syntax::conditional_pipeline;
+using sesh::language::syntax::pipeline;
+using sesh::language::syntax::raw_string;
+using sesh::language::syntax::simple_command;
+using sesh::language::syntax::word;
+using sesh::language::syntax::word_component;
+
+class encoder {
+
+private:
+
+    std::vector<char> &m_bytes;
+
+    void encode_tag(tag t) const {
+        m_bytes.push_back(static_cast<char>(t));
+    }
+
+public:
+
+    explicit encoder(std::vector<char> &bytes) noexcept : m_bytes(bytes) { }
+
+    void operator()(const raw_string &rs) const {
+        using unsigned_xchar = std::make_unsigned<xchar>::type;
+        encode_tag(tag::raw_string);
+        encode_unsigned(rs.value.size(), m_bytes);
+        for (xchar c : rs.value)
+            encode_unsigned(static_cast<unsigned_xchar>(c), m_bytes);
+    }
+
+    void encode(const word &w) const {
+        encode_unsigned(w.components.size(), m_bytes);
+        for (const word::component_pointer &c : w.components)
+            visit(*c, *this);
+    }
+
+    void operator()(const simple_command &sc) const {
+        encode_tag(tag::simple_command);
+        encode_unsigned(sc.words.size(), m_bytes);
+        for (const word &w : sc.words)
+            encode(w);
+    }
+
+    void encode(const pipeline &p) const {
+        switch (p.exit_status_mode) {
+        case pipeline::exit_status_mode_type::straight:
+            encode_tag(tag::straight);
+            break;
+        case pipeline::exit_status_mode_type::negated:
+            encode_tag(tag::negated);
+            break;
+        }
+        encode_unsigned(p.commands.size(), m_bytes);
+        for (const pipeline::command_pointer &c : p.commands)
+            visit(*c, *this);
+    }
+
+    void encode(const and_or_list &aol) const {
+        switch (aol.synchronicity) {
+        case and_or_list::synchronicity_type::sequential:
+            encode_tag(tag::sequential);
+            break;
+        case and_or_list::synchronicity_type::asynchronous:
+            encode_tag(tag::asynchronous);
+            break;
+        }
+        encode(aol.first);
+        encode_unsigned(aol.rest.size(), m_bytes);
+        for (const conditional_pipeline &cp : aol.rest) {
+            switch (cp.condition) {
+            case conditional_pipeline::condition_type::and_then:
+                encode_tag(tag::and_then);
+                break;
+            case conditional_pipeline::condition_type::or_else:
+                encode_tag(tag::or_else);
+                break;
+            }
+            encode(cp.pipeline);
+        }
+    }
+
+}; // class encoder
+
+} // namespace
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+void encode_unsigned(std::uint64_t n, std::vector<char> &bytes) {
+    while (n >= 0x80) {
+        bytes.push_back(static_cast<char>((n & 0x7F) | 0x80));
+        n >>= 7;
+    }
+    bytes.push_back(static_cast<char>(n));
+}
+
+void encode_sequence(const syntax::sequence &s, std::vector<char> &bytes) {
+    encoder e(bytes);
+    encode_unsigned(s.and_or_lists.size(), bytes);
+    for (const and_or_list &aol : s.and_or_lists)
+        e.encode(aol);
+}
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,56 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_serializing_encoding_hh
+#define INCLUDED_language_serializing_encoding_hh
+
+#include "buildconfig.h"
+
+#include <cstdint>
+#include <vector>
+#include "language/syntax/sequence.hh"
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+/**
+ * Version of the binary format of syntax trees. It must be incremented
+ * whenever the format or the syntax classes change so that stale data are
+ * rejected.
+ *
+ * A syntax tree is encoded in pre-order. Every vector is preceded by the
+ * number of its elements, every enumerator and alternative of a visitable
+ * node is a one-byte tag, and every integer (including characters) is an
+ * unsigned LEB128 number, so short scripts are encoded in about as many bytes
+ * as their source.
+ */
+constexpr unsigned char format_version = 1;
+
+/** Appends an unsigned LEB128 number to the byte vector. */
+void encode_unsigned(std::uint64_t, std::vector<char> &);
+
+/** Appends the binary representation of the sequence to the byte vector. */
+void encode_sequence(const syntax::sequence &, std::vector<char> &);
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_serializing_encoding_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
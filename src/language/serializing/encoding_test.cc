@@ -0,0 +1,87 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "catch.hpp"
+#include "common/xchar.hh"
+#include "language/serializing/encoding.hh"
+#include "language/syntax/and_or_list.hh"
+#include "language/syntax/sequence.hh"
+#include "language/syntax/sequence_test_helper.hh"
+
+namespace {
+
+using sesh::language::serializing::encode_sequence;
+using sesh::language::serializing::encode_unsigned;
+using sesh::language::syntax::and_or_list;
+using sesh::language::syntax::make_sequence_stub;
+using sesh::language::syntax::sequence;
+
+std::vector<char> bytes(std::initializer_list<unsigned char> values) {
+    return std::vector<char>(values.begin(), values.end());
+}
+
+TEST_CASE("Encoding unsigned numbers") {
+    std::vector<char> v;
+    encode_unsigned(0, v);
+    encode_unsigned(0x7F, v);
+    encode_unsigned(0x80, v);
+    encode_unsigned(300, v);
+    CHECK(v == bytes({0x00, 0x7F, 0x80, 0x01, 0xAC, 0x02}));
+}
+
+TEST_CASE("Encoding maximum unsigned number") {
+    std::vector<char> v;
+    encode_unsigned(UINT64_C(0xFFFFFFFFFFFFFFFF), v);
+    CHECK(v == bytes({
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01}));
+}
+
+TEST_CASE("Encoding empty sequence") {
+    std::vector<char> v;
+    encode_sequence(sequence(), v);
+    CHECK(v == bytes({0x00}));
+}
+
+TEST_CASE("Encoding single word sequence") {
+    std::vector<char> v = {'x'};
+    sequence s = make_sequence_stub(L("ab"));
+    s.and_or_lists[0].synchronicity =
+            and_or_list::synchronicity_type::asynchronous;
+    encode_sequence(s, v);
+    CHECK(v == bytes({
+            'x', // existing byte
+            0x01, // and-or lists
+            0x02, // asynchronous
+            0x05, // straight
+            0x01, // commands
+            0x07, // simple command
+            0x01, // words
+            0x01, // components
+            0x08, // raw string
+            0x02, 'a', 'b', // value
+            0x00, // conditional pipelines
+            }));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
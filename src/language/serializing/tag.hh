@@ -0,0 +1,49 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_serializing_tag_hh
+#define INCLUDED_language_serializing_tag_hh
+
+#include "buildconfig.h"
+
+namespace sesh {
+namespace language {
+namespace serializing {
+
+/**
+ * One-byte tags that identify enumerators and alternatives of visitable nodes
+ * in the binary format of syntax trees. Every tag has a distinct value so
+ * that corrupt data are more likely to be detected.
+ */
+enum class tag : unsigned char {
+    sequential = 0x01,
+    asynchronous = 0x02,
+    and_then = 0x03,
+    or_else = 0x04,
+    straight = 0x05,
+    negated = 0x06,
+    simple_command = 0x07,
+    raw_string = 0x08,
+};
+
+} // namespace serializing
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_serializing_tag_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -24,6 +24,11 @@ namespace sesh {
 namespace language {
 namespace source {
 
+fragment::id_type fragment::new_id() noexcept {
+    static id_type last_id = 0;
+    return ++last_id;
+}
+
 fragment_position &operator++(fragment_position &p) {
     assert(p.head != nullptr);
     ++p.index;
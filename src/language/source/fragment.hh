@@ -21,6 +21,7 @@
 #include "buildconfig.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <type_traits>
@@ -93,6 +94,10 @@ class fragment {
 public:
 
     using value_type = fragment_position::string_type;
+    using id_type = std::uint_least64_t;
+
+    /** Returns a new fragment ID, which is never zero. */
+    static id_type new_id() noexcept;
 
     /** Source code fragment value. */
     value_type value;
@@ -102,6 +107,14 @@ public:
      */
     fragment_position rest;
 
+    /**
+     * ID of this fragment. A new ID is assigned to every constructed fragment
+     * so that a {@link location} can refer to the fragment without keeping it
+     * alive. Copying or moving a fragment does not copy the ID: the target is
+     * given a new ID so that IDs stay unique.
+     */
+    id_type id = new_id();
+
     template<
             typename V = value_type,
             typename R = std::nullptr_t,
@@ -112,6 +125,25 @@ public:
     fragment(V &&v = value_type(), R &&r = nullptr) :
             value(std::forward<V>(v)), rest(std::forward<R>(r)) { }
 
+    fragment(const fragment &f) : value(f.value), rest(f.rest) { }
+
+    fragment(fragment &&f) noexcept :
+            value(std::move(f.value)), rest(std::move(f.rest)) { }
+
+    fragment &operator=(const fragment &f) {
+        value = f.value;
+        rest = f.rest;
+        id = new_id();
+        return *this;
+    }
+
+    fragment &operator=(fragment &&f) noexcept {
+        value = std::move(f.value);
+        rest = std::move(f.rest);
+        id = new_id();
+        return *this;
+    }
+
 }; // class fragment
 
 inline fragment_position::reference operator*(const fragment_position &p) {
@@ -0,0 +1,95 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "location.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "language/source/fragment.hh"
+
+namespace sesh {
+namespace language {
+namespace source {
+
+void line_table::append(const std::shared_ptr<const fragment> &f) {
+    assert(f != nullptr);
+    assert(m_entries.empty() || m_entries.back().id < f->id);
+
+    const fragment::value_type &v = f->value;
+    m_entries.push_back(
+            entry{f->id, m_next_line, m_next_column_offset, f, {}});
+
+    auto &line_starts = m_entries.back().line_starts;
+    auto last_newline = fragment::value_type::npos;
+    for (auto i = v.find(L('\n'));
+            i != fragment::value_type::npos;
+            i = v.find(L('\n'), i + 1)) {
+        if (i + 1 < v.size())
+            line_starts.push_back(i + 1);
+        last_newline = i;
+        ++m_next_line;
+    }
+
+    if (last_newline == fragment::value_type::npos)
+        m_next_column_offset += v.size();
+    else
+        m_next_column_offset = v.size() - last_newline - 1;
+}
+
+auto line_table::look_up(const location &l) const
+        -> common::maybe<line_and_column> {
+    auto i = std::lower_bound(
+            m_entries.begin(),
+            m_entries.end(),
+            l.fragment_id,
+            [](const entry &e, fragment::id_type id) { return e.id < id; });
+    if (i == m_entries.end() || i->id != l.fragment_id)
+        return {};
+
+    std::shared_ptr<const fragment> f = i->weak_fragment.lock();
+
+    auto next = std::upper_bound(
+            i->line_starts.begin(), i->line_starts.end(), l.offset);
+    auto line_index = static_cast<std::size_t>(
+            next - i->line_starts.begin());
+    fragment_position::size_type start, column;
+    if (line_index == 0) {
+        start = 0;
+        column = i->first_column_offset + l.offset + 1;
+    } else {
+        start = *(next - 1);
+        column = l.offset - start + 1;
+    }
+    auto line = i->first_line + line_index;
+    if (f == nullptr)
+        return line_and_column{line, column, {}};
+
+    auto end = f->value.find(L('\n'), start);
+    return line_and_column{
+            line, column, f->value.substr(start, end - start)};
+}
+
+} // namespace source
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,166 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_source_location_hh
+#define INCLUDED_language_source_location_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "common/either.hh"
+#include "common/xstring.hh"
+#include "language/source/fragment.hh"
+
+namespace sesh {
+namespace language {
+namespace source {
+
+/**
+ * A location is a compact representation of a character position in source
+ * code. Unlike a {@link fragment_position}, a location refers to the fragment
+ * by its ID, so it does not keep the fragment alive. The line and column of a
+ * location can be computed by a {@link line_table}.
+ */
+class location {
+
+public:
+
+    using size_type = fragment_position::size_type;
+
+    /** ID of the fragment. Zero if the location is unknown or at the end. */
+    fragment::id_type fragment_id = 0;
+
+    /** Index into the value of the fragment. */
+    size_type offset = 0;
+
+    location() = default;
+
+    location(fragment::id_type id, size_type offset) noexcept :
+            fragment_id(id), offset(offset) { }
+
+}; // class location
+
+inline bool operator==(const location &l, const location &r) noexcept {
+    return l.fragment_id == r.fragment_id && l.offset == r.offset;
+}
+
+inline bool operator!=(const location &l, const location &r) noexcept {
+    return !(l == r);
+}
+
+/** Returns the location of the argument fragment position. */
+inline location location_of(const fragment_position &p) noexcept {
+    if (p.head == nullptr)
+        return location();
+    return location{p.head->id, p.index};
+}
+
+/** Line and column of a location. */
+class line_and_column {
+
+public:
+
+    /** Line number counted from 1. */
+    std::size_t line;
+
+    /**
+     * Column number counted from 1, including the characters of the line in
+     * preceding fragments.
+     */
+    std::size_t column;
+
+    /**
+     * Part of the line in the fragment, not including the newline. Empty if
+     * the fragment has been released.
+     */
+    common::xstring text;
+
+}; // class line_and_column
+
+/**
+ * A line table computes line numbers for locations in fragments that have
+ * been appended to the table. The table keeps only weak references to the
+ * fragments, so the fragments can be released while the table is still
+ * used.
+ *
+ * The table is built incrementally: when a fragment is appended, the
+ * positions of the newlines in it and the length of its last line are
+ * recorded, so lines and columns remain correct after the fragment is
+ * released. A lookup takes O(log n) time for n fragments and O(log k) time
+ * for k lines in the fragment, so resolving many reports does not take
+ * quadratic time.
+ */
+class line_table {
+
+private:
+
+    class entry {
+
+    public:
+
+        fragment::id_type id;
+        std::size_t first_line;
+
+        /** Number of characters of the first line in preceding fragments. */
+        std::size_t first_column_offset;
+
+        std::weak_ptr<const fragment> weak_fragment;
+
+        /**
+         * Indices of line beginnings in the fragment, excluding the first
+         * line. Empty for a fragment that contains no newline except at the
+         * end, which is the usual case for a fragment of an input line.
+         */
+        std::vector<fragment_position::size_type> line_starts;
+
+    }; // class entry
+
+    /** Sorted by fragment ID. */
+    std::vector<entry> m_entries;
+
+    std::size_t m_next_line = 1;
+    std::size_t m_next_column_offset = 0;
+
+public:
+
+    /**
+     * Adds a fragment to this table. Fragments must be appended in the order
+     * they appear in the source code, which must be the order they have been
+     * constructed.
+     */
+    void append(const std::shared_ptr<const fragment> &);
+
+    /**
+     * Computes the line and column of the argument location. The result is
+     * empty if the location is not in any fragment in this table.
+     *
+     * If the fragment has been released, the line and column are still
+     * computed correctly but the text of the result is empty.
+     */
+    common::maybe<line_and_column> look_up(const location &) const;
+
+}; // class line_table
+
+} // namespace source
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_source_location_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
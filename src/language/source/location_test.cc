@@ -0,0 +1,183 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <memory>
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "language/source/fragment.hh"
+#include "language/source/location.hh"
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::language::source::fragment;
+using sesh::language::source::fragment_position;
+using sesh::language::source::line_and_column;
+using sesh::language::source::line_table;
+using sesh::language::source::location;
+using sesh::language::source::location_of;
+
+TEST_CASE("Location: fragments have distinct nonzero IDs") {
+    fragment f1, f2;
+    CHECK(f1.id != 0);
+    CHECK(f2.id != 0);
+    CHECK(f1.id != f2.id);
+}
+
+TEST_CASE("Location: copied fragments have distinct IDs") {
+    fragment f1(L("abc"));
+    fragment f2(f1);
+    CHECK(f2.value == L("abc"));
+    CHECK(f2.id != f1.id);
+
+    fragment f3;
+    auto id3 = f3.id;
+    f3 = f1;
+    CHECK(f3.value == L("abc"));
+    CHECK(f3.id != f1.id);
+    CHECK(f3.id != id3);
+}
+
+TEST_CASE("Location: location of fragment position") {
+    auto f = std::make_shared<const fragment>(L("abc"));
+    location l = location_of(fragment_position(f, 2));
+    CHECK(l.fragment_id == f->id);
+    CHECK(l.offset == 2);
+    CHECK(location_of(fragment_position()) == location());
+}
+
+TEST_CASE("Location: line table looks up lines and columns") {
+    auto f1 = std::make_shared<const fragment>(L("a\nbc\n"));
+    auto f2 = std::make_shared<const fragment>(L("de\nf"));
+    line_table t;
+    t.append(f1);
+    t.append(f2);
+
+    maybe<line_and_column> lc = t.look_up(location{f1->id, 3});
+    REQUIRE(lc);
+    CHECK(lc->line == 2);
+    CHECK(lc->column == 2);
+    CHECK(lc->text == L("bc"));
+
+    lc = t.look_up(location{f2->id, 3});
+    REQUIRE(lc);
+    CHECK(lc->line == 4);
+    CHECK(lc->column == 1);
+    CHECK(lc->text == L("f"));
+
+    CHECK_FALSE(t.look_up(location()));
+}
+
+TEST_CASE("Location: line table counts columns across fragments") {
+    auto f1 = std::make_shared<const fragment>(L("ab"));
+    auto f2 = std::make_shared<const fragment>(L("cd\nef"));
+    auto f3 = std::make_shared<const fragment>(L("g\n"));
+    line_table t;
+    t.append(f1);
+    t.append(f2);
+    t.append(f3);
+
+    maybe<line_and_column> lc = t.look_up(location{f2->id, 1});
+    REQUIRE(lc);
+    CHECK(lc->line == 1);
+    CHECK(lc->column == 4);
+    CHECK(lc->text == L("cd"));
+
+    lc = t.look_up(location{f2->id, 4});
+    REQUIRE(lc);
+    CHECK(lc->line == 2);
+    CHECK(lc->column == 2);
+    CHECK(lc->text == L("ef"));
+
+    lc = t.look_up(location{f3->id, 1});
+    REQUIRE(lc);
+    CHECK(lc->line == 2);
+    CHECK(lc->column == 4);
+}
+
+TEST_CASE("Location: line table does not keep fragments alive") {
+    auto f1 = std::make_shared<const fragment>(L("a\nb"));
+    auto f2 = std::make_shared<const fragment>(L("c\nd\n"));
+    auto f3 = std::make_shared<const fragment>(L("e"));
+    std::weak_ptr<const fragment> w = f2;
+    location l1{f1->id, 2}, l2{f2->id, 2}, l3{f3->id, 0};
+    line_table t;
+    t.append(f1);
+    t.append(f2);
+    t.append(f3);
+
+    CHECK(t.look_up(l1));
+    f1.reset();
+    f2.reset();
+    CHECK(w.expired());
+
+    maybe<line_and_column> lc = t.look_up(l1);
+    REQUIRE(lc);
+    CHECK(lc->line == 2);
+    CHECK(lc->column == 1);
+    CHECK(lc->text.empty());
+
+    lc = t.look_up(l2);
+    REQUIRE(lc);
+    CHECK(lc->line == 3);
+    CHECK(lc->column == 1);
+    CHECK(lc->text.empty());
+
+    lc = t.look_up(l3);
+    REQUIRE(lc);
+    CHECK(lc->line == 4);
+    CHECK(lc->text == L("e"));
+}
+
+TEST_CASE("Location: line table looks up lines in released fragments") {
+    auto f1 = std::make_shared<const fragment>(L("ab\ncd\nef"));
+    auto f2 = std::make_shared<const fragment>(L("g\nh"));
+    location l1{f1->id, 4}, l2{f1->id, 7}, l3{f2->id, 0}, l4{f2->id, 2};
+    line_table t;
+    t.append(f1);
+    t.append(f2);
+    f1.reset();
+    f2.reset();
+
+    maybe<line_and_column> lc = t.look_up(l1);
+    REQUIRE(lc);
+    CHECK(lc->line == 2);
+    CHECK(lc->column == 2);
+    CHECK(lc->text.empty());
+
+    lc = t.look_up(l2);
+    REQUIRE(lc);
+    CHECK(lc->line == 3);
+    CHECK(lc->column == 2);
+
+    lc = t.look_up(l3);
+    REQUIRE(lc);
+    CHECK(lc->line == 3);
+    CHECK(lc->column == 3);
+
+    lc = t.look_up(l4);
+    REQUIRE(lc);
+    CHECK(lc->line == 4);
+    CHECK(lc->column == 1);
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
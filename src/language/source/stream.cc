@@ -18,12 +18,68 @@
 #include "buildconfig.h"
 #include "stream.hh"
 
-#include <iterator>
+#include <cassert>
+#include <memory>
+#include <utility>
 #include "async/future.hh"
+#include "language/source/fragment.hh"
 
 namespace {
 
+using sesh::async::future;
 using sesh::async::make_future;
+using sesh::language::source::fragment_position;
+using sesh::language::source::fragment_reader;
+using sesh::language::source::stream;
+using sesh::language::source::stream_chunk;
+using sesh::language::source::stream_chunk_future;
+using sesh::language::source::stream_of_reader;
+using sesh::language::source::stream_value;
+
+class value_getter {
+
+public:
+
+    stream s;
+
+    stream_value operator()(const stream_chunk &c) const {
+        return s.value_in(c);
+    }
+
+}; // class value_getter
+
+class reader_chunk_maker {
+
+public:
+
+    std::shared_ptr<fragment_reader> reader;
+
+    stream_chunk operator()(fragment_position &&fp) const {
+        stream_chunk c;
+        if (fp == nullptr)
+            return c;
+
+        assert(fp.index < fp.head->value.length());
+        c.length = fp.head->value.length() - fp.index;
+        c.begin = std::move(fp);
+        c.rest = stream_of_reader(reader);
+        return c;
+    }
+
+}; // class reader_chunk_maker
+
+class reader_caller {
+
+public:
+
+    std::shared_ptr<fragment_reader> reader;
+
+    stream_chunk_future operator()() const {
+        return static_cast<stream_chunk_future>(
+                (*reader)().map(reader_chunk_maker{reader}));
+    }
+
+}; // class reader_caller
 
 } // namespace
 
@@ -31,15 +87,42 @@ namespace sesh {
 namespace language {
 namespace source {
 
-stream_value_future empty_stream_value_future() {
-    return make_future<stream_value>();
+stream_value stream::value_in(const stream_chunk &c) const {
+    if (c.begin == nullptr)
+        return stream_value(c.begin, c.rest);
+
+    fragment_position p(c.begin.head, c.begin.index + m_offset);
+    if (m_offset + 1 < c.length)
+        return stream_value(std::move(p), stream(m_node, m_offset + 1));
+    return stream_value(std::move(p), c.rest);
+}
+
+future<stream_value> stream::get() const {
+    return m_node->get().map(value_getter{*this});
+}
+
+stream_chunk_future empty_stream_chunk_future() {
+    return make_future<stream_chunk>();
 }
 
 stream stream_of(const fragment_position &fp, const stream &s) {
     if (fp == nullptr)
         return s;
-    return static_cast<stream_value_future>(
-            make_future<stream_value>(fp, stream_of(std::next(fp), s)));
+
+    const fragment &f = *fp.head;
+    if (fp.index >= f.value.length())
+        return stream_of(f.rest, s);
+
+    stream_chunk c;
+    c.begin = fp;
+    c.length = f.value.length() - fp.index;
+    c.rest = stream_of(f.rest, s);
+    return stream(stream_node(static_cast<stream_chunk_future>(
+            make_future<stream_chunk>(std::move(c)))));
+}
+
+stream stream_of_reader(const std::shared_ptr<fragment_reader> &r) {
+    return stream(reader_caller{r});
 }
 
 } // namespace source
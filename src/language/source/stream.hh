@@ -21,7 +21,10 @@
 #include "buildconfig.h"
 
 #include <functional>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include "async/future.hh"
 #include "async/shared_future.hh"
 #include "async/shared_lazy.hh"
 #include "language/source/fragment.hh"
@@ -31,9 +34,13 @@ namespace language {
 namespace source {
 
 // Defined just below
+class stream_chunk;
 class stream_value;
 
-using stream_value_future = async::shared_future<stream_value>;
+using stream_chunk_future = async::shared_future<stream_chunk>;
+
+/** Lazily computed shared future of a stream chunk. */
+using stream_node = async::shared_lazy<stream_chunk_future>;
 
 /**
  * A stream is an abstract sequence of {@link async::shared_future}s of {@link
@@ -54,40 +61,171 @@ using stream_value_future = async::shared_future<stream_value>;
  * source code of the stream only as much as needed. The stream determines
  * whether it needs to read the next line to return a fragment to the parser.
  *
- * The stream is defined as a lazily computed shared future of a pair of a
- * fragment position and the succeeding stream. The resultant fragment position
- * will be null if the stream has reached the end of input.
+ * The stream is made up of lazily computed shared futures of {@link
+ * stream_chunk}s, each of which covers a contiguous span of characters in a
+ * fragment. A stream instance is a pair of a pointer to a chunk and an offset
+ * into the span, so advancing the stream within a chunk does not allocate any
+ * memory.
+ */
+class stream {
+
+public:
+
+    using size_type = fragment_position::size_type;
+
+private:
+
+    stream_node m_node;
+    size_type m_offset;
+
+public:
+
+    /** Constructs a stream whose node is never computed. */
+    stream() : m_node(), m_offset(0) { }
+
+    /**
+     * Constructs a stream that starts at the argument offset in the chunk of
+     * the argument node. The offset must be less than the length of the chunk
+     * unless it is zero.
+     */
+    explicit stream(const stream_node &n, size_type offset = 0) :
+            m_node(n), m_offset(offset) { }
+
+    /**
+     * Constructs a stream whose chunk will be computed by the argument
+     * function when needed.
+     */
+    explicit stream(stream_node::result_maker &&f) :
+            m_node(std::move(f)), m_offset(0) { }
+
+    const stream_node &node() const noexcept { return m_node; }
+    size_type offset() const noexcept { return m_offset; }
+
+    /**
+     * Returns the first character position of this stream and the stream that
+     * follows it, given the chunk of this stream's node.
+     */
+    stream_value value_in(const stream_chunk &) const;
+
+    /**
+     * Returns a future of the stream value of this stream. The future is
+     * computed from the chunk of the node without creating another stream
+     * node.
+     */
+    async::future<stream_value> get() const;
+
+    /**
+     * Returns a future of the result of applying the argument function to the
+     * stream value of this stream. This is equivalent to
+     * <code>get().map(f)</code> but saves one future.
+     */
+    template<
+            typename F,
+            typename R = typename std::result_of<
+                    typename std::decay<F>::type(const stream_value &)>::type>
+    async::future<R> map(F &&f) const;
+
+}; // class stream
+
+/**
+ * A stream chunk is a contiguous span of characters in a fragment, followed by
+ * another stream.
  *
- * Homomorphism requirement: Let @c s be an instance of stream and @c p the
- * pair presented in the shared future returned by calling @c s. Assume
- * <code>p.first</code> is incrementable and let <code>q</code> be the result
- * of <code>++p.first</code>. If <code>q.head</code> yields a non-null pointer,
- * the fragment position in the pair presented in the shared future returned by
- * calling <code>p.second</code> must be @c q.
+ * Homomorphism requirement: If @c begin is non-null, the span must not extend
+ * beyond the value of the head fragment. Let @c q be the fragment position
+ * that follows the last character of the span. If <code>q.head</code> is
+ * non-null, the first fragment position of the stream @c rest must be @c q.
  */
-using stream = async::shared_lazy<stream_value_future>;
+class stream_chunk {
+
+public:
+
+    /**
+     * Position of the first character in the span. Null if the stream has
+     * reached the end of input.
+     */
+    fragment_position begin;
+
+    /** Number of characters in the span. Zero if and only if begin is null. */
+    stream::size_type length = 0;
+
+    /** Stream that follows the span. */
+    stream rest;
+
+}; // class stream_chunk
 
 using stream_value_pair = std::pair<fragment_position, stream>;
 
+/**
+ * A stream value is a pair of a fragment position and the succeeding stream.
+ * The fragment position will be null if the stream has reached the end of
+ * input.
+ */
 class stream_value : public stream_value_pair {
 
     using stream_value_pair::stream_value_pair;
 
 };
 
-stream_value_future empty_stream_value_future();
+namespace stream_impl {
+
+template<typename F>
+class value_mapper {
+
+public:
+
+    F function;
+    stream s;
 
-inline stream empty_stream() noexcept {
-    return stream(empty_stream_value_future);
+    auto operator()(const stream_chunk &c)
+            -> typename std::result_of<F(const stream_value &)>::type {
+        return function(s.value_in(c));
+    }
+
+}; // template<typename F> class value_mapper
+
+} // namespace stream_impl
+
+template<typename F, typename R>
+async::future<R> stream::map(F &&f) const {
+    using mapper = stream_impl::value_mapper<typename std::decay<F>::type>;
+    return m_node->get().map(mapper{std::forward<F>(f), *this});
+}
+
+stream_chunk_future empty_stream_chunk_future();
+
+inline stream empty_stream() {
+    return stream(empty_stream_chunk_future);
 }
 
 /**
- * Creates a stream by prepending a fragment to another stream. The resultant
- * stream first iterates on the fragment and then continues to the other
- * stream.
+ * Returns a stream of the characters starting from the argument fragment
+ * position, followed by the argument stream. The returned stream contains one
+ * chunk per fragment.
  */
 stream stream_of(const fragment_position &, const stream & = empty_stream());
 
+/**
+ * A fragment reader returns a future of the position of the next fragment of
+ * source code. The future receives a null position at the end of input.
+ * Otherwise, the index of the position must be less than the length of the
+ * fragment value.
+ */
+using fragment_reader = std::function<async::future<fragment_position>()>;
+
+/**
+ * Returns a stream that calls the argument reader to read the next fragment
+ * only when the chunk of the fragment is needed. The returned stream contains
+ * one chunk per fragment, starting from the position returned by the reader.
+ * The rest of the fragment is ignored.
+ *
+ * Unlike the stream returned by {@link stream_of}, a chunk does not refer to
+ * the chunks that have not yet been read. Once no stream refers to a chunk
+ * any longer, the chunk and its fragment are released, so the memory used by
+ * the stream is bounded by the chunks in use rather than the whole input.
+ */
+stream stream_of_reader(const std::shared_ptr<fragment_reader> &);
+
 } // namespace source
 } // namespace language
 } // namespace sesh
@@ -0,0 +1,121 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "allocation_counter.hh"
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "language/parsing/char.hh"
+#include "language/parsing/parser.hh"
+#include "language/source/fragment.hh"
+#include "language/source/stream.hh"
+
+/*
+ * Counts the memory allocations needed to build a stream of a script and
+ * to scan the whole stream character by character with the character parser.
+ * The script is split into fragments of various sizes: a fragment per line is
+ * how the shell reads interactive input, a fragment of a single character has
+ * the same layout as a stream with one node per character, and a single
+ * fragment is the case of a whole script file.
+ */
+
+namespace {
+
+using sesh::allocation_count;
+using sesh::common::trial;
+using sesh::common::xchar;
+using sesh::language::parsing::accept_char;
+using sesh::language::parsing::result;
+using sesh::language::parsing::state;
+using sesh::language::source::fragment;
+using sesh::language::source::fragment_position;
+using sesh::language::source::stream;
+using sesh::language::source::stream_of;
+
+using clock = std::chrono::steady_clock;
+
+fragment_position make_script(
+        std::size_t script_size, std::size_t fragment_size) {
+    fragment_position p;
+    for (std::size_t n = script_size; n > 0; ) {
+        std::size_t size = std::min(n, fragment_size);
+        n -= size;
+        fragment::value_type value(size - 1, L('x'));
+        value += L('\n');
+        p = fragment_position(std::make_shared<fragment>(
+                std::move(value), std::move(p)));
+    }
+    return p;
+}
+
+std::size_t scan(const stream &s) {
+    state st{s, {}};
+    std::size_t count = 0;
+    bool is_end = false;
+    while (!is_end) {
+        accept_char(st).then([&](trial<result<xchar>> &&t) {
+            if (!t->product) {
+                is_end = true;
+                return;
+            }
+            st = std::move(t->product->state);
+            ++count;
+        });
+    }
+    return count;
+}
+
+void run(std::size_t script_size, std::size_t fragment_size) {
+    const fragment_position script = make_script(script_size, fragment_size);
+
+    std::size_t start_count = allocation_count();
+    clock::time_point start = clock::now();
+    stream s = stream_of(script);
+    std::size_t build_count = allocation_count() - start_count;
+
+    start_count = allocation_count();
+    std::size_t chars = scan(s);
+    std::size_t scan_count = allocation_count() - start_count;
+    double ms = std::chrono::duration<double, std::milli>(
+            clock::now() - start).count();
+
+    std::cout << fragment_size << '\t' << chars << '\t' << build_count <<
+            '\t' << scan_count << '\t' <<
+            static_cast<double>(scan_count) / chars << '\t' << ms << '\n';
+}
+
+} // namespace
+
+int main() {
+    std::cout << "fragment\tchars\tbuild(allocs)\tscan(allocs)\t"
+            "scan(allocs/char)\ttime(ms)\n";
+    // The fragment chain is destroyed recursively, so the script of
+    // single-character fragments is kept small.
+    run(1 << 14, 1);
+    run(1 << 20, 80);
+    run(1 << 20, 1 << 20);
+    return 0;
+}
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
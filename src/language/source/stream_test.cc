@@ -17,7 +17,12 @@
 
 #include "buildconfig.h"
 
+#include <cstddef>
 #include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
 #include "catch.hpp"
 #include "common/either.hh"
 #include "common/xchar.hh"
@@ -25,17 +30,20 @@
 
 namespace {
 
+using sesh::async::make_future_of;
 using sesh::common::trial;
 using sesh::language::source::empty_stream;
 using sesh::language::source::fragment;
 using sesh::language::source::fragment_position;
+using sesh::language::source::fragment_reader;
 using sesh::language::source::stream;
 using sesh::language::source::stream_of;
+using sesh::language::source::stream_of_reader;
 using sesh::language::source::stream_value;
 
 void check_empty_stream(const stream &s) {
     bool called = false;
-    s->get().then([&called](const trial<stream_value> &t) {
+    s.get().then([&called](const trial<stream_value> &t) {
         REQUIRE(t);
         CHECK(t->first == nullptr);
         called = true;
@@ -62,19 +70,19 @@ TEST_CASE("Stream of fragment chain") {
             std::make_shared<const fragment>(L("..12"), fp1), 2);
     auto s = stream_of(fp2);
     bool called = false;
-    s->get().then([&](const trial<stream_value> &t) {
+    s.get().then([&](const trial<stream_value> &t) {
         REQUIRE(t);
         CHECK(t->first == fp2);
-        t->second->get().then([&](const trial<stream_value> &t) {
+        t->second.get().then([&](const trial<stream_value> &t) {
             REQUIRE(t);
             CHECK(t->first == std::next(fp2));
-            t->second->get().then([&](const trial<stream_value> &t) {
+            t->second.get().then([&](const trial<stream_value> &t) {
                 REQUIRE(t);
                 CHECK(t->first == fp1);
-                t->second->get().then([&](const trial<stream_value> &t) {
+                t->second.get().then([&](const trial<stream_value> &t) {
                     REQUIRE(t);
                     CHECK(t->first == std::next(fp1));
-                    t->second->get().then([&](const trial<stream_value> &t) {
+                    t->second.get().then([&](const trial<stream_value> &t) {
                         REQUIRE(t);
                         CHECK(t->first == nullptr);
                         called = true;
@@ -90,10 +98,10 @@ TEST_CASE("Prepending empty fragment") {
     const fragment_position fp(std::make_shared<const fragment>(L("1")));
     auto s = stream_of(fragment_position(), stream_of(fp));
     bool called = false;
-    s->get().then([&](const trial<stream_value> &t) {
+    s.get().then([&](const trial<stream_value> &t) {
         REQUIRE(t);
         CHECK(t->first == fp);
-        t->second->get().then([&](const trial<stream_value> &t) {
+        t->second.get().then([&](const trial<stream_value> &t) {
             REQUIRE(t);
             CHECK(t->first == nullptr);
             called = true;
@@ -107,13 +115,13 @@ TEST_CASE("Stream chain") {
     const fragment_position fp2(std::make_shared<const fragment>(L("2")));
     auto s = stream_of(fp1, stream_of(fp2));
     bool called = false;
-    s->get().then([&](const trial<stream_value> &t) {
+    s.get().then([&](const trial<stream_value> &t) {
         REQUIRE(t);
         CHECK(t->first == fp1);
-        t->second->get().then([&](const trial<stream_value> &t) {
+        t->second.get().then([&](const trial<stream_value> &t) {
             REQUIRE(t);
             CHECK(t->first == fp2);
-            t->second->get().then([&](const trial<stream_value> &t) {
+            t->second.get().then([&](const trial<stream_value> &t) {
                 REQUIRE(t);
                 CHECK(t->first == nullptr);
                 called = true;
@@ -123,6 +131,80 @@ TEST_CASE("Stream chain") {
     CHECK(called);
 }
 
+TEST_CASE("Stream of fragment shares one node per fragment") {
+    const fragment_position fp1(std::make_shared<const fragment>(L("3")));
+    const fragment_position fp2(
+            std::make_shared<const fragment>(L("12"), fp1));
+    auto s = stream_of(fp2);
+    bool called = false;
+    s.get().then([&](const trial<stream_value> &t) {
+        REQUIRE(t);
+        const stream &s2 = t->second;
+        CHECK(&s2.node().lazy() == &s.node().lazy());
+        CHECK(s2.offset() == 1);
+        s2.get().then([&](const trial<stream_value> &t) {
+            REQUIRE(t);
+            CHECK(t->first == std::next(fp2));
+            CHECK(&t->second.node().lazy() != &s.node().lazy());
+            CHECK(t->second.offset() == 0);
+            called = true;
+        });
+    });
+    CHECK(called);
+}
+
+TEST_CASE("Stream of reader reads fragments on demand") {
+    const fragment_position fp1(std::make_shared<const fragment>(L("1")));
+    const fragment_position fp2(std::make_shared<const fragment>(L("..2")), 2);
+    std::vector<fragment_position> fragments{fp1, fp2, fragment_position()};
+    std::size_t read_count = 0;
+    auto s = stream_of_reader(std::make_shared<fragment_reader>([&]() {
+        return make_future_of(fragments.at(read_count++));
+    }));
+    CHECK(read_count == 0);
+
+    bool called = false;
+    s.get().then([&](const trial<stream_value> &t) {
+        REQUIRE(t);
+        CHECK(t->first == fp1);
+        CHECK(read_count == 1);
+        t->second.get().then([&](const trial<stream_value> &t) {
+            REQUIRE(t);
+            CHECK(t->first == fp2);
+            CHECK(read_count == 2);
+            t->second.get().then([&](const trial<stream_value> &t) {
+                REQUIRE(t);
+                CHECK(t->first == nullptr);
+                called = true;
+            });
+        });
+    });
+    CHECK(called);
+    CHECK(read_count == 3);
+}
+
+TEST_CASE("Stream of reader releases read fragments") {
+    std::weak_ptr<const fragment> first;
+    auto reader = std::make_shared<fragment_reader>([&first]() {
+        auto f = std::make_shared<const fragment>(L("12"));
+        if (first.expired())
+            first = f;
+        return make_future_of(fragment_position(f));
+    });
+
+    stream rest;
+    stream_of_reader(reader).get().then([&](trial<stream_value> &&t) {
+        REQUIRE(t);
+        rest = std::move(t->second);
+    });
+    CHECK_FALSE(first.expired());
+    rest.get().then([&](trial<stream_value> &&t) {
+        REQUIRE(t);
+        rest = std::move(t->second);
+    });
+    CHECK(first.expired());
+}
+
 } // namespace
 
 /* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,256 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "utf8.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <memory>
+#include <string>
+#include <utility>
+#include "async/future.hh"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/source/fragment.hh"
+#include "language/source/location.hh"
+#include "language/source/stream.hh"
+
+#if defined __AVX2__ || defined __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace sesh {
+namespace language {
+namespace source {
+
+namespace {
+
+using sesh::async::future;
+using sesh::async::make_future_of;
+using sesh::common::xchar;
+using sesh::common::xstring;
+
+static_assert(
+        sizeof(xchar) >= 4,
+        "xchar must be able to represent any Unicode code point");
+
+using byte = unsigned char;
+
+#if defined __AVX2__ || defined __SSE2__
+
+/** Returns the index of the lowest set bit of the non-zero argument. */
+std::size_t lowest_bit_index(unsigned mask) noexcept {
+    std::size_t i = 0;
+    while ((mask & 1u) == 0)
+        mask >>= 1, ++i;
+    return i;
+}
+
+#endif // #if defined __AVX2__ || defined __SSE2__
+
+/**
+ * Returns the number of ASCII bytes at the beginning of the argument range.
+ * The range is tested 16 or 32 bytes at a time with SSE2 or AVX2
+ * instructions if the compiler targets them.
+ */
+std::size_t count_ascii(const byte *begin, const byte *end) noexcept {
+    const byte *p = begin;
+#if defined __AVX2__
+    for (; end - p >= 32; p += 32) {
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))));
+        if (mask != 0)
+            return static_cast<std::size_t>(p - begin) +
+                    lowest_bit_index(mask);
+    }
+#elif defined __SSE2__
+    for (; end - p >= 16; p += 16) {
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(p))));
+        if (mask != 0)
+            return static_cast<std::size_t>(p - begin) +
+                    lowest_bit_index(mask);
+    }
+#endif // #if defined __AVX2__
+    while (p != end && *p < 0x80)
+        ++p;
+    return static_cast<std::size_t>(p - begin);
+}
+
+/** Copies the argument number of ASCII bytes to the characters. */
+void widen_ascii(const byte *p, std::size_t n, xchar *out) noexcept {
+#if defined __AVX2__ || defined __SSE2__
+    // The vector code stores 32-bit lanes.
+    if (sizeof(xchar) == sizeof(std::int32_t)) {
+        const __m128i zero = _mm_setzero_si128();
+        for (; n >= 16; n -= 16, p += 16, out += 16) {
+            __m128i x =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i low = _mm_unpacklo_epi8(x, zero);
+            __m128i high = _mm_unpackhi_epi8(x, zero);
+            auto q = reinterpret_cast<__m128i *>(out);
+            _mm_storeu_si128(q, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(q + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(q + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(q + 3, _mm_unpackhi_epi16(high, zero));
+        }
+    }
+#endif // #if defined __AVX2__ || defined __SSE2__
+    for (; n > 0; --n)
+        *out++ = static_cast<xchar>(*p++);
+}
+
+/**
+ * Decodes one multibyte sequence that starts at the argument position and
+ * returns the position after the decoded bytes. The decoded character is
+ * written to the output position, which is advanced.
+ */
+const byte *decode_sequence(const byte *p, const byte *end, xchar *&out) {
+    byte b = *p;
+    std::size_t length;
+    char32_t c;
+    byte low = 0x80, high = 0xBF; // valid range of the second byte
+    if (b >= 0xC2 && b <= 0xDF) {
+        length = 2;
+        c = b & 0x1F;
+    } else if (b >= 0xE0 && b <= 0xEF) {
+        length = 3;
+        c = b & 0x0F;
+        if (b == 0xE0)
+            low = 0xA0; // overlong
+        else if (b == 0xED)
+            high = 0x9F; // surrogate
+    } else if (b >= 0xF0 && b <= 0xF4) {
+        length = 4;
+        c = b & 0x07;
+        if (b == 0xF0)
+            low = 0x90; // overlong
+        else if (b == 0xF4)
+            high = 0x8F; // beyond U+10FFFF
+    } else {
+        *out++ = replacement_character;
+        return p + 1;
+    }
+
+    for (++p; --length > 0; ++p) {
+        if (p == end || *p < low || *p > high) {
+            *out++ = replacement_character;
+            return p;
+        }
+        c = (c << 6) | (*p & 0x3F);
+        low = 0x80;
+        high = 0xBF;
+    }
+    *out++ = static_cast<xchar>(c);
+    return p;
+}
+
+/** Decodes bytes with mbrtowc, which is slow but works in any locale. */
+void decode_in_locale(const char *p, const char *end, xstring &s) {
+    std::mbstate_t state = std::mbstate_t();
+    while (p != end) {
+        wchar_t c;
+        std::size_t n = std::mbrtowc(&c, p, end - p, &state);
+        if (n == static_cast<std::size_t>(-1) ||
+                n == static_cast<std::size_t>(-2)) {
+            s.push_back(replacement_character);
+            state = std::mbstate_t();
+            ++p;
+            continue;
+        }
+        s.push_back(c);
+        p += (n == 0) ? 1 : n;
+    }
+}
+
+class line_reader {
+
+public:
+
+    std::shared_ptr<const std::string> source;
+    std::shared_ptr<line_table> lines;
+    std::string::size_type offset;
+
+    future<fragment_position> operator()() {
+        if (offset >= source->size())
+            return make_future_of(fragment_position());
+
+        std::string::size_type end = source->find('\n', offset);
+        end = (end == std::string::npos) ? source->size() : end + 1;
+
+        xstring value;
+        decode_utf8(source->data() + offset, source->data() + end, value);
+        offset = end;
+        auto f = std::make_shared<const fragment>(std::move(value));
+        if (lines != nullptr)
+            lines->append(f);
+        return make_future_of(fragment_position(std::move(f)));
+    }
+
+}; // class line_reader
+
+} // namespace
+
+void decode_utf8(const char *begin, const char *end, xstring &s) {
+    auto p = reinterpret_cast<const byte *>(begin);
+    auto e = reinterpret_cast<const byte *>(end);
+
+    // Every byte is decoded to at most one character.
+    xstring::size_type old_size = s.size();
+    s.resize(old_size + static_cast<xstring::size_type>(e - p));
+    xchar *const data = &s[0];
+    xchar *out = data + old_size;
+
+    while (p != e) {
+        std::size_t n = count_ascii(p, e);
+        widen_ascii(p, n, out);
+        p += n;
+        out += n;
+        while (p != e && *p >= 0x80)
+            p = decode_sequence(p, e, out);
+    }
+    s.resize(static_cast<xstring::size_type>(out - data));
+}
+
+bool is_utf8_locale() {
+    const char bytes[] = "\xE3\x81\x82"; // U+3042
+    std::mbstate_t state = std::mbstate_t();
+    wchar_t c;
+    return std::mbrtowc(&c, bytes, 3, &state) == 3 && c == 0x3042;
+}
+
+void decode_multibyte(const char *begin, const char *end, xstring &s) {
+    if (is_utf8_locale())
+        decode_utf8(begin, end, s);
+    else
+        decode_in_locale(begin, end, s);
+}
+
+std::shared_ptr<fragment_reader> utf8_line_reader(
+        std::shared_ptr<const std::string> source,
+        std::shared_ptr<line_table> lines) {
+    return std::make_shared<fragment_reader>(
+            line_reader{std::move(source), std::move(lines), 0});
+}
+
+} // namespace source
+} // namespace language
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
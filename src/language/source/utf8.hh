@@ -0,0 +1,85 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_language_source_utf8_hh
+#define INCLUDED_language_source_utf8_hh
+
+#include "buildconfig.h"
+
+#include <memory>
+#include <string>
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/source/location.hh"
+#include "language/source/stream.hh"
+
+namespace sesh {
+namespace language {
+namespace source {
+
+/** The character that replaces an invalid UTF-8 sequence when decoded. */
+constexpr common::xchar replacement_character = 0xFFFD;
+
+/**
+ * Decodes the argument UTF-8 bytes and appends the characters to the argument
+ * string. Each maximal part of an invalid sequence is decoded to the {@link
+ * replacement_character}.
+ *
+ * The characters are written directly into the string buffer. Runs of ASCII
+ * bytes are found and widened 16 or 32 bytes at a time with SSE2 or AVX2
+ * instructions if the compiler targets them; only the other bytes are
+ * decoded one sequence at a time.
+ */
+void decode_utf8(const char *begin, const char *end, common::xstring &);
+
+/** Returns true if the encoding of the current C locale is UTF-8. */
+bool is_utf8_locale();
+
+/**
+ * Decodes the argument bytes in the encoding of the current C locale and
+ * appends the characters to the argument string. If the encoding is UTF-8,
+ * this function is equivalent to {@link decode_utf8}. Otherwise, the bytes
+ * are decoded one character at a time with <code>std::mbrtowc</code>. An
+ * invalid or incomplete sequence is decoded to one {@link
+ * replacement_character} per byte.
+ */
+void decode_multibyte(const char *begin, const char *end, common::xstring &);
+
+/**
+ * Returns a fragment reader that reads source code stored as UTF-8 bytes.
+ *
+ * Each call to the reader decodes the next line, including the trailing
+ * newline, into a new fragment. Only the lines that are being parsed are
+ * held as decoded characters, so source code that is kept in memory for a
+ * long time occupies about one byte per character instead of the size of
+ * {@link common::xchar}. Use with {@link stream_of_reader} to parse the
+ * source code.
+ *
+ * If a line table is given, every fragment is appended to it as the lines
+ * are read, so that locations in the source code can be looked up later.
+ */
+std::shared_ptr<fragment_reader> utf8_line_reader(
+        std::shared_ptr<const std::string>,
+        std::shared_ptr<line_table> = nullptr);
+
+} // namespace source
+} // namespace language
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_language_source_utf8_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
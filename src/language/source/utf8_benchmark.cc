@@ -0,0 +1,105 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <clocale>
+#include <cstddef>
+#include <cwchar>
+#include <iostream>
+#include <string>
+#include "common/xstring.hh"
+#include "language/source/utf8.hh"
+
+/*
+ * Measures the throughput of decoding bytes into a fragment value for three
+ * kinds of input: pure ASCII, UTF-8 text mixing ASCII and multibyte
+ * characters, and bytes that are mostly invalid sequences. The naive decoder
+ * calls mbrtowc once per character, which is what the shell would do without
+ * the bulk decoder.
+ */
+
+namespace {
+
+using sesh::common::xstring;
+using sesh::language::source::decode_multibyte;
+using sesh::language::source::decode_utf8;
+
+using clock = std::chrono::steady_clock;
+
+constexpr std::size_t input_size = 1 << 23;
+
+std::string make_input(const char *unit) {
+    std::string s;
+    while (s.size() < input_size)
+        s += unit;
+    return s;
+}
+
+void decode_naively(const char *p, const char *end, xstring &s) {
+    std::mbstate_t state = std::mbstate_t();
+    while (p != end) {
+        wchar_t c;
+        std::size_t n = std::mbrtowc(&c, p, end - p, &state);
+        if (n == static_cast<std::size_t>(-1) ||
+                n == static_cast<std::size_t>(-2)) {
+            s.push_back(0xFFFD);
+            state = std::mbstate_t();
+            ++p;
+            continue;
+        }
+        s.push_back(c);
+        p += (n == 0) ? 1 : n;
+    }
+}
+
+template<typename Decoder>
+void run(const char *name, const std::string &input, Decoder decode) {
+    xstring s;
+    clock::time_point start = clock::now();
+    decode(input.data(), input.data() + input.size(), s);
+    double ms = std::chrono::duration<double, std::milli>(
+            clock::now() - start).count();
+    std::cout << name << '\t' << input.size() << '\t' << s.size() << '\t' <<
+            ms << '\t' << input.size() / ms / 1000 << '\n';
+}
+
+void run_all(const char *name, const std::string &input) {
+    std::cout << name << ":\n";
+    run("naive", input, decode_naively);
+    run("locale", input, decode_multibyte);
+    run("utf8", input, decode_utf8);
+}
+
+} // namespace
+
+int main() {
+    if (std::setlocale(LC_CTYPE, "C.UTF-8") == nullptr)
+        std::cout << "(C.UTF-8 locale not available; "
+                "naive and locale decoders do not decode UTF-8)\n";
+
+    std::cout << "decoder\tbytes\tchars\ttime(ms)\tMB/s\n";
+    run_all("ASCII", make_input("for i in a b c; do echo \"$i\"; done\n"));
+    run_all("mixed UTF-8", make_input(
+            "echo \xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81"
+            "\xAF caf\xC3\xA9 \xF0\x9F\x98\x80\n"));
+    run_all("invalid", make_input("\x80\xFF\xC3(\xE3\x81z\xF5\n"));
+    return 0;
+}
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,153 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/source/fragment.hh"
+#include "language/source/location.hh"
+#include "language/source/utf8.hh"
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::common::trial;
+using sesh::common::xchar;
+using sesh::common::xstring;
+using sesh::language::source::decode_multibyte;
+using sesh::language::source::decode_utf8;
+using sesh::language::source::fragment_position;
+using sesh::language::source::line_and_column;
+using sesh::language::source::line_table;
+using sesh::language::source::location_of;
+using sesh::language::source::replacement_character;
+using sesh::language::source::utf8_line_reader;
+
+xstring decode(const std::string &bytes) {
+    xstring s;
+    decode_utf8(bytes.data(), bytes.data() + bytes.size(), s);
+    return s;
+}
+
+TEST_CASE("UTF-8: ASCII") {
+    CHECK(decode("") == L(""));
+    CHECK(decode("echo 'a b'\n") == L("echo 'a b'\n"));
+}
+
+TEST_CASE("UTF-8: multibyte sequences") {
+    xstring expected{
+            L('a'),
+            static_cast<xchar>(0xE9),
+            static_cast<xchar>(0x3042),
+            static_cast<xchar>(0x1F600),
+            L('z')};
+    CHECK(decode("a\xC3\xA9\xE3\x81\x82\xF0\x9F\x98\x80z") == expected);
+}
+
+TEST_CASE("UTF-8: invalid sequences are replaced") {
+    const xchar r = replacement_character;
+    // lone continuation byte
+    CHECK(decode("a\x80z") == (xstring{L('a'), r, L('z')}));
+    // overlong encoding
+    CHECK(decode("\xC0\xAF") == (xstring{r, r}));
+    CHECK(decode("\xE0\x80\xAF") == (xstring{r, r, r}));
+    // surrogate
+    CHECK(decode("\xED\xA0\x80") == (xstring{r, r, r}));
+    // beyond U+10FFFF
+    CHECK(decode("\xF4\x90\x80\x80") == (xstring{r, r, r, r}));
+    // truncated sequences
+    CHECK(decode("\xE3\x81z") == (xstring{r, L('z')}));
+    CHECK(decode("\xF0\x9F\x98") == (xstring{r}));
+}
+
+TEST_CASE("UTF-8: long runs around multibyte sequences") {
+    for (std::size_t i = 0; i < 70; ++i) {
+        std::string bytes(i, 'a');
+        bytes += "\xC3\xA9";
+        bytes += std::string(70 - i, 'b');
+        xstring expected(i, L('a'));
+        expected += static_cast<xchar>(0xE9);
+        expected += xstring(70 - i, L('b'));
+        CHECK(decode(bytes) == expected);
+    }
+}
+
+TEST_CASE("UTF-8: decoded characters are appended") {
+    xstring s = L("abc");
+    std::string bytes = "def\xE3\x81\x82";
+    decode_utf8(bytes.data(), bytes.data() + bytes.size(), s);
+    CHECK(s == xstring(L("abcdef")) + static_cast<xchar>(0x3042));
+}
+
+TEST_CASE("UTF-8: ASCII is decoded in any locale") {
+    std::string bytes = "echo ok\n";
+    xstring s;
+    decode_multibyte(bytes.data(), bytes.data() + bytes.size(), s);
+    CHECK(s == L("echo ok\n"));
+}
+
+TEST_CASE("UTF-8: line reader decodes one line per fragment") {
+    auto reader = utf8_line_reader(std::make_shared<const std::string>(
+            "echo \xC3\xA9\n\nexit"));
+    std::vector<xstring> lines;
+    for (;;) {
+        fragment_position p;
+        (*reader)().then([&p](trial<fragment_position> &&t) {
+            REQUIRE(t);
+            p = std::move(*t);
+        });
+        if (p.head == nullptr)
+            break;
+        CHECK(p.index == 0);
+        lines.push_back(p.head->value);
+    }
+    REQUIRE(lines.size() == 3);
+    CHECK(lines[0] == (xstring(L("echo ")) + static_cast<xchar>(0xE9) +
+            L('\n')));
+    CHECK(lines[1] == L("\n"));
+    CHECK(lines[2] == L("exit"));
+}
+
+TEST_CASE("UTF-8: line reader appends fragments to line table") {
+    auto table = std::make_shared<line_table>();
+    auto reader = utf8_line_reader(
+            std::make_shared<const std::string>("a\nb\n"), table);
+    fragment_position p;
+    for (int i = 0; i < 2; ++i)
+        (*reader)().then([&p](trial<fragment_position> &&t) {
+            p = std::move(*t);
+        });
+    REQUIRE(p.head != nullptr);
+
+    maybe<line_and_column> lc = table->look_up(location_of(p));
+    REQUIRE(lc);
+    CHECK(lc->line == 2);
+    CHECK(lc->column == 1);
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
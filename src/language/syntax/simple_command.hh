@@ -20,7 +20,7 @@
 
 #include "buildconfig.h"
 
-#include <vector>
+#include "common/arena.hh"
 #include "language/syntax/word.hh"
 
 namespace sesh {
@@ -39,7 +39,10 @@ class simple_command {
 
 public:
 
-    std::vector<word> words;
+    /** The vector may be allocated in the arena of the syntax tree. */
+    using word_list = common::arena_vector<word>;
+
+    word_list words;
     // TODO assignments
     // TODO redirections
 
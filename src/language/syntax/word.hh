@@ -21,7 +21,7 @@
 #include "buildconfig.h"
 
 #include <memory>
-#include <vector>
+#include "common/arena.hh"
 #include "language/syntax/word_component.hh"
 
 namespace sesh {
@@ -36,7 +36,10 @@ public:
     /** The type of pointers to a word component. Pointers must not be null. */
     using component_pointer = std::shared_ptr<const word_component>;
 
-    std::vector<component_pointer> components;
+    /** The vector may be allocated in the arena of the syntax tree. */
+    using component_list = common::arena_vector<component_pointer>;
+
+    component_list components;
 
 }; // class word
 
@@ -18,13 +18,17 @@
 #include "buildconfig.h"
 #include "api.hh"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <new>
 #include <stdexcept>
 #include <system_error>
+#include <vector>
 #include "common/enum_iterator.hh"
+#include "common/either.hh"
 #include "common/enum_set.hh"
 #include "common/errno_helper.hh"
 #include "common/type_tag.hh"
@@ -37,6 +41,8 @@
 #include "os/io/file_descriptor.hh"
 #include "os/io/file_descriptor_open_mode.hh"
 #include "os/io/file_descriptor_set.hh"
+#include "os/io/io_ring_api.hh"
+#include "os/io/mapped_file_api.hh"
 #include "os/io/file_mode.hh"
 #include "os/signaling/signal_number.hh"
 #include "os/signaling/signal_number_set.hh"
@@ -44,6 +50,7 @@
 using sesh::common::enum_set;
 using sesh::common::enumerators;
 using sesh::common::errno_code;
+using sesh::common::maybe;
 using sesh::common::type_tag;
 using sesh::common::variant;
 using sesh::os::io::file_description_access_mode;
@@ -52,6 +59,8 @@ using sesh::os::io::file_description_status;
 using sesh::os::io::file_descriptor;
 using sesh::os::io::file_descriptor_open_mode;
 using sesh::os::io::file_descriptor_set;
+using sesh::os::io::io_ring;
+using sesh::os::io::mapped_file;
 using sesh::os::io::file_mode;
 using sesh::os::signaling::signal_number;
 using sesh::os::signaling::signal_number_set;
@@ -314,6 +323,82 @@ public:
 
 }; // class file_descriptor_set_impl
 
+/** Position of file descriptors not in a dynamic_file_descriptor_set_impl. */
+constexpr std::size_t absent = std::numeric_limits<std::size_t>::max();
+
+/**
+ * File descriptor set used with ppoll. Unlike fd_set, this set has no upper
+ * limit of file descriptors; it grows as needed. The members are kept in a
+ * list so that they can be enumerated in time proportional to their number
+ * rather than to the largest file descriptor.
+ */
+class dynamic_file_descriptor_set_impl : public file_descriptor_set {
+
+private:
+
+    /** File descriptors in this set, in no particular order. */
+    std::vector<file_descriptor::value_type> m_members;
+
+    /** Maps file descriptors to indices into m_members. */
+    std::vector<std::size_t> m_positions;
+
+    void insert(file_descriptor::value_type fd) {
+        if (static_cast<std::size_t>(fd) >= m_positions.size())
+            m_positions.resize(fd + 1, absent);
+        if (m_positions[fd] != absent)
+            return;
+        m_positions[fd] = m_members.size();
+        m_members.push_back(fd);
+    }
+
+    void remove(file_descriptor::value_type fd) {
+        if (!test(fd))
+            return;
+        std::size_t i = m_positions[fd];
+        file_descriptor::value_type last = m_members.back();
+        m_members[i] = last;
+        m_positions[last] = i;
+        m_members.pop_back();
+        m_positions[fd] = absent;
+    }
+
+public:
+
+    file_descriptor::value_type max_value() const override {
+        return std::numeric_limits<file_descriptor::value_type>::max() - 1;
+    }
+
+    /** Returns the file descriptors in this set in no particular order. */
+    const std::vector<file_descriptor::value_type> &members() const noexcept {
+        return m_members;
+    }
+
+    bool test(file_descriptor::value_type fd) const override {
+        return fd >= 0 &&
+                static_cast<std::size_t>(fd) < m_positions.size() &&
+                m_positions[fd] != absent;
+    }
+
+    file_descriptor_set &set(file_descriptor::value_type fd, bool value)
+            override {
+        if (fd < 0 || fd > max_value())
+            throw std::domain_error("bad file descriptor");
+        if (value)
+            insert(fd);
+        else
+            remove(fd);
+        return *this;
+    }
+
+    file_descriptor_set &reset() override {
+        for (file_descriptor::value_type fd : m_members)
+            m_positions[fd] = absent;
+        m_members.clear();
+        return *this;
+    }
+
+}; // class dynamic_file_descriptor_set_impl
+
 class signal_number_set_impl : public signal_number_set {
 
 private:
@@ -375,8 +460,108 @@ public:
 
 }; // class signal_number_set_impl
 
+class io_ring_impl : public io_ring {
+
+private:
+
+    std::unique_ptr<struct sesh_osapi_io_ring> m_ring;
+
+public:
+
+    explicit io_ring_impl(std::unique_ptr<struct sesh_osapi_io_ring> &&ring)
+            noexcept :
+            m_ring(std::move(ring)) { }
+
+    file_descriptor::value_type value() const noexcept final override {
+        return sesh_osapi_io_ring_fd(m_ring.get());
+    }
+
+    std::error_code prepare_read(
+            const file_descriptor &fd,
+            void *buffer,
+            std::size_t max_bytes_to_read,
+            user_data data) final override {
+        if (sesh_osapi_io_ring_prepare_read(
+                m_ring.get(), fd.value(), buffer, max_bytes_to_read, data)
+                == 0)
+            return std::error_code();
+        return errno_code();
+    }
+
+    std::error_code prepare_write(
+            const file_descriptor &fd,
+            const void *bytes,
+            std::size_t bytes_to_write,
+            user_data data) final override {
+        if (sesh_osapi_io_ring_prepare_write(
+                m_ring.get(), fd.value(), bytes, bytes_to_write, data) == 0)
+            return std::error_code();
+        return errno_code();
+    }
+
+    std::error_code submit() final override {
+        if (sesh_osapi_io_ring_submit(m_ring.get()) == 0)
+            return std::error_code();
+        return errno_code();
+    }
+
+    maybe<completion> pop_completion() final override {
+        unsigned long long data;
+        long long result;
+        if (!sesh_osapi_io_ring_pop_completion(m_ring.get(), &data, &result))
+            return maybe<completion>();
+        if (result < 0)
+            return completion{
+                    data,
+                    std::make_error_code(static_cast<std::errc>(-result))};
+        return completion{data, static_cast<std::size_t>(result)};
+    }
+
+}; // class io_ring_impl
+
+class mapped_file_impl : public mapped_file {
+
+private:
+
+    const void *m_address;
+    std::size_t m_size;
+    time_api::system_clock_time m_modification_time;
+
+public:
+
+    mapped_file_impl(
+            const void *address,
+            std::size_t size,
+            time_api::system_clock_time modification_time) noexcept :
+            m_address(address),
+            m_size(size),
+            m_modification_time(modification_time) { }
+
+    mapped_file_impl(const mapped_file_impl &) = delete;
+    mapped_file_impl &operator=(const mapped_file_impl &) = delete;
+
+    ~mapped_file_impl() override {
+        sesh_osapi_unmap_file(m_address, m_size);
+    }
+
+    const char *data() const noexcept final override {
+        return static_cast<const char *>(m_address);
+    }
+
+    std::size_t size() const noexcept final override { return m_size; }
+
+    time_api::system_clock_time modification_time() const noexcept
+            final override {
+        return m_modification_time;
+    }
+
+}; // class mapped_file_impl
+
 class api_impl : public api {
 
+    /** Reused by the ppoll function. May be null. */
+    mutable std::unique_ptr<struct sesh_osapi_pollfds> m_pollfds;
+
     system_clock_time system_clock_now() const noexcept final override {
         return std::chrono::time_point_cast<system_clock_time::duration>(
                 system_clock_time::clock::now());
@@ -462,7 +647,11 @@ class api_impl : public api {
 
     std::unique_ptr<file_descriptor_set> create_file_descriptor_set() const
             final override {
-        std::unique_ptr<file_descriptor_set> set(new file_descriptor_set_impl);
+        std::unique_ptr<file_descriptor_set> set;
+        if (sesh_osapi_ppoll_is_supported())
+            set.reset(new dynamic_file_descriptor_set_impl);
+        else
+            set.reset(new file_descriptor_set_impl);
         return set;
     }
 
@@ -472,6 +661,90 @@ class api_impl : public api {
         return set;
     }
 
+    /**
+     * Implements the pselect function using ppoll. The pollfd array is kept
+     * in this object and reused across calls.
+     */
+    std::error_code ppoll(
+            file_descriptor::value_type fd_bound,
+            file_descriptor_set *read_fds,
+            file_descriptor_set *write_fds,
+            file_descriptor_set *error_fds,
+            std::chrono::nanoseconds timeout,
+            const signal_number_set *signal_mask) const {
+        if (m_pollfds == nullptr) {
+            m_pollfds.reset(sesh_osapi_pollfds_new());
+            if (m_pollfds == nullptr)
+                throw std::bad_alloc();
+        }
+
+        using set_impl = dynamic_file_descriptor_set_impl;
+        const set_impl *sets[] = {
+            static_cast<const set_impl *>(read_fds),
+            static_cast<const set_impl *>(write_fds),
+            static_cast<const set_impl *>(error_fds),
+        };
+        const int events_of[] = {
+            SESH_OSAPI_POLLIN, SESH_OSAPI_POLLOUT, SESH_OSAPI_POLLPRI,
+        };
+
+        // Each file descriptor is added once, when it is found in the first
+        // set that contains it, with the events of all the sets.
+        struct sesh_osapi_pollfds *fds = m_pollfds.get();
+        sesh_osapi_pollfds_clear(fds);
+        for (std::size_t i = 0; i < 3; ++i) {
+            if (sets[i] == nullptr)
+                continue;
+            for (file_descriptor::value_type fd : sets[i]->members()) {
+                if (fd >= fd_bound)
+                    continue;
+
+                bool added = false;
+                for (std::size_t j = 0; j < i; ++j)
+                    if (sets[j] != nullptr && sets[j]->test(fd))
+                        added = true;
+                if (added)
+                    continue;
+
+                int events = 0;
+                for (std::size_t j = i; j < 3; ++j)
+                    if (sets[j] != nullptr && sets[j]->test(fd))
+                        events |= events_of[j];
+                if (sesh_osapi_pollfds_add(fds, fd, events) != 0)
+                    return errno_code();
+            }
+        }
+
+        const signal_number_set_impl *signal_mask_impl =
+                static_cast<const signal_number_set_impl *>(signal_mask);
+        int ppoll_result = sesh_osapi_ppoll(
+                fds,
+                timeout.count(),
+                signal_mask == nullptr ? nullptr : signal_mask_impl->get());
+        if (ppoll_result < 0)
+            return errno_code();
+
+        // Convert the result to that of pselect. Like pselect, a hang-up or
+        // error makes the file descriptor both readable and writable.
+        const int readable =
+                SESH_OSAPI_POLLIN | SESH_OSAPI_POLLHUP | SESH_OSAPI_POLLERR;
+        const int writable = SESH_OSAPI_POLLOUT | SESH_OSAPI_POLLERR;
+        std::size_t size = sesh_osapi_pollfds_size(fds);
+        for (std::size_t i = 0; i < size; ++i) {
+            file_descriptor::value_type fd = sesh_osapi_pollfds_fd(fds, i);
+            int revents = sesh_osapi_pollfds_revents(fds, i);
+            if (revents & SESH_OSAPI_POLLNVAL)
+                return std::make_error_code(std::errc::bad_file_descriptor);
+            if (read_fds != nullptr && read_fds->test(fd))
+                read_fds->set(fd, revents & readable);
+            if (write_fds != nullptr && write_fds->test(fd))
+                write_fds->set(fd, revents & writable);
+            if (error_fds != nullptr && error_fds->test(fd))
+                error_fds->set(fd, revents & SESH_OSAPI_POLLPRI);
+        }
+        return std::error_code();
+    }
+
     std::error_code pselect(
                 file_descriptor::value_type fd_bound,
                 file_descriptor_set *read_fds,
@@ -479,6 +752,15 @@ class api_impl : public api {
                 file_descriptor_set *error_fds,
                 std::chrono::nanoseconds timeout,
                 const signal_number_set *signal_mask) const final override {
+        if (sesh_osapi_ppoll_is_supported())
+            return ppoll(
+                    fd_bound,
+                    read_fds,
+                    write_fds,
+                    error_fds,
+                    timeout,
+                    signal_mask);
+
         file_descriptor_set_impl *read_fds_impl =
                 static_cast<file_descriptor_set_impl *>(read_fds);
         file_descriptor_set_impl *write_fds_impl =
@@ -495,11 +777,89 @@ class api_impl : public api {
                 error_fds == nullptr ? nullptr : error_fds_impl->get(),
                 timeout.count(),
                 signal_mask == nullptr ? nullptr : signal_mask_impl->get());
-        if (pselect_result == 0)
+        if (pselect_result >= 0)
+            return std::error_code();
+        return errno_code();
+    }
+
+    variant<file_descriptor, std::error_code> epoll_create() const
+            final override {
+        int fd = sesh_osapi_epoll_create();
+        if (fd < 0)
+            return errno_code();
+        return file_descriptor(fd);
+    }
+
+    std::error_code epoll_ctl(
+            const file_descriptor &epoll,
+            control_operation op,
+            file_descriptor::value_type fd,
+            condition_set conditions) const final override {
+        enum sesh_osapi_epoll_ctl_op op_impl;
+
+        switch (op) {
+        case control_operation::add:
+            op_impl = SESH_OSAPI_EPOLL_CTL_ADD;
+            break;
+        case control_operation::modify:
+            op_impl = SESH_OSAPI_EPOLL_CTL_MOD;
+            break;
+        case control_operation::remove:
+            op_impl = SESH_OSAPI_EPOLL_CTL_DEL;
+            break;
+        }
+
+        int events = 0;
+        if (conditions[condition::readable])
+            events |= SESH_OSAPI_EPOLLIN;
+        if (conditions[condition::writable])
+            events |= SESH_OSAPI_EPOLLOUT;
+        if (conditions[condition::error])
+            events |= SESH_OSAPI_EPOLLPRI;
+
+        if (sesh_osapi_epoll_ctl(epoll.value(), op_impl, fd, events) == 0)
             return std::error_code();
         return errno_code();
     }
 
+    std::error_code epoll_pwait(
+            const file_descriptor &epoll,
+            std::vector<event> &events,
+            std::size_t max_events,
+            std::chrono::nanoseconds timeout,
+            const signal_number_set *signal_mask) const final override {
+        const signal_number_set_impl *signal_mask_impl =
+                static_cast<const signal_number_set_impl *>(signal_mask);
+
+        struct sesh_osapi_epoll_event raw_events[64];
+        int max_raw_events = static_cast<int>(
+                std::min(max_events, sizeof raw_events / sizeof *raw_events));
+
+        events.clear();
+        int count = sesh_osapi_epoll_pwait(
+                epoll.value(),
+                raw_events,
+                max_raw_events,
+                timeout.count(),
+                signal_mask == nullptr ? nullptr : signal_mask_impl->get());
+        if (count < 0)
+            return errno_code();
+
+        for (int i = 0; i < count; ++i) {
+            const int flags = raw_events[i].events;
+            condition_set conditions;
+            if (flags & (SESH_OSAPI_EPOLLIN | SESH_OSAPI_EPOLLHUP |
+                        SESH_OSAPI_EPOLLERR))
+                conditions.set(condition::readable);
+            if (flags & (SESH_OSAPI_EPOLLOUT | SESH_OSAPI_EPOLLERR))
+                conditions.set(condition::writable);
+            if (flags & SESH_OSAPI_EPOLLPRI)
+                conditions.set(condition::error);
+            events.push_back(event{raw_events[i].fd, conditions});
+        }
+        return std::error_code();
+    }
+
     std::error_code sigprocmask(
             mask_change_how how,
             const signaling::signal_number_set *new_mask,
@@ -555,6 +915,66 @@ class api_impl : public api {
         return std::error_code();
     }
 
+    variant<std::unique_ptr<io_ring>, std::error_code> create_io_ring(
+            unsigned entries) const final override {
+        std::unique_ptr<struct sesh_osapi_io_ring> ring(
+                sesh_osapi_io_ring_new(entries));
+        if (ring == nullptr)
+            return errno_code();
+        return std::unique_ptr<io_ring>(new io_ring_impl(std::move(ring)));
+    }
+
+    variant<std::unique_ptr<mapped_file>, std::error_code> map_file(
+            const file_descriptor &fd) const final override {
+        std::size_t size;
+        long long modification_time;
+        const void *address =
+                sesh_osapi_map_file(fd.value(), &size, &modification_time);
+        if (address == nullptr)
+            return errno_code();
+        auto time = time_api::system_clock_time(
+                std::chrono::nanoseconds(modification_time));
+        return std::unique_ptr<mapped_file>(
+                new mapped_file_impl(address, size, time));
+    }
+
+    std::error_code signalfd(
+            file_descriptor &fd, const signal_number_set &mask) const
+            final override {
+        const signal_number_set_impl &mask_impl =
+                static_cast<const signal_number_set_impl &>(mask);
+
+        int result = sesh_osapi_signalfd(
+                fd.is_valid() ? fd.value() : file_descriptor::invalid_value,
+                mask_impl.get());
+        if (result < 0)
+            return errno_code();
+        if (!fd.is_valid())
+            fd = file_descriptor(result);
+        return std::error_code();
+    }
+
+    std::error_code read_signalfd(
+            const file_descriptor &fd,
+            std::vector<signal_number> &signals,
+            std::size_t max_signals) const final override {
+        int raw_signals[64];
+        int max_raw_signals = static_cast<int>(std::min(
+                max_signals, sizeof raw_signals / sizeof *raw_signals));
+
+        int count = sesh_osapi_read_signalfd(
+                fd.value(), raw_signals, max_raw_signals);
+        if (count < 0)
+            return errno_code();
+
+        signals.insert(signals.end(), raw_signals, raw_signals + count);
+        return std::error_code();
+    }
+
+    std::error_code close_signalfd(file_descriptor &fd) const final override {
+        return close(fd);
+    }
+
 }; // class api_impl
 
 } // namespace
@@ -20,9 +20,11 @@
 
 #include "buildconfig.h"
 
-#include "os/event/pselect_api.hh"
+#include "os/event/epoll_api.hh"
 #include "os/io/file_description_api.hh"
 #include "os/io/file_descriptor_api.hh"
+#include "os/io/io_ring_api.hh"
+#include "os/io/mapped_file_api.hh"
 #include "os/io/reader_api.hh"
 #include "os/io/writer_api.hh"
 #include "os/signaling/handler_configuration_api.hh"
@@ -32,9 +34,11 @@ namespace os {
 
 /** Abstraction of POSIX API. */
 class api :
-        public event::pselect_api,
+        public event::epoll_api,
         public io::file_description_api,
-        public io::file_descriptor_api,
+        public virtual io::file_descriptor_api,
+        public io::io_ring_api,
+        public io::mapped_file_api,
         public io::reader_api,
         public io::writer_api,
         public signaling::handler_configuration_api {
@@ -22,11 +22,32 @@
 #include <fcntl.h>
 #include <limits.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/select.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include "helpermacros.h"
+#if HAVE_POLL_H
+#include <poll.h>
+#endif
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+#if HAVE_SYS_SIGNALFD_H
+#include <sys/signalfd.h>
+#endif
+#if HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#if defined __NR_io_uring_setup && defined __NR_io_uring_enter && \
+        defined IORING_FEAT_RW_CUR_POS
+#define SESH_OSAPI_HAVE_IO_URING 1
+#endif
+#endif
 
 int sesh_osapi_fcntl_file_access_mode_to_raw(
         enum sesh_osapi_fcntl_file_access_mode mode) {
@@ -211,6 +232,42 @@ size_t sesh_osapi_write(int fd, const void *bytes, size_t bytesToWrite){
     return (size_t) bytesWritten;
 }
 
+const void *sesh_osapi_map_file(
+        int fd, size_t *size, long long *modification_time_in_nanoseconds) {
+    static const char empty_file[1];
+    struct stat st;
+    void *address;
+
+    if (fstat(fd, &st) < 0)
+        return NULL;
+    if (!S_ISREG(st.st_mode)) {
+        errno = ENODEV;
+        return NULL;
+    }
+    if ((uintmax_t) st.st_size > SIZE_MAX) {
+        errno = EFBIG;
+        return NULL;
+    }
+
+    *modification_time_in_nanoseconds =
+            (long long) st.st_mtim.tv_sec * 1000000000LL +
+            st.st_mtim.tv_nsec;
+    *size = (size_t) st.st_size;
+    if (*size == 0)
+        return empty_file;
+
+    address = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+        return NULL;
+    return address;
+}
+
+int sesh_osapi_unmap_file(const void *address, size_t size) {
+    if (size == 0)
+        return 0;
+    return munmap((void *) address, size);
+}
+
 int sesh_osapi_fd_setsize(void) {
     return FD_SETSIZE;
 }
@@ -220,7 +277,7 @@ struct sesh_osapi_fd_set {
 };
 
 struct sesh_osapi_fd_set *sesh_osapi_fd_set_new(void) {
-    return malloc(sizeof(struct sesh_osapi_fd_set *));
+    return malloc(sizeof(struct sesh_osapi_fd_set));
 }
 
 void sesh_osapi_fd_set_delete(struct sesh_osapi_fd_set *set) {
@@ -281,6 +338,34 @@ void sesh_osapi_sigcopyset(
     *to = *from;
 }
 
+/**
+ * Converts a timeout in nanoseconds to the timespec structure. Returns null
+ * for a negative timeout, which means no timeout.
+ */
+static struct timespec *to_timespec(long long timeout, struct timespec *ts) {
+    const long long nanoseconds_per_second = 1000000000LL;
+    lldiv_t v;
+
+    if (timeout < 0)
+        return NULL;
+
+    v = lldiv(timeout, nanoseconds_per_second);
+
+    // POSIX requires that a timeout of at least 31 days be supported.
+    // Which means time_t is large enough to hold a value of at least 31
+    // days. Any larger value may not be safely cast to time_t, so we clamp
+    // it before casting. Particularly, we need to avoid arithmetic
+    // overflow yielding a negative timeout value.
+    const long long seconds_per_day = 24 * 60 * 60;
+    const long long max_timeout_seconds = 31 * seconds_per_day;
+    if (v.quot > max_timeout_seconds)
+        v.quot = max_timeout_seconds;
+
+    ts->tv_sec = (time_t) v.quot;
+    ts->tv_nsec = (long) v.rem;
+    return ts;
+}
+
 int sesh_osapi_pselect(
         int fd_bound,
         struct sesh_osapi_fd_set *read_fds,
@@ -288,39 +373,581 @@ int sesh_osapi_pselect(
         struct sesh_osapi_fd_set *error_fds,
         long long timeout,
         const struct sesh_osapi_sigset *signal_mask) {
-    const long long nanoseconds_per_second = 1000000000LL;
     struct timespec timeout_spec;
-    struct timespec *timeout_spec_p;
-
-    if (timeout < 0) {
-        timeout_spec_p = NULL;
-    } else {
-        lldiv_t v = lldiv(timeout, nanoseconds_per_second);
-
-        // POSIX requires that a timeout of at least 31 days be supported.
-        // Which means time_t is large enough to hold a value of at least 31
-        // days. Any larger value may not be safely cast to time_t, so we clamp
-        // it before casting. Particularly, we need to avoid arithmetic
-        // overflow yielding a negative timeout value.
-        const long long seconds_per_day = 24 * 60 * 60;
-        const long long max_timeout_seconds = 31 * seconds_per_day;
-        if (v.quot > max_timeout_seconds)
-            v.quot = max_timeout_seconds;
-
-        timeout_spec.tv_sec = (time_t) v.quot;
-        timeout_spec.tv_nsec = (long) v.rem;
-        timeout_spec_p = &timeout_spec;
-    }
 
     return pselect(
             fd_bound,
             read_fds != NULL ? &read_fds->value : NULL,
             write_fds != NULL ? &write_fds->value : NULL,
             error_fds != NULL ? &error_fds->value : NULL,
-            timeout_spec_p,
+            to_timespec(timeout, &timeout_spec),
+            signal_mask != NULL ? &signal_mask->value : NULL);
+}
+
+#if HAVE_POLL_H && HAVE_PPOLL
+
+int sesh_osapi_ppoll_is_supported(void) {
+    return 1;
+}
+
+struct sesh_osapi_pollfds {
+    struct pollfd *values;
+    size_t size, capacity;
+};
+
+struct sesh_osapi_pollfds *sesh_osapi_pollfds_new(void) {
+    struct sesh_osapi_pollfds *fds = malloc(sizeof *fds);
+    if (fds != NULL) {
+        fds->values = NULL;
+        fds->size = fds->capacity = 0;
+    }
+    return fds;
+}
+
+void sesh_osapi_pollfds_delete(struct sesh_osapi_pollfds *fds) {
+    if (fds != NULL)
+        free(fds->values);
+    free(fds);
+}
+
+void sesh_osapi_pollfds_clear(struct sesh_osapi_pollfds *fds) {
+    fds->size = 0;
+}
+
+static short poll_events_to_raw(int events) {
+    short raw = 0;
+    if (events & SESH_OSAPI_POLLIN)
+        raw |= POLLIN;
+    if (events & SESH_OSAPI_POLLOUT)
+        raw |= POLLOUT;
+    if (events & SESH_OSAPI_POLLPRI)
+        raw |= POLLPRI;
+    return raw;
+}
+
+static int poll_events_from_raw(short raw) {
+    int events = 0;
+    if (raw & POLLIN)
+        events |= SESH_OSAPI_POLLIN;
+    if (raw & POLLOUT)
+        events |= SESH_OSAPI_POLLOUT;
+    if (raw & POLLPRI)
+        events |= SESH_OSAPI_POLLPRI;
+    if (raw & POLLERR)
+        events |= SESH_OSAPI_POLLERR;
+    if (raw & POLLHUP)
+        events |= SESH_OSAPI_POLLHUP;
+    if (raw & POLLNVAL)
+        events |= SESH_OSAPI_POLLNVAL;
+    return events;
+}
+
+int sesh_osapi_pollfds_add(
+        struct sesh_osapi_pollfds *fds, int fd, int events) {
+    if (fds->size == fds->capacity) {
+        size_t new_capacity = fds->capacity == 0 ? 16 : fds->capacity * 2;
+        struct pollfd *new_values;
+
+        if (new_capacity > SIZE_MAX / sizeof *new_values) {
+            errno = ENOMEM;
+            return -1;
+        }
+        new_values = realloc(fds->values, new_capacity * sizeof *new_values);
+        if (new_values == NULL)
+            return -1;
+        fds->values = new_values;
+        fds->capacity = new_capacity;
+    }
+
+    fds->values[fds->size].fd = fd;
+    fds->values[fds->size].events = poll_events_to_raw(events);
+    fds->values[fds->size].revents = 0;
+    fds->size++;
+    return 0;
+}
+
+size_t sesh_osapi_pollfds_size(const struct sesh_osapi_pollfds *fds) {
+    return fds->size;
+}
+
+int sesh_osapi_pollfds_fd(const struct sesh_osapi_pollfds *fds, size_t i) {
+    return fds->values[i].fd;
+}
+
+int sesh_osapi_pollfds_revents(
+        const struct sesh_osapi_pollfds *fds, size_t i) {
+    return poll_events_from_raw(fds->values[i].revents);
+}
+
+int sesh_osapi_ppoll(
+        struct sesh_osapi_pollfds *fds,
+        long long timeout,
+        const struct sesh_osapi_sigset *signal_mask) {
+    struct timespec timeout_spec;
+
+    return ppoll(
+            fds->values,
+            (nfds_t) fds->size,
+            to_timespec(timeout, &timeout_spec),
+            signal_mask != NULL ? &signal_mask->value : NULL);
+}
+
+#else // #if HAVE_POLL_H && HAVE_PPOLL
+
+int sesh_osapi_ppoll_is_supported(void) {
+    return 0;
+}
+
+struct sesh_osapi_pollfds *sesh_osapi_pollfds_new(void) {
+    errno = ENOSYS;
+    return NULL;
+}
+
+void sesh_osapi_pollfds_delete(struct sesh_osapi_pollfds *fds) {
+    (void) fds;
+}
+
+void sesh_osapi_pollfds_clear(struct sesh_osapi_pollfds *fds) {
+    (void) fds;
+}
+
+int sesh_osapi_pollfds_add(
+        struct sesh_osapi_pollfds *fds, int fd, int events) {
+    (void) fds, (void) fd, (void) events;
+    errno = ENOSYS;
+    return -1;
+}
+
+size_t sesh_osapi_pollfds_size(const struct sesh_osapi_pollfds *fds) {
+    (void) fds;
+    return 0;
+}
+
+int sesh_osapi_pollfds_fd(const struct sesh_osapi_pollfds *fds, size_t i) {
+    (void) fds, (void) i;
+    return -1;
+}
+
+int sesh_osapi_pollfds_revents(
+        const struct sesh_osapi_pollfds *fds, size_t i) {
+    (void) fds, (void) i;
+    return 0;
+}
+
+int sesh_osapi_ppoll(
+        struct sesh_osapi_pollfds *fds,
+        long long timeout,
+        const struct sesh_osapi_sigset *signal_mask) {
+    (void) fds, (void) timeout, (void) signal_mask;
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif // #if HAVE_POLL_H && HAVE_PPOLL
+
+#if HAVE_SYS_EPOLL_H
+
+int sesh_osapi_epoll_create(void) {
+    return epoll_create1(EPOLL_CLOEXEC);
+}
+
+static uint32_t epoll_events_to_raw(int events) {
+    uint32_t raw = 0;
+    if (events & SESH_OSAPI_EPOLLIN)
+        raw |= EPOLLIN;
+    if (events & SESH_OSAPI_EPOLLOUT)
+        raw |= EPOLLOUT;
+    if (events & SESH_OSAPI_EPOLLPRI)
+        raw |= EPOLLPRI;
+    return raw;
+}
+
+static int epoll_events_from_raw(uint32_t raw) {
+    int events = 0;
+    if (raw & EPOLLIN)
+        events |= SESH_OSAPI_EPOLLIN;
+    if (raw & EPOLLOUT)
+        events |= SESH_OSAPI_EPOLLOUT;
+    if (raw & EPOLLPRI)
+        events |= SESH_OSAPI_EPOLLPRI;
+    if (raw & EPOLLERR)
+        events |= SESH_OSAPI_EPOLLERR;
+    if (raw & EPOLLHUP)
+        events |= SESH_OSAPI_EPOLLHUP;
+    return events;
+}
+
+int sesh_osapi_epoll_ctl(
+        int epoll_fd, enum sesh_osapi_epoll_ctl_op op, int fd, int events) {
+    struct epoll_event event;
+    int raw_op;
+
+    raw_op = -1; // dummy initialization to dumb warning
+
+    switch (op) {
+    case SESH_OSAPI_EPOLL_CTL_ADD: raw_op = EPOLL_CTL_ADD; break;
+    case SESH_OSAPI_EPOLL_CTL_MOD: raw_op = EPOLL_CTL_MOD; break;
+    case SESH_OSAPI_EPOLL_CTL_DEL: raw_op = EPOLL_CTL_DEL; break;
+    }
+
+    event.events = epoll_events_to_raw(events);
+    event.data.fd = fd;
+    return epoll_ctl(epoll_fd, raw_op, fd, &event);
+}
+
+int sesh_osapi_epoll_pwait(
+        int epoll_fd,
+        struct sesh_osapi_epoll_event *events,
+        int max_events,
+        long long timeout,
+        const struct sesh_osapi_sigset *signal_mask) {
+    const long long nanoseconds_per_millisecond = 1000000LL;
+    struct epoll_event raw_events[64];
+    int timeout_ms, count, i;
+
+    if (timeout < 0) {
+        timeout_ms = -1;
+    } else {
+        // Round up so that we never wake up before the timeout expires.
+        long long ms = timeout / nanoseconds_per_millisecond;
+        if (timeout % nanoseconds_per_millisecond != 0)
+            ms++;
+        timeout_ms = ms > INT_MAX ? INT_MAX : (int) ms;
+    }
+
+    if (max_events > (int) (sizeof raw_events / sizeof *raw_events))
+        max_events = (int) (sizeof raw_events / sizeof *raw_events);
+
+    count = epoll_pwait(
+            epoll_fd,
+            raw_events,
+            max_events,
+            timeout_ms,
             signal_mask != NULL ? &signal_mask->value : NULL);
+
+    for (i = 0; i < count; i++) {
+        events[i].fd = raw_events[i].data.fd;
+        events[i].events = epoll_events_from_raw(raw_events[i].events);
+    }
+    return count;
+}
+
+#else // #if HAVE_SYS_EPOLL_H
+
+int sesh_osapi_epoll_create(void) {
+    errno = ENOSYS;
+    return -1;
+}
+
+int sesh_osapi_epoll_ctl(
+        int epoll_fd, enum sesh_osapi_epoll_ctl_op op, int fd, int events) {
+    (void) epoll_fd, (void) op, (void) fd, (void) events;
+    errno = ENOSYS;
+    return -1;
+}
+
+int sesh_osapi_epoll_pwait(
+        int epoll_fd,
+        struct sesh_osapi_epoll_event *events,
+        int max_events,
+        long long timeout,
+        const struct sesh_osapi_sigset *signal_mask) {
+    (void) epoll_fd, (void) events, (void) max_events, (void) timeout,
+            (void) signal_mask;
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif // #if HAVE_SYS_EPOLL_H
+
+#if SESH_OSAPI_HAVE_IO_URING
+
+/** User data of the poll requests that precede reads and writes. */
+static const unsigned long long io_ring_internal_user_data = ~0ULL;
+
+struct sesh_osapi_io_ring {
+    int fd;
+    unsigned sq_entries;
+    unsigned unsubmitted;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+};
+
+static void io_ring_unmap(struct sesh_osapi_io_ring *ring) {
+    if (ring->sqes != MAP_FAILED)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    if (ring->sq_ring != MAP_FAILED)
+        munmap(ring->sq_ring, ring->sq_ring_size);
 }
 
+struct sesh_osapi_io_ring *sesh_osapi_io_ring_new(unsigned entries) {
+    struct io_uring_params params;
+    struct sesh_osapi_io_ring *ring;
+    char *sq, *cq;
+    int saved_errno;
+
+    ring = malloc(sizeof *ring);
+    if (ring == NULL)
+        return NULL;
+
+    memset(&params, 0, sizeof params);
+    ring->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        free(ring);
+        return NULL;
+    }
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        // Reads and writes at the current file offset are not supported.
+        close(ring->fd);
+        free(ring);
+        errno = ENOSYS;
+        return NULL;
+    }
+
+    ring->sq_entries = params.sq_entries;
+    ring->unsubmitted = 0;
+    ring->sq_ring_size =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes +
+            params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size)
+            ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->cq_ring = ring->sqes = MAP_FAILED;
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size,
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED)
+        goto fail;
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size,
+                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED)
+            goto fail;
+    }
+    ring->sqes = mmap(NULL, ring->sqes_size,
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+        goto fail;
+
+    sq = ring->sq_ring;
+    ring->sq_head = (unsigned *) (sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *) (sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *) (sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *) (sq + params.sq_off.array);
+    cq = ring->cq_ring;
+    ring->cq_head = (unsigned *) (cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *) (cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *) (cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+    return ring;
+
+fail:
+    saved_errno = errno;
+    io_ring_unmap(ring);
+    close(ring->fd);
+    free(ring);
+    errno = saved_errno;
+    return NULL;
+}
+
+void sesh_osapi_io_ring_delete(struct sesh_osapi_io_ring *ring) {
+    if (ring == NULL)
+        return;
+    io_ring_unmap(ring);
+    close(ring->fd);
+    free(ring);
+}
+
+int sesh_osapi_io_ring_fd(const struct sesh_osapi_io_ring *ring) {
+    return ring->fd;
+}
+
+/** Returns the next free submission queue entry without publishing it. */
+static struct io_uring_sqe *io_ring_entry(
+        struct sesh_osapi_io_ring *ring, unsigned offset) {
+    unsigned tail = *ring->sq_tail + offset;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+
+    memset(sqe, 0, sizeof *sqe);
+    ring->sq_array[index] = index;
+    return sqe;
+}
+
+/** Queues a poll request linked to a read or write request. */
+static int io_ring_prepare_rw(
+        struct sesh_osapi_io_ring *ring,
+        int opcode,
+        int poll_events,
+        int fd,
+        const void *buffer,
+        size_t size,
+        unsigned long long user_data) {
+    struct io_uring_sqe *poll_sqe, *rw_sqe;
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    if (ring->sq_entries - (*ring->sq_tail - head) < 2) {
+        errno = EBUSY;
+        return -1;
+    }
+    if (size > (size_t) INT_MAX)
+        size = (size_t) INT_MAX;
+
+    poll_sqe = io_ring_entry(ring, 0);
+    poll_sqe->opcode = IORING_OP_POLL_ADD;
+    poll_sqe->flags = IOSQE_IO_LINK;
+    poll_sqe->fd = fd;
+    poll_sqe->poll_events = (unsigned short) poll_events;
+    poll_sqe->user_data = io_ring_internal_user_data;
+
+    rw_sqe = io_ring_entry(ring, 1);
+    rw_sqe->opcode = (unsigned char) opcode;
+    rw_sqe->fd = fd;
+    rw_sqe->off = (unsigned long long) -1;
+    rw_sqe->addr = (unsigned long long) (uintptr_t) buffer;
+    rw_sqe->len = (unsigned) size;
+    rw_sqe->user_data = user_data;
+
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 2, __ATOMIC_RELEASE);
+    ring->unsubmitted += 2;
+    return 0;
+}
+
+int sesh_osapi_io_ring_prepare_read(
+        struct sesh_osapi_io_ring *ring,
+        int fd,
+        void *buffer,
+        size_t max_bytes_to_read,
+        unsigned long long user_data) {
+    return io_ring_prepare_rw(ring, IORING_OP_READ, POLLIN,
+            fd, buffer, max_bytes_to_read, user_data);
+}
+
+int sesh_osapi_io_ring_prepare_write(
+        struct sesh_osapi_io_ring *ring,
+        int fd,
+        const void *bytes,
+        size_t bytes_to_write,
+        unsigned long long user_data) {
+    return io_ring_prepare_rw(ring, IORING_OP_WRITE, POLLOUT,
+            fd, bytes, bytes_to_write, user_data);
+}
+
+int sesh_osapi_io_ring_submit(struct sesh_osapi_io_ring *ring) {
+    while (ring->unsubmitted > 0) {
+        long submitted = syscall(__NR_io_uring_enter,
+                ring->fd, ring->unsubmitted, 0U, 0U, NULL, 0);
+        if (submitted < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        ring->unsubmitted -= (unsigned) submitted;
+    }
+    return 0;
+}
+
+int sesh_osapi_io_ring_pop_completion(
+        struct sesh_osapi_io_ring *ring,
+        unsigned long long *user_data,
+        long long *result) {
+    unsigned head = *ring->cq_head;
+
+    for (;;) {
+        const struct io_uring_cqe *cqe;
+        unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+            return 0;
+
+        cqe = &ring->cqes[head & *ring->cq_mask];
+        head++;
+        if (cqe->user_data == io_ring_internal_user_data) {
+            __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        *user_data = cqe->user_data;
+        *result = cqe->res;
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+        return 1;
+    }
+}
+
+#else // #if SESH_OSAPI_HAVE_IO_URING
+
+struct sesh_osapi_io_ring *sesh_osapi_io_ring_new(unsigned entries) {
+    (void) entries;
+    errno = ENOSYS;
+    return NULL;
+}
+
+void sesh_osapi_io_ring_delete(struct sesh_osapi_io_ring *ring) {
+    (void) ring;
+}
+
+int sesh_osapi_io_ring_fd(const struct sesh_osapi_io_ring *ring) {
+    (void) ring;
+    return -1;
+}
+
+int sesh_osapi_io_ring_prepare_read(
+        struct sesh_osapi_io_ring *ring,
+        int fd,
+        void *buffer,
+        size_t max_bytes_to_read,
+        unsigned long long user_data) {
+    (void) ring, (void) fd, (void) buffer, (void) max_bytes_to_read,
+            (void) user_data;
+    errno = ENOSYS;
+    return -1;
+}
+
+int sesh_osapi_io_ring_prepare_write(
+        struct sesh_osapi_io_ring *ring,
+        int fd,
+        const void *bytes,
+        size_t bytes_to_write,
+        unsigned long long user_data) {
+    (void) ring, (void) fd, (void) bytes, (void) bytes_to_write,
+            (void) user_data;
+    errno = ENOSYS;
+    return -1;
+}
+
+int sesh_osapi_io_ring_submit(struct sesh_osapi_io_ring *ring) {
+    (void) ring;
+    errno = ENOSYS;
+    return -1;
+}
+
+int sesh_osapi_io_ring_pop_completion(
+        struct sesh_osapi_io_ring *ring,
+        unsigned long long *user_data,
+        long long *result) {
+    (void) ring, (void) user_data, (void) result;
+    return 0;
+}
+
+#endif // #if SESH_OSAPI_HAVE_IO_URING
+
 int sesh_osapi_sigprocmask(
         enum sesh_osapi_sigprocmask_how how,
         const struct sesh_osapi_sigset *new_mask,
@@ -341,6 +968,48 @@ int sesh_osapi_sigprocmask(
             old_mask != NULL ? &old_mask->value : NULL);
 }
 
+#if HAVE_SYS_SIGNALFD_H
+
+int sesh_osapi_signalfd(int fd, const struct sesh_osapi_sigset *mask) {
+    return signalfd(fd, &mask->value, SFD_NONBLOCK | SFD_CLOEXEC);
+}
+
+int sesh_osapi_read_signalfd(int fd, int *signal_numbers, int max_signals) {
+    struct signalfd_siginfo infos[64];
+    ssize_t bytes_read;
+    int count, i;
+
+    if (max_signals > (int) (sizeof infos / sizeof *infos))
+        max_signals = (int) (sizeof infos / sizeof *infos);
+    if (max_signals <= 0)
+        return 0;
+
+    bytes_read = read(fd, infos, (size_t) max_signals * sizeof *infos);
+    if (bytes_read < 0)
+        return -1;
+
+    count = (int) ((size_t) bytes_read / sizeof *infos);
+    for (i = 0; i < count; i++)
+        signal_numbers[i] = (int) infos[i].ssi_signo;
+    return count;
+}
+
+#else // #if HAVE_SYS_SIGNALFD_H
+
+int sesh_osapi_signalfd(int fd, const struct sesh_osapi_sigset *mask) {
+    (void) fd, (void) mask;
+    errno = ENOSYS;
+    return -1;
+}
+
+int sesh_osapi_read_signalfd(int fd, int *signal_numbers, int max_signals) {
+    (void) fd, (void) signal_numbers, (void) max_signals;
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif // #if HAVE_SYS_SIGNALFD_H
+
 static void to_sigaction(
         const struct sesh_osapi_signal_action *a, struct sigaction *sa) {
     switch (a->type) {
@@ -123,6 +123,20 @@ size_t sesh_osapi_read(int fd, void *buffer, size_t maxBytesToRead);
  */
 size_t sesh_osapi_write(int fd, const void *bytes, size_t bytesToWrite);
 
+/**
+ * Maps the whole contents of the regular file open for reading at the
+ * argument file descriptor into memory as read-only private pages. On
+ * success, returns the start address of the mapping and stores its size and
+ * the last modification time of the file (nanoseconds since the epoch). An
+ * empty file results in a non-null dummy address with size zero. On failure,
+ * returns null with errno set.
+ */
+const void *sesh_osapi_map_file(
+        int fd, size_t *size, long long *modification_time_in_nanoseconds);
+
+/** Releases the mapping returned from sesh_osapi_map_file. */
+int sesh_osapi_unmap_file(const void *address, size_t size);
+
 /** Returns @c FD_SETSIZE. */
 int sesh_osapi_fd_setsize(void);
 
@@ -189,6 +203,177 @@ int sesh_osapi_pselect(
         long long timeout_in_nanoseconds,
         const struct sesh_osapi_sigset *signal_mask);
 
+/**
+ * Returns non-zero iff the ppoll functions below are supported. If not, they
+ * fail with ENOSYS.
+ */
+int sesh_osapi_ppoll_is_supported(void);
+
+enum sesh_osapi_poll_event_flag {
+    SESH_OSAPI_POLLIN = 1 << 0,
+    SESH_OSAPI_POLLOUT = 1 << 1,
+    SESH_OSAPI_POLLPRI = 1 << 2,
+    SESH_OSAPI_POLLERR = 1 << 3,
+    SESH_OSAPI_POLLHUP = 1 << 4,
+    SESH_OSAPI_POLLNVAL = 1 << 5,
+};
+
+/**
+ * A growable array of the native pollfd structure. The array keeps its
+ * capacity when cleared so that it can be reused across ppoll calls without
+ * reallocation.
+ */
+struct sesh_osapi_pollfds;
+
+/** Returns a new empty array or null on failure. */
+struct sesh_osapi_pollfds *sesh_osapi_pollfds_new(void);
+
+/** Deletes an array returned from sesh_osapi_pollfds_new. */
+void sesh_osapi_pollfds_delete(struct sesh_osapi_pollfds *);
+
+/** Removes all the elements of the array without releasing memory. */
+void sesh_osapi_pollfds_clear(struct sesh_osapi_pollfds *);
+
+/**
+ * Appends an element to the array. The events argument is a bitwise OR of
+ * sesh_osapi_poll_event_flag values. Returns zero on success and -1 with
+ * errno set on failure.
+ */
+int sesh_osapi_pollfds_add(struct sesh_osapi_pollfds *, int fd, int events);
+
+/** Returns the number of elements in the array. */
+size_t sesh_osapi_pollfds_size(const struct sesh_osapi_pollfds *);
+
+/** Returns the file descriptor of the i'th element. */
+int sesh_osapi_pollfds_fd(const struct sesh_osapi_pollfds *, size_t i);
+
+/**
+ * Returns the returned events of the i'th element as a bitwise OR of
+ * sesh_osapi_poll_event_flag values.
+ */
+int sesh_osapi_pollfds_revents(const struct sesh_osapi_pollfds *, size_t i);
+
+/**
+ * A wrapper for the ppoll function.
+ *
+ * A negative timeout means no timeout.
+ */
+int sesh_osapi_ppoll(
+        struct sesh_osapi_pollfds *fds,
+        long long timeout_in_nanoseconds,
+        const struct sesh_osapi_sigset *signal_mask);
+
+/**
+ * A wrapper for the Linux epoll_create1 function. The close-on-exec flag is
+ * always set. Fails with ENOSYS if epoll is not supported.
+ */
+int sesh_osapi_epoll_create(void);
+
+enum sesh_osapi_epoll_ctl_op {
+    SESH_OSAPI_EPOLL_CTL_ADD,
+    SESH_OSAPI_EPOLL_CTL_MOD,
+    SESH_OSAPI_EPOLL_CTL_DEL,
+};
+
+enum sesh_osapi_epoll_event_flag {
+    SESH_OSAPI_EPOLLIN = 1 << 0,
+    SESH_OSAPI_EPOLLOUT = 1 << 1,
+    SESH_OSAPI_EPOLLPRI = 1 << 2,
+    SESH_OSAPI_EPOLLERR = 1 << 3,
+    SESH_OSAPI_EPOLLHUP = 1 << 4,
+};
+
+struct sesh_osapi_epoll_event {
+    int fd;
+    /** Bitwise OR of sesh_osapi_epoll_event_flag values. */
+    int events;
+};
+
+/**
+ * A wrapper for the Linux epoll_ctl function. The file descriptor itself is
+ * used as the user data of the registration. Fails with ENOSYS if epoll is
+ * not supported.
+ */
+int sesh_osapi_epoll_ctl(
+        int epoll_fd, enum sesh_osapi_epoll_ctl_op, int fd, int events);
+
+/**
+ * A wrapper for the Linux epoll_pwait function. A negative timeout means no
+ * timeout. A positive timeout is rounded up to milliseconds. Fails with
+ * ENOSYS if epoll is not supported.
+ */
+int sesh_osapi_epoll_pwait(
+        int epoll_fd,
+        struct sesh_osapi_epoll_event *events,
+        int max_events,
+        long long timeout_in_nanoseconds,
+        const struct sesh_osapi_sigset *signal_mask);
+
+/**
+ * A ring of asynchronous I/O requests backed by Linux io_uring. Requests are
+ * queued by the prepare functions and passed to the kernel in a batch by
+ * sesh_osapi_io_ring_submit.
+ */
+struct sesh_osapi_io_ring;
+
+/**
+ * Creates a new I/O ring that can hold at least the specified number of
+ * requests. Returns null with errno set on failure. Fails with ENOSYS if
+ * io_uring is not supported.
+ */
+struct sesh_osapi_io_ring *sesh_osapi_io_ring_new(unsigned entries);
+
+/** Deletes an I/O ring, closing its file descriptor. */
+void sesh_osapi_io_ring_delete(struct sesh_osapi_io_ring *);
+
+/**
+ * Returns the file descriptor of the I/O ring. The file descriptor becomes
+ * readable when the ring has a completion to pop.
+ */
+int sesh_osapi_io_ring_fd(const struct sesh_osapi_io_ring *);
+
+/**
+ * Queues a request to read from the file descriptor at its current file
+ * offset. The request waits for the file descriptor to become readable before
+ * reading, so it can be used with a non-blocking file descriptor. Returns
+ * zero on success, or -1 with errno set to EBUSY if the ring is full.
+ */
+int sesh_osapi_io_ring_prepare_read(
+        struct sesh_osapi_io_ring *,
+        int fd,
+        void *buffer,
+        size_t max_bytes_to_read,
+        unsigned long long user_data);
+
+/**
+ * Queues a request to write to the file descriptor at its current file
+ * offset. The request waits for the file descriptor to become writable before
+ * writing, so it can be used with a non-blocking file descriptor. Returns
+ * zero on success, or -1 with errno set to EBUSY if the ring is full.
+ */
+int sesh_osapi_io_ring_prepare_write(
+        struct sesh_osapi_io_ring *,
+        int fd,
+        const void *bytes,
+        size_t bytes_to_write,
+        unsigned long long user_data);
+
+/**
+ * Passes all the queued requests to the kernel with a single system call.
+ * Returns zero on success, or -1 with errno set on failure.
+ */
+int sesh_osapi_io_ring_submit(struct sesh_osapi_io_ring *);
+
+/**
+ * Pops the completion of a request. Returns zero if no request has completed.
+ * Otherwise, returns non-zero and stores the user data of the request and its
+ * result, which is the number of bytes transferred or a negated errno value.
+ */
+int sesh_osapi_io_ring_pop_completion(
+        struct sesh_osapi_io_ring *,
+        unsigned long long *user_data,
+        long long *result);
+
 enum sesh_osapi_sigprocmask_how {
     SESH_OSAPI_SIG_BLOCK,
     SESH_OSAPI_SIG_UNBLOCK,
@@ -203,6 +388,22 @@ int sesh_osapi_sigprocmask(
         const struct sesh_osapi_sigset *new_mask,
         struct sesh_osapi_sigset *old_mask);
 
+/**
+ * A wrapper for the Linux signalfd function. If the fd argument is -1, a new
+ * non-blocking signal file descriptor with the close-on-exec flag is created.
+ * Otherwise, the mask of the existing signal file descriptor is replaced.
+ * Fails with ENOSYS if signalfd is not supported.
+ */
+int sesh_osapi_signalfd(int fd, const struct sesh_osapi_sigset *mask);
+
+/**
+ * Reads pending signals from a signal file descriptor with a single read
+ * call. At most max_signals signal numbers are stored in the signal_numbers
+ * array. Returns the number of signals read, or -1 with errno set on failure.
+ * Fails with ENOSYS if signalfd is not supported.
+ */
+int sesh_osapi_read_signalfd(int fd, int *signal_numbers, int max_signals);
+
 enum sesh_osapi_signal_action_type {
     /** Signal-specific default action. */
     SESH_OSAPI_SIG_DFL,
@@ -241,6 +442,20 @@ struct default_delete<struct ::sesh_osapi_fd_set> {
     }
 };
 
+template<>
+struct default_delete<struct ::sesh_osapi_io_ring> {
+    void operator()(struct ::sesh_osapi_io_ring *p) const {
+        ::sesh_osapi_io_ring_delete(p);
+    }
+};
+
+template<>
+struct default_delete<struct ::sesh_osapi_pollfds> {
+    void operator()(struct ::sesh_osapi_pollfds *p) const {
+        ::sesh_osapi_pollfds_delete(p);
+    }
+};
+
 template<>
 struct default_delete<struct ::sesh_osapi_sigset> {
     void operator()(struct ::sesh_osapi_sigset *p) const {
@@ -0,0 +1,82 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_event_asynchronous_io_hh
+#define INCLUDED_os_event_asynchronous_io_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <system_error>
+#include "async/future.hh"
+#include "common/variant.hh"
+#include "os/io/file_descriptor.hh"
+
+namespace sesh {
+namespace os {
+namespace event {
+
+/**
+ * Performs reads and writes as asynchronous operations rather than waiting
+ * for readiness of file descriptors and then calling the reader or writer
+ * API.
+ *
+ * @see proactor#async_io
+ */
+class asynchronous_io {
+
+public:
+
+    /** The number of bytes transferred, or an error. */
+    using result = common::variant<std::size_t, std::error_code>;
+
+    virtual ~asynchronous_io() = default;
+
+    /**
+     * Starts reading bytes from the file descriptor into the buffer. The
+     * returned future receives the result when the read completes.
+     *
+     * The file descriptor and buffer must be kept valid until the future
+     * receives the result. If the read cannot be performed asynchronously
+     * (for example, because the file descriptor would block), the result is
+     * an error code equivalent to std::errc::resource_unavailable_try_again
+     * or std::errc::operation_canceled, in which case the caller should wait
+     * for readiness and read the file descriptor directly.
+     */
+    virtual async::future<result> read(
+            const io::file_descriptor &, void *, std::size_t) = 0;
+
+    /**
+     * Starts writing bytes to the file descriptor from the buffer. The
+     * returned future receives the result when the write completes.
+     *
+     * The file descriptor and buffer must be kept valid until the future
+     * receives the result. Errors are reported in the same way as
+     * {@link #read}.
+     */
+    virtual async::future<result> write(
+            const io::file_descriptor &, const void *, std::size_t) = 0;
+
+}; // class asynchronous_io
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_event_asynchronous_io_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -30,30 +30,24 @@
 #include "async/future.hh"
 #include "async/promise.hh"
 #include "common/container_helper.hh"
-#include "common/either.hh"
-#include "common/shared_function.hh"
 #include "common/variant.hh"
 #include "helpermacros.h"
+#include "os/event/pending_event.hh"
 #include "os/event/pselect_api.hh"
 #include "os/event/trigger.hh"
 #include "os/io/file_descriptor.hh"
 #include "os/io/file_descriptor_set.hh"
 #include "os/signaling/handler_configuration.hh"
-#include "os/signaling/signal_number.hh"
 #include "os/signaling/signal_number_set.hh"
 #include "os/time_api.hh"
 
 using sesh::async::future;
 using sesh::async::make_promise_future_pair;
-using sesh::async::promise;
 using sesh::common::find_if;
-using sesh::common::shared_function;
-using sesh::common::trial;
 using sesh::common::variant;
 using sesh::os::io::file_descriptor;
 using sesh::os::io::file_descriptor_set;
 using sesh::os::signaling::handler_configuration;
-using sesh::os::signaling::signal_number;
 using sesh::os::signaling::signal_number_set;
 
 using time_point = sesh::os::event::pselect_api::steady_clock_time;
@@ -64,74 +58,54 @@ namespace event {
 
 namespace {
 
-using file_descriptor_trigger = variant<
-        readable_file_descriptor,
-        writable_file_descriptor,
-        error_file_descriptor>;
-
-class pending_event {
+/**
+ * A file descriptor set that is allocated on first use and reused in later
+ * p-select calls.
+ */
+class reusable_file_descriptor_set {
 
 private:
 
-    class timeout m_timeout;
-    std::vector<file_descriptor_trigger> m_triggers;
-    promise<trigger> m_promise;
-    std::vector<handler_configuration::canceler_type> m_cancelers;
+    std::unique_ptr<file_descriptor_set> m_set;
+    bool m_is_used = false;
 
 public:
 
-    explicit pending_event(promise<trigger>);
-    pending_event(pending_event &&) = default;
-    pending_event &operator=(pending_event &&) = default;
-    ~pending_event();
-
-    class timeout &timeout() noexcept { return m_timeout; }
-
-    const std::vector<file_descriptor_trigger> &triggers() const noexcept {
-        return m_triggers;
+    /** Returns the set if it is in use, or null otherwise. */
+    file_descriptor_set *get() const noexcept {
+        return m_is_used ? m_set.get() : nullptr;
     }
 
-    void add_trigger(const file_descriptor_trigger &t);
-
-    bool has_fired() const noexcept { return !m_promise.is_valid(); }
-
-    void fire(trigger &&);
-    void fail_with_current_exception();
-
-    void add_canceler(handler_configuration::canceler_type &&c);
-
-};
-
-class signal_handler {
+    /** Adds a file descriptor, allocating the set if necessary. */
+    void set(file_descriptor::value_type, const pselect_api &);
 
-private:
-
-    std::weak_ptr<pending_event> m_event;
-
-public:
+    /** Empties the set without releasing it. */
+    void reset();
 
-    signal_handler(const std::shared_ptr<pending_event> &) noexcept;
-
-    void operator()(signal_number);
-
-}; // class signal_handler
+}; // class reusable_file_descriptor_set
 
 class pselect_argument {
 
 private:
 
     file_descriptor::value_type m_fd_bound;
-    std::unique_ptr<file_descriptor_set> m_read_fds, m_write_fds, m_error_fds;
+    reusable_file_descriptor_set m_read_fds, m_write_fds, m_error_fds;
     time_point::duration m_timeout;
 
     void add_fd(
-            std::unique_ptr<file_descriptor_set> &fds,
+            reusable_file_descriptor_set &fds,
             file_descriptor::value_type fd,
             const pselect_api &api);
 
 public:
 
-    explicit pselect_argument(time_point::duration timeout) noexcept;
+    pselect_argument() noexcept;
+
+    /**
+     * Empties this p-select argument so that it can be reused for the next
+     * call. The file descriptor sets that have been allocated are retained.
+     */
+    void reset(time_point::duration timeout);
 
     /**
      * Updates this p-select argument according to the given trigger. May throw
@@ -145,12 +119,19 @@ public:
      */
     void add_or_fire(pending_event &, const pselect_api &);
 
+    /** Adds the signal file descriptor to the read set. */
+    void add_signal_file_descriptor(
+            file_descriptor::value_type, const pselect_api &);
+
     /** Calls the p-select API function with this argument. */
     std::error_code call(const pselect_api &api, const signal_number_set *);
 
     /** Tests if this p-select call result matches the given trigger. */
     bool matches(const file_descriptor_trigger &) const;
 
+    /** Tests if this p-select call result includes the readable FD. */
+    bool is_readable(file_descriptor::value_type) const;
+
     /**
      * Applies this p-select call result to the argument event. If the result
      * matches the event, the event is fired. If the event has already been
@@ -182,9 +163,21 @@ private:
     /** @return min for infinity */
     time_point::duration duration_to_next_timeout(time_point now) const;
 
-    pselect_argument compute_argument_firing_errored_events(time_point now);
+    /** Reused across iterations to avoid allocating file descriptor sets. */
+    pselect_argument m_argument;
+
+    /** Signal file descriptor included in the current argument, if any. */
+    file_descriptor::value_type m_signal_fd;
+
+    void compute_argument_firing_errored_events(time_point now);
+
+    /**
+     * Calls the signal handlers unless the signal file descriptor is known
+     * not to be readable.
+     */
+    void call_handlers(const std::error_code &pselect_result);
 
-    void apply_result(const pselect_argument &);
+    void apply_result();
 
 public:
 
@@ -195,58 +188,40 @@ public:
 
 }; // class awaiter_impl
 
-pending_event::pending_event(promise<trigger> p) :
-        m_timeout(timeout::internal_type::max()),
-        m_triggers(),
-        m_promise(std::move(p)),
-        m_cancelers() { }
-
-pending_event::~pending_event() {
-    for (handler_configuration::canceler_type &c : m_cancelers)
-        (void) c();
-}
-
-void pending_event::add_trigger(const file_descriptor_trigger &t) {
-    m_triggers.push_back(t);
-}
-
-void pending_event::fire(trigger &&t) {
-    if (!has_fired())
-        std::move(m_promise).set_result(std::move(t));
-}
-
-void pending_event::fail_with_current_exception() {
-    if (!has_fired())
-        std::move(m_promise).fail_with_current_exception();
-}
-
-void pending_event::add_canceler(handler_configuration::canceler_type &&c) {
-    m_cancelers.push_back(std::move(c));
+void reusable_file_descriptor_set::set(
+        file_descriptor::value_type fd, const pselect_api &api) {
+    if (m_set == nullptr)
+        m_set = api.create_file_descriptor_set();
+    else if (!m_is_used)
+        m_set->reset();
+    m_is_used = true;
+    m_set->set(fd);
 }
 
-signal_handler::signal_handler(const std::shared_ptr<pending_event> &e)
-        noexcept :
-        m_event(e) { }
-
-void signal_handler::operator()(signal_number n) {
-    if (std::shared_ptr<pending_event> e = m_event.lock())
-        e->fire(signal(n));
+void reusable_file_descriptor_set::reset() {
+    m_is_used = false;
 }
 
-pselect_argument::pselect_argument(time_point::duration timeout) noexcept :
+pselect_argument::pselect_argument() noexcept :
         m_fd_bound(0),
         m_read_fds(),
         m_write_fds(),
         m_error_fds(),
-        m_timeout(timeout) { }
+        m_timeout(time_point::duration::min()) { }
+
+void pselect_argument::reset(time_point::duration timeout) {
+    m_fd_bound = 0;
+    m_read_fds.reset();
+    m_write_fds.reset();
+    m_error_fds.reset();
+    m_timeout = timeout;
+}
 
 void pselect_argument::add_fd(
-        std::unique_ptr<file_descriptor_set> &fds,
+        reusable_file_descriptor_set &fds,
         file_descriptor::value_type fd,
         const pselect_api &api) {
-    if (fds == nullptr)
-        fds = api.create_file_descriptor_set();
-    fds->set(fd);
+    fds.set(fd, api);
 
     m_fd_bound = std::max(m_fd_bound, fd + 1);
 }
@@ -279,6 +254,11 @@ void pselect_argument::add_or_fire(pending_event &e, const pselect_api &api) {
     }
 }
 
+void pselect_argument::add_signal_file_descriptor(
+        file_descriptor::value_type fd, const pselect_api &api) {
+    add_fd(m_read_fds, fd, api);
+}
+
 std::error_code pselect_argument::call(
         const pselect_api &api, const signal_number_set *signal_mask) {
     return api.pselect(
@@ -291,9 +271,9 @@ std::error_code pselect_argument::call(
 }
 
 bool contains(
-        const std::unique_ptr<file_descriptor_set> &fds,
+        const reusable_file_descriptor_set &fds,
         file_descriptor::value_type fd) {
-    return fds != nullptr && fds->test(fd);
+    return fds.get() != nullptr && fds.get()->test(fd);
 }
 
 bool pselect_argument::matches(const file_descriptor_trigger &t) const {
@@ -310,6 +290,10 @@ bool pselect_argument::matches(const file_descriptor_trigger &t) const {
     UNREACHABLE();
 }
 
+bool pselect_argument::is_readable(file_descriptor::value_type fd) const {
+    return contains(m_read_fds, fd);
+}
+
 void pselect_argument::apply_result(pending_event &e) const {
     if (e.has_fired())
         return;
@@ -325,80 +309,12 @@ awaiter_impl::awaiter_impl(
         const pselect_api &api, std::shared_ptr<handler_configuration> &&hc) :
         m_api(api),
         m_handler_configuration(std::move(hc)),
-        m_pending_events() {
+        m_pending_events(),
+        m_argument(),
+        m_signal_fd(file_descriptor::invalid_value) {
     assert(m_handler_configuration != nullptr);
 }
 
-void register_signal_trigger(
-        signal s,
-        std::shared_ptr<pending_event> &e,
-        handler_configuration &hc) {
-    auto result = hc.add_handler(
-            s.number(), shared_function<signal_handler>::create(e));
-    switch (result.tag()) {
-    case decltype(result)::tag<handler_configuration::canceler_type>():
-        return e->add_canceler(std::move(
-                result.value<handler_configuration::canceler_type>()));
-    case decltype(result)::tag<std::error_code>():
-        throw std::system_error(result.value<std::error_code>());
-    }
-}
-
-void register_user_provided_trigger(
-        user_provided_trigger &&t, std::shared_ptr<pending_event> &e) {
-    using result = user_provided_trigger::result_type;
-    std::weak_ptr<pending_event> w = e;
-    std::move(t.future()).then([w](trial<result> &&t) {
-        if (std::shared_ptr<pending_event> e = w.lock()) {
-            try {
-                e->fire(user_provided_trigger(std::move(t.get())));
-            } catch (...) {
-                e->fail_with_current_exception();
-            }
-        }
-    });
-}
-
-void register_trigger(
-        trigger &&t,
-        std::shared_ptr<pending_event> &e,
-        handler_configuration &hc) {
-    switch (t.tag()) {
-    case trigger::tag<timeout>():
-        e->timeout() = std::min(e->timeout(), t.value<timeout>());
-        return;
-    case trigger::tag<readable_file_descriptor>():
-        e->add_trigger(t.value<readable_file_descriptor>());
-        return;
-    case trigger::tag<writable_file_descriptor>():
-        e->add_trigger(t.value<writable_file_descriptor>());
-        return;
-    case trigger::tag<error_file_descriptor>():
-        e->add_trigger(t.value<error_file_descriptor>());
-        return;
-    case trigger::tag<signal>():
-        register_signal_trigger(t.value<signal>(), e, hc);
-        return;
-    case trigger::tag<user_provided_trigger>():
-        register_user_provided_trigger(
-                std::move(t.value<user_provided_trigger>()), e);
-        return;
-    }
-}
-
-time_point compute_time_limit(timeout to, const time_api &api) {
-    if (to.interval() < timeout::internal_type::zero())
-        to = timeout(timeout::internal_type::zero());
-
-    if (to.interval() == timeout::internal_type::max())
-        return time_point::max();
-
-    time_point now = api.steady_clock_now();
-    if (now > time_point::max() - to.interval())
-        return time_point::max();
-    return now + to.interval();
-}
-
 future<trigger> awaiter_impl::expect_impl(
         std::vector<trigger> &&triggers) {
     auto pf = make_promise_future_pair<trigger>();
@@ -431,9 +347,11 @@ bool awaiter_impl::remove_fired_events() {
 void awaiter_impl::fire_timeouts(time_point now) {
     for (auto &p : m_pending_events) {
         const time_limit &limit = p.first;
+        if (limit > now)
+            break;
+
         std::shared_ptr<pending_event> &e = p.second;
-        if (limit <= now)
-            e->fire(e->timeout());
+        e->fire(e->timeout());
     }
 }
 
@@ -450,17 +368,30 @@ time_point::duration awaiter_impl::duration_to_next_timeout(time_point now)
     return next_time_limit - now;
 }
 
-pselect_argument awaiter_impl::compute_argument_firing_errored_events(
-        time_point now) {
-    pselect_argument argument(duration_to_next_timeout(now));
+void awaiter_impl::compute_argument_firing_errored_events(time_point now) {
+    m_argument.reset(duration_to_next_timeout(now));
     for (auto &p : m_pending_events)
-        argument.add_or_fire(*p.second, m_api);
-    return argument;
+        m_argument.add_or_fire(*p.second, m_api);
+
+    const file_descriptor *signal_fd =
+            m_handler_configuration->signal_file_descriptor();
+    if (signal_fd == nullptr) {
+        m_signal_fd = file_descriptor::invalid_value;
+    } else {
+        m_signal_fd = signal_fd->value();
+        m_argument.add_signal_file_descriptor(m_signal_fd, m_api);
+    }
 }
 
-void awaiter_impl::apply_result(const pselect_argument &a) {
+void awaiter_impl::call_handlers(const std::error_code &pselect_result) {
+    if (m_signal_fd == file_descriptor::invalid_value || pselect_result ||
+            m_argument.is_readable(m_signal_fd))
+        m_handler_configuration->call_handlers();
+}
+
+void awaiter_impl::apply_result() {
     for (auto &p : m_pending_events)
-        a.apply_result(*p.second);
+        m_argument.apply_result(*p.second);
 }
 
 void awaiter_impl::await_events() {
@@ -468,20 +399,19 @@ void awaiter_impl::await_events() {
         time_point now = m_api.steady_clock_now();
         fire_timeouts(now);
 
-        pselect_argument argument =
-                compute_argument_firing_errored_events(now);
+        compute_argument_firing_errored_events(now);
         if (remove_fired_events())
             continue;
 
-        std::error_code e = argument.call(
+        std::error_code e = m_argument.call(
                 m_api, m_handler_configuration->mask_for_pselect());
         assert(e != std::errc::bad_file_descriptor);
 
-        m_handler_configuration->call_handlers();
+        call_handlers(e);
 
         if (e)
             continue;
-        apply_result(argument);
+        apply_result();
         remove_fired_events();
     }
 }
@@ -21,6 +21,7 @@
 #include "buildconfig.h"
 
 #include <memory>
+#include "os/event/epoll_api.hh"
 #include "os/event/proactor.hh"
 #include "os/event/pselect_api.hh"
 #include "os/signaling/handler_configuration.hh"
@@ -66,6 +67,24 @@ std::unique_ptr<awaiter> create_awaiter(
         const pselect_api &api,
         std::shared_ptr<signaling::handler_configuration> &&hc);
 
+/**
+ * Creates a new awaiter that uses epoll. Unlike the pselect-based awaiter, the
+ * returned awaiter keeps file descriptors registered in the epoll instance
+ * across waits and examines only the events that became ready, so the cost of
+ * a wake-up does not grow with the number of pending events.
+ *
+ * If the epoll instance cannot be created, this function falls back to the
+ * pselect-based awaiter.
+ *
+ * @param api API the new awaiter depends on. This must be the same API
+ * instance as the one the handler configuration depends on.
+ * @param hc non-null pointer to a handler configuration the new awaiter
+ * depends on. The awaiter never modifies any trap configuration.
+ */
+std::unique_ptr<awaiter> create_awaiter(
+        const epoll_api &api,
+        std::shared_ptr<signaling::handler_configuration> &&hc);
+
 } // namespace event
 } // namespace os
 } // namespace sesh
@@ -45,6 +45,7 @@ using sesh::os::event::trigger;
 using sesh::os::io::file_descriptor;
 using sesh::os::io::file_descriptor_set;
 using sesh::os::signaling::handler_configuration_api_fake;
+using sesh::os::signaling::handler_configuration_api_signalfd_fake;
 using sesh::os::signaling::signal_number;
 using sesh::os::signaling::signal_number_set;
 
@@ -342,6 +343,39 @@ TEST_CASE_METHOD(
     CHECK(a.tag() == signal_action::tag<default_action>());
 }
 
+TEST_CASE_METHOD(
+        awaiter_test_fixture<handler_configuration_api_signalfd_fake>,
+        "Awaiter: signal delivered through signal file descriptor") {
+    expect_result(
+            a.expect(signal(3)),
+            [](trigger &&t) {
+        REQUIRE(t.tag() == trigger::tag<signal>());
+        CHECK(t.value<signal>().number() == 3);
+    });
+
+    implementation() = [this](
+            const pselect_api_stub &,
+            file_descriptor::value_type fd_bound,
+            file_descriptor_set *read_fds,
+            file_descriptor_set *write_fds,
+            file_descriptor_set *error_fds,
+            std::chrono::nanoseconds,
+            const signal_number_set *signal_mask) -> std::error_code {
+        REQUIRE(read_fds != nullptr);
+        CHECK(read_fds->test(signalfd_value));
+        check_empty(write_fds, fd_bound, "write_fds");
+        check_empty(error_fds, fd_bound, "error_fds");
+        REQUIRE(signal_mask != nullptr);
+        CHECK(signal_mask->test(3));
+
+        signalfd_pending().push_back(3);
+        implementation() = nullptr;
+        return std::error_code();
+    };
+    a.await_events();
+    CHECK(signalfd_read_count() == 1);
+}
+
 } // namespace
 
 /* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -25,14 +25,28 @@
 #include <vector>
 #include "os/event/awaiter.hh"
 #include "os/event/pselect_api_test_helper.hh"
+#if SESH_AWAITER_TEST_EPOLL
+#include "os/event/epoll_api_test_helper.hh"
+#endif
 #include "os/signaling/handler_configuration.hh"
 
 namespace sesh {
 namespace os {
 namespace event {
 
+/**
+ * The API stub the awaiter under test depends on. The awaiter tests are
+ * compiled twice: once for the pselect-based awaiter and once, with
+ * SESH_AWAITER_TEST_EPOLL defined, for the epoll-based awaiter.
+ */
+#if SESH_AWAITER_TEST_EPOLL
+using awaiter_api_stub = epoll_api_stub;
+#else
+using awaiter_api_stub = pselect_api_stub;
+#endif
+
 template<typename Base>
-class awaiter_test_fixture : protected pselect_api_stub, protected Base {
+class awaiter_test_fixture : protected awaiter_api_stub, protected Base {
 
 private:
 
@@ -19,17 +19,22 @@
 
 #include <chrono>
 #include <memory>
+#include <system_error>
 #include <utility>
 #include "async/future.hh"
 #include "async/future_test_helper.hh"
 #include "catch.hpp"
 #include "common/either.hh"
 #include "common/type_tag_test_helper.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/io/file_descriptor_set.hh"
 #include "os/event/awaiter_test_helper.hh"
 #include "os/event/pselect_api.hh"
+#include "os/event/timeout.hh"
 #include "os/event/trigger.hh"
 #include "os/event/user_provided_trigger.hh"
 #include "os/signaling/handler_configuration_api_test_helper.hh"
+#include "os/signaling/signal_number_set.hh"
 
 namespace {
 
@@ -39,9 +44,13 @@ using sesh::async::make_future_of;
 using sesh::async::make_promise_future_pair;
 using sesh::common::trial;
 using sesh::os::event::awaiter_test_fixture;
+using sesh::os::event::timeout;
 using sesh::os::event::trigger;
 using sesh::os::event::user_provided_trigger;
+using sesh::os::io::file_descriptor;
+using sesh::os::io::file_descriptor_set;
 using sesh::os::signaling::handler_configuration_api_dummy;
+using sesh::os::signaling::signal_number_set;
 
 using time_point = sesh::os::event::pselect_api::steady_clock_time;
 
@@ -132,6 +141,60 @@ TEST_CASE_METHOD(
     CHECK(actual.get() == expected.get());
 }
 
+TEST_CASE_METHOD(
+        awaiter_test_fixture<handler_configuration_api_dummy>,
+        "Awaiter: expired event fired by another expired event's callback") {
+    auto start_time = time_point(std::chrono::seconds(0));
+    mutable_steady_clock_now() = start_time;
+
+    using UPT = user_provided_trigger;
+    auto pf = make_promise_future_pair<UPT::result_type>();
+    std::shared_ptr<void> result = std::make_shared<int>(3);
+    unsigned fire_count = 0;
+    expect_result(
+            a.expect(timeout(std::chrono::seconds(0))),
+            [&pf, &result, &fire_count](trigger &&t) {
+        CHECK(t.tag() == trigger::tag<timeout>());
+        std::move(pf.first).set_result(result);
+        ++fire_count;
+    });
+    expect_result(
+            a.expect(
+                timeout(std::chrono::seconds(0)),
+                UPT(std::move(pf.second))),
+            [&result, &fire_count](trigger &&t) {
+        REQUIRE(t.tag() == trigger::tag<user_provided_trigger>());
+        CHECK(t.value<user_provided_trigger>().result() == result);
+        ++fire_count;
+    });
+    expect_result(
+            a.expect(timeout(std::chrono::seconds(10))),
+            [this, start_time, &fire_count](trigger &&t) {
+        CHECK(t.tag() == trigger::tag<timeout>());
+        CHECK(steady_clock_now() ==
+                start_time + std::chrono::seconds(10));
+        ++fire_count;
+    });
+
+    implementation() = [this](
+            const pselect_api_stub &,
+            file_descriptor::value_type,
+            file_descriptor_set *,
+            file_descriptor_set *,
+            file_descriptor_set *,
+            std::chrono::nanoseconds timeout,
+            const signal_number_set *) -> std::error_code {
+        if (timeout == std::chrono::seconds(0))
+            return std::error_code();
+        CHECK(timeout == std::chrono::seconds(10));
+        mutable_steady_clock_now() += timeout;
+        implementation() = nullptr;
+        return std::error_code();
+    };
+    a.await_events();
+    CHECK(fire_count == 3);
+}
+
 } // namespace
 
 /* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,152 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_event_epoll_api_hh
+#define INCLUDED_os_event_epoll_api_hh
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <system_error>
+#include <vector>
+#include "common/enum_set.hh"
+#include "common/enum_traits.hh"
+#include "common/variant.hh"
+#include "os/event/pselect_api.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/io/file_descriptor_api.hh"
+#include "os/signaling/signal_number_set.hh"
+
+namespace sesh {
+
+namespace os {
+namespace event {
+
+/** Conditions of a file descriptor an epoll instance can watch. */
+enum class epoll_condition {
+    /** Corresponds to the read set of pselect. */
+    readable,
+    /** Corresponds to the write set of pselect. */
+    writable,
+    /** Corresponds to the error set of pselect. */
+    error,
+};
+
+} // namespace event
+} // namespace os
+
+namespace common {
+
+template<>
+class enum_traits<os::event::epoll_condition> {
+public:
+    constexpr static os::event::epoll_condition max =
+            os::event::epoll_condition::error;
+};
+
+} // namespace common
+
+namespace os {
+namespace event {
+
+/**
+ * Abstraction of the Linux epoll API functions.
+ *
+ * Unlike pselect, an epoll instance remembers the file descriptors it watches
+ * across calls, so the caller only needs to tell the changes in the interest
+ * set. Implementations that do not support epoll fail {@link #epoll_create}
+ * with std::errc::function_not_supported; callers are expected to fall back
+ * to the pselect API in that case.
+ */
+class epoll_api :
+        public virtual pselect_api, public virtual io::file_descriptor_api {
+
+public:
+
+    using condition = epoll_condition;
+    using condition_set = common::enum_set<condition>;
+
+    /** A file descriptor reported ready by {@link #epoll_pwait}. */
+    class event {
+
+    public:
+
+        io::file_descriptor::value_type fd;
+
+        /**
+         * The conditions that are met. An error or hang-up of the file
+         * descriptor is reported as both readable and writable, just like
+         * pselect does.
+         */
+        condition_set conditions;
+
+    }; // class event
+
+    enum class control_operation { add, modify, remove };
+
+    /**
+     * Creates a new epoll instance. The returned file descriptor must be
+     * closed by the caller.
+     */
+    virtual common::variant<io::file_descriptor, std::error_code>
+            epoll_create() const = 0;
+
+    /**
+     * Adds, modifies, or removes a file descriptor in the interest set of an
+     * epoll instance. The condition set is ignored for the remove operation.
+     *
+     * @throws std::domain_error the file descriptor is not supported by the
+     * implementation.
+     */
+    virtual std::error_code epoll_ctl(
+            const io::file_descriptor &epoll,
+            control_operation,
+            io::file_descriptor::value_type fd,
+            condition_set) const = 0;
+
+    /**
+     * Waits for a file descriptor in the interest set to become ready or a
+     * signal to be caught.
+     *
+     * On success, the events vector is cleared and then filled with at most
+     * <code>max_events</code> ready file descriptors. The vector is left
+     * empty on failure. The vector's capacity is reused, so passing the same
+     * vector in each call avoids memory allocation.
+     *
+     * A negative timeout means no timeout. The signal mask may be null.
+     * Non-null signal masks must be obtained from the {@link
+     * #create_signal_number_set} function called for the same
+     * <code>*this</code>.
+     */
+    virtual std::error_code epoll_pwait(
+            const io::file_descriptor &epoll,
+            std::vector<event> &events,
+            std::size_t max_events,
+            std::chrono::nanoseconds timeout,
+            const signaling::signal_number_set *signal_mask) const = 0;
+
+}; // class epoll_api
+
+} // namespace event
+} // namespace os
+
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_event_epoll_api_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
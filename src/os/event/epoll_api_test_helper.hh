@@ -0,0 +1,212 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_event_epoll_api_test_helper_hh
+#define INCLUDED_os_event_epoll_api_test_helper_hh
+
+#include "buildconfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include "common/enum_set.hh"
+#include "common/variant.hh"
+#include "os/event/epoll_api.hh"
+#include "os/event/pselect_api_test_helper.hh"
+#include "os/io/file_description_access_mode.hh"
+#include "os/io/file_description_attribute.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/io/file_descriptor_open_mode.hh"
+#include "os/io/file_descriptor_set.hh"
+#include "os/io/file_descriptor_set_test_helper.hh"
+#include "os/io/file_mode.hh"
+#include "os/signaling/signal_number_set.hh"
+
+namespace sesh {
+namespace os {
+namespace event {
+
+/**
+ * Epoll API stub that is implemented on top of the pselect API stub. The
+ * epoll_pwait function calls the pselect stub with the file descriptor sets
+ * computed from the current interest set, so tests written for the
+ * pselect-based awaiter can be reused for the epoll-based awaiter.
+ */
+class epoll_api_stub : public epoll_api, public pselect_api_stub {
+
+public:
+
+    constexpr static io::file_descriptor::value_type epoll_fd = 100;
+
+private:
+
+    mutable std::map<io::file_descriptor::value_type, condition_set>
+            m_interests;
+
+    std::set<io::file_descriptor::value_type> m_unpollable_fds;
+
+    static void add_to(
+            std::unique_ptr<io::file_descriptor_set> &fds,
+            io::file_descriptor::value_type fd,
+            const pselect_api &api) {
+        if (fds == nullptr)
+            fds = api.create_file_descriptor_set();
+        fds->set(fd);
+    }
+
+    static bool contains(
+            const std::unique_ptr<io::file_descriptor_set> &fds,
+            io::file_descriptor::value_type fd) {
+        return fds != nullptr && fds->test(fd);
+    }
+
+public:
+
+    /** Current interest set of the only epoll instance. */
+    const std::map<io::file_descriptor::value_type, condition_set> &
+            interests() const noexcept {
+        return m_interests;
+    }
+
+    /**
+     * File descriptors that cannot be added to the epoll instance, like
+     * regular files. Adding them fails with EPERM.
+     */
+    std::set<io::file_descriptor::value_type> &unpollable_fds() noexcept {
+        return m_unpollable_fds;
+    }
+
+    common::variant<io::file_descriptor, std::error_code> open(
+            const char *,
+            io::file_description_access_mode,
+            common::enum_set<io::file_description_attribute>,
+            common::enum_set<io::file_descriptor_open_mode>,
+            common::enum_set<io::file_mode>) const override {
+        throw "unexpected open";
+    }
+
+    std::error_code close(io::file_descriptor &fd) const override {
+        fd.clear();
+        return std::error_code();
+    }
+
+    common::variant<io::file_descriptor, std::error_code> epoll_create()
+            const override {
+        return io::file_descriptor(epoll_fd);
+    }
+
+    std::error_code epoll_ctl(
+            const io::file_descriptor &epoll,
+            control_operation op,
+            io::file_descriptor::value_type fd,
+            condition_set conditions) const override {
+        if (epoll.value() != epoll_fd)
+            return std::make_error_code(std::errc::bad_file_descriptor);
+        if (fd > io::file_descriptor_set_fake::max)
+            throw std::domain_error("too large file descriptor");
+
+        auto i = m_interests.find(fd);
+        switch (op) {
+        case control_operation::add:
+            if (m_unpollable_fds.count(fd) > 0)
+                return std::make_error_code(
+                        std::errc::operation_not_permitted);
+            if (i != m_interests.end())
+                return std::make_error_code(std::errc::file_exists);
+            m_interests.emplace(fd, conditions);
+            return std::error_code();
+        case control_operation::modify:
+            if (i == m_interests.end())
+                return std::make_error_code(
+                        std::errc::no_such_file_or_directory);
+            i->second = conditions;
+            return std::error_code();
+        case control_operation::remove:
+            if (i == m_interests.end())
+                return std::make_error_code(
+                        std::errc::no_such_file_or_directory);
+            m_interests.erase(i);
+            return std::error_code();
+        }
+        throw "unexpected control operation";
+    }
+
+    std::error_code epoll_pwait(
+            const io::file_descriptor &epoll,
+            std::vector<event> &events,
+            std::size_t max_events,
+            std::chrono::nanoseconds timeout,
+            const signaling::signal_number_set *signal_mask) const override {
+        events.clear();
+        if (epoll.value() != epoll_fd)
+            return std::make_error_code(std::errc::bad_file_descriptor);
+
+        std::unique_ptr<io::file_descriptor_set> read_fds, write_fds,
+                error_fds;
+        io::file_descriptor::value_type fd_bound = 0;
+        for (const auto &i : m_interests) {
+            if (i.second[condition::readable])
+                add_to(read_fds, i.first, *this);
+            if (i.second[condition::writable])
+                add_to(write_fds, i.first, *this);
+            if (i.second[condition::error])
+                add_to(error_fds, i.first, *this);
+            fd_bound = std::max(fd_bound, i.first + 1);
+        }
+
+        std::error_code e = pselect(
+                fd_bound,
+                read_fds.get(),
+                write_fds.get(),
+                error_fds.get(),
+                timeout,
+                signal_mask);
+        if (e)
+            return e;
+
+        for (const auto &i : m_interests) {
+            if (events.size() >= max_events)
+                break;
+
+            condition_set conditions;
+            if (contains(read_fds, i.first))
+                conditions.set(condition::readable);
+            if (contains(write_fds, i.first))
+                conditions.set(condition::writable);
+            if (contains(error_fds, i.first))
+                conditions.set(condition::error);
+            if (conditions.any())
+                events.push_back(event{i.first, conditions});
+        }
+        return std::error_code();
+    }
+
+}; // class epoll_api_stub
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_event_epoll_api_test_helper_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,558 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "awaiter.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "async/promise.hh"
+#include "helpermacros.h"
+#include "os/event/epoll_api.hh"
+#include "os/event/pending_event.hh"
+#include "os/event/timer_queue.hh"
+#include "os/event/trigger.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/signaling/handler_configuration.hh"
+
+using sesh::async::future;
+using sesh::async::make_promise_future_pair;
+using sesh::async::promise;
+using sesh::os::io::file_descriptor;
+using sesh::os::signaling::handler_configuration;
+
+using time_point = sesh::os::event::epoll_api::steady_clock_time;
+using condition = sesh::os::event::epoll_api::condition;
+using condition_set = sesh::os::event::epoll_api::condition_set;
+using control_operation = sesh::os::event::epoll_api::control_operation;
+
+namespace sesh {
+namespace os {
+namespace event {
+
+namespace {
+
+/** The maximum number of ready file descriptors received in one wait. */
+constexpr std::size_t max_ready_events = 64;
+
+condition condition_of(const file_descriptor_trigger &t) {
+    switch (t.tag()) {
+    case file_descriptor_trigger::tag<readable_file_descriptor>():
+        return condition::readable;
+    case file_descriptor_trigger::tag<writable_file_descriptor>():
+        return condition::writable;
+    case file_descriptor_trigger::tag<error_file_descriptor>():
+        return condition::error;
+    }
+    UNREACHABLE();
+}
+
+file_descriptor::value_type fd_of(const file_descriptor_trigger &t) {
+    switch (t.tag()) {
+    case file_descriptor_trigger::tag<readable_file_descriptor>():
+        return t.value<readable_file_descriptor>().value();
+    case file_descriptor_trigger::tag<writable_file_descriptor>():
+        return t.value<writable_file_descriptor>().value();
+    case file_descriptor_trigger::tag<error_file_descriptor>():
+        return t.value<error_file_descriptor>().value();
+    }
+    UNREACHABLE();
+}
+
+class epoll_awaiter_impl;
+
+/**
+ * A pending event that is known to the epoll awaiter. When the event fires,
+ * its file descriptors are immediately removed from the interest set and the
+ * event is queued for removal from the awaiter.
+ */
+class watched_event :
+        public pending_event,
+        public std::enable_shared_from_this<watched_event> {
+
+public:
+
+    using queue = timer_queue<std::shared_ptr<watched_event>>;
+
+private:
+
+    epoll_awaiter_impl &m_awaiter;
+    queue::handle m_handle;
+    bool m_is_inserted = false;
+    bool m_is_registered = false;
+
+    void will_fire() noexcept final override;
+
+public:
+
+    watched_event(promise<trigger> &&, epoll_awaiter_impl &);
+
+    queue::handle get_handle() const noexcept { return m_handle; }
+    void set_handle(queue::handle h) noexcept {
+        m_handle = h;
+        m_is_inserted = true;
+    }
+    void clear_handle() noexcept { m_is_inserted = false; }
+    bool is_inserted() const noexcept { return m_is_inserted; }
+
+    bool is_registered() const noexcept { return m_is_registered; }
+    void set_registered(bool r) noexcept { m_is_registered = r; }
+
+}; // class watched_event
+
+/** The state of a file descriptor in the interest set of the epoll. */
+class registration {
+
+public:
+
+    /** Conditions currently registered in the epoll instance. */
+    condition_set registered_conditions;
+
+    /** Events waiting for the file descriptor, per condition. */
+    std::vector<watched_event *> waiters[condition_set::size()];
+
+    condition_set wanted_conditions() const {
+        condition_set s;
+        for (std::size_t i = 0; i < condition_set::size(); ++i)
+            if (!waiters[i].empty())
+                s.set(static_cast<condition>(i));
+        return s;
+    }
+
+}; // class registration
+
+class epoll_awaiter_impl : public awaiter {
+
+private:
+
+    const epoll_api &m_api;
+    std::shared_ptr<handler_configuration> m_handler_configuration;
+    file_descriptor m_epoll;
+
+    /** All pending events, ordered by time limit. */
+    watched_event::queue m_pending_events;
+
+    /** Events whose file descriptors have not yet been registered. */
+    std::vector<std::shared_ptr<watched_event>> m_new_events;
+
+    /**
+     * Events that have fired but may still be in m_pending_events. The events
+     * are kept alive until they are removed so that an event popped by
+     * fire_timeouts after it was queued here can be checked safely.
+     */
+    std::vector<std::shared_ptr<watched_event>> m_fired_events;
+
+    std::unordered_map<file_descriptor::value_type, registration>
+            m_registrations;
+
+    /** Signal file descriptor registered in the epoll instance, if any. */
+    file_descriptor::value_type m_signal_fd;
+
+    /** Buffers reused across waits to avoid allocation. */
+    std::vector<epoll_api::event> m_ready_events;
+    std::vector<watched_event *> m_ready_waiters;
+
+    future<trigger> expect_impl(std::vector<trigger> &&triggers)
+            final override;
+
+    /** @return error code from the epoll_ctl function. */
+    std::error_code update_interest(
+            file_descriptor::value_type, registration &);
+
+    /**
+     * Fires the event if any of its file descriptors does not support epoll.
+     * May throw some exception.
+     */
+    void register_event(watched_event &);
+
+    void register_new_events();
+
+    /**
+     * Keeps the signal file descriptor of the handler configuration
+     * registered in the epoll instance. Errors are ignored, in which case the
+     * handlers are called after every wait.
+     */
+    void register_signal_file_descriptor();
+
+    /**
+     * Calls the signal handlers unless the signal file descriptor is known
+     * not to be readable.
+     */
+    void call_handlers(const std::error_code &wait_result);
+
+    bool remove_fired_events();
+
+    /** @return true iff any event has timed out. */
+    bool fire_timeouts(time_point now);
+
+    /** @return min for infinity */
+    time_point::duration duration_to_next_timeout(time_point now) const;
+
+    bool matches(const file_descriptor_trigger &) const;
+
+    void dispatch_ready_events();
+
+public:
+
+    epoll_awaiter_impl(
+            const epoll_api &,
+            std::shared_ptr<handler_configuration> &&hc,
+            file_descriptor &&epoll);
+
+    ~epoll_awaiter_impl() override;
+
+    void await_events() final override;
+
+    /**
+     * Removes the argument event from the interest set. Errors are ignored.
+     * Called when the event fires.
+     */
+    void unregister_event(watched_event &) noexcept;
+
+    void queue_removal(watched_event &e) {
+        m_fired_events.push_back(e.shared_from_this());
+    }
+
+}; // class epoll_awaiter_impl
+
+watched_event::watched_event(
+        promise<trigger> &&p, epoll_awaiter_impl &a) :
+        pending_event(std::move(p)), m_awaiter(a), m_handle() { }
+
+void watched_event::will_fire() noexcept {
+    if (m_is_registered)
+        m_awaiter.unregister_event(*this);
+    if (m_is_inserted)
+        m_awaiter.queue_removal(*this);
+}
+
+epoll_awaiter_impl::epoll_awaiter_impl(
+        const epoll_api &api,
+        std::shared_ptr<handler_configuration> &&hc,
+        file_descriptor &&epoll) :
+        m_api(api),
+        m_handler_configuration(std::move(hc)),
+        m_epoll(std::move(epoll)),
+        m_pending_events(),
+        m_new_events(),
+        m_fired_events(),
+        m_registrations(),
+        m_signal_fd(file_descriptor::invalid_value),
+        m_ready_events(),
+        m_ready_waiters() {
+    assert(m_handler_configuration != nullptr);
+    assert(m_epoll.is_valid());
+}
+
+epoll_awaiter_impl::~epoll_awaiter_impl() {
+    (void) m_api.close(m_epoll);
+    m_epoll.clear();
+}
+
+future<trigger> epoll_awaiter_impl::expect_impl(
+        std::vector<trigger> &&triggers) {
+    auto pf = make_promise_future_pair<trigger>();
+    if (triggers.empty())
+        return std::move(pf.second);
+
+    auto event = std::make_shared<watched_event>(std::move(pf.first), *this);
+    std::shared_ptr<pending_event> base = event;
+    for (trigger &t : triggers)
+        register_trigger(std::move(t), base, *m_handler_configuration);
+
+    if (event->has_fired())
+        return std::move(pf.second);
+
+    time_point time_limit = compute_time_limit(event->timeout(), m_api);
+    event->set_handle(m_pending_events.push(time_limit, event));
+    m_new_events.push_back(std::move(event));
+
+    return std::move(pf.second);
+}
+
+std::error_code epoll_awaiter_impl::update_interest(
+        file_descriptor::value_type fd, registration &r) {
+    condition_set wanted = r.wanted_conditions();
+    if (wanted == r.registered_conditions)
+        return std::error_code();
+
+    std::error_code e;
+    if (wanted.none()) {
+        e = m_api.epoll_ctl(m_epoll, control_operation::remove, fd, wanted);
+    } else if (r.registered_conditions.none()) {
+        e = m_api.epoll_ctl(m_epoll, control_operation::add, fd, wanted);
+        if (e == std::errc::file_exists)
+            e = m_api.epoll_ctl(
+                    m_epoll, control_operation::modify, fd, wanted);
+    } else {
+        e = m_api.epoll_ctl(m_epoll, control_operation::modify, fd, wanted);
+        if (e == std::errc::no_such_file_or_directory)
+            e = m_api.epoll_ctl(m_epoll, control_operation::add, fd, wanted);
+    }
+    if (!e)
+        r.registered_conditions = wanted;
+    return e;
+}
+
+void epoll_awaiter_impl::register_event(watched_event &e) {
+    e.set_registered(true);
+    for (const file_descriptor_trigger &t : e.triggers()) {
+        file_descriptor::value_type fd = fd_of(t);
+        registration &r = m_registrations[fd];
+        auto &waiters = r.waiters[static_cast<std::size_t>(condition_of(t))];
+        if (std::find(waiters.begin(), waiters.end(), &e) != waiters.end())
+            continue;
+
+        waiters.push_back(&e);
+        std::error_code ec = update_interest(fd, r);
+        if (ec == std::errc::operation_not_permitted) {
+            // The file descriptor does not support epoll, which is the case
+            // for regular files. Like pselect, regard it as always readable
+            // and writable but never in an error condition.
+            waiters.pop_back();
+            if (r.registered_conditions.none() &&
+                    r.wanted_conditions().none())
+                m_registrations.erase(fd);
+            if (condition_of(t) == condition::error)
+                continue;
+
+            file_descriptor_trigger ready = t;
+            e.fire(std::move(ready));
+            return;
+        }
+        if (ec)
+            throw std::system_error(ec);
+    }
+}
+
+void epoll_awaiter_impl::unregister_event(watched_event &e) noexcept {
+    e.set_registered(false);
+    for (const file_descriptor_trigger &t : e.triggers()) {
+        file_descriptor::value_type fd = fd_of(t);
+        auto i = m_registrations.find(fd);
+        if (i == m_registrations.end())
+            continue;
+
+        registration &r = i->second;
+        auto &waiters = r.waiters[static_cast<std::size_t>(condition_of(t))];
+        waiters.erase(
+                std::remove(waiters.begin(), waiters.end(), &e),
+                waiters.end());
+
+        try {
+            (void) update_interest(fd, r);
+        } catch (...) {
+            // ignore
+        }
+        r.registered_conditions = r.wanted_conditions();
+        if (r.registered_conditions.none())
+            m_registrations.erase(i);
+    }
+}
+
+void epoll_awaiter_impl::register_new_events() {
+    for (std::shared_ptr<watched_event> &e : m_new_events) {
+        if (e->has_fired())
+            continue;
+
+        try {
+            register_event(*e);
+        } catch (...) {
+            e->fail_with_current_exception();
+        }
+    }
+    m_new_events.clear();
+}
+
+void epoll_awaiter_impl::register_signal_file_descriptor() {
+    const file_descriptor *signal_fd =
+            m_handler_configuration->signal_file_descriptor();
+    file_descriptor::value_type fd =
+            signal_fd == nullptr ?
+                    file_descriptor::invalid_value : signal_fd->value();
+    if (fd == m_signal_fd)
+        return;
+
+    if (m_signal_fd != file_descriptor::invalid_value)
+        (void) m_api.epoll_ctl(
+                m_epoll, control_operation::remove, m_signal_fd, {});
+    m_signal_fd = file_descriptor::invalid_value;
+
+    if (fd != file_descriptor::invalid_value &&
+            !m_api.epoll_ctl(
+                    m_epoll,
+                    control_operation::add,
+                    fd,
+                    condition_set{condition::readable}))
+        m_signal_fd = fd;
+}
+
+void epoll_awaiter_impl::call_handlers(const std::error_code &wait_result) {
+    bool is_signaled =
+            m_signal_fd == file_descriptor::invalid_value || wait_result;
+    if (!is_signaled)
+        for (const epoll_api::event &e : m_ready_events)
+            if (e.fd == m_signal_fd)
+                is_signaled = true;
+    if (is_signaled)
+        m_handler_configuration->call_handlers();
+}
+
+bool epoll_awaiter_impl::remove_fired_events() {
+    if (m_fired_events.empty())
+        return false;
+
+    // Erasing an event from m_pending_events may destroy it, which in turn
+    // may cancel signal handlers, so the queue is swapped out first.
+    std::vector<std::shared_ptr<watched_event>> fired_events;
+    fired_events.swap(m_fired_events);
+    for (const std::shared_ptr<watched_event> &e : fired_events) {
+        // The event may have been popped by fire_timeouts after it was
+        // queued, in which case its handle may already be reused.
+        if (!e->is_inserted())
+            continue;
+        e->clear_handle();
+        (void) m_pending_events.erase(e->get_handle());
+    }
+    return true;
+}
+
+bool epoll_awaiter_impl::fire_timeouts(time_point now) {
+    bool fired_any = false;
+    while (!m_pending_events.empty() &&
+            m_pending_events.top_time_limit() <= now) {
+        std::shared_ptr<watched_event> e = m_pending_events.pop();
+        e->clear_handle();
+        e->fire(e->timeout());
+        fired_any = true;
+    }
+    return fired_any;
+}
+
+time_point::duration epoll_awaiter_impl::duration_to_next_timeout(
+        time_point now) const {
+    if (m_pending_events.empty())
+        return time_point::duration::min();
+
+    time_point next_time_limit = m_pending_events.top_time_limit();
+    if (next_time_limit == time_point::max())
+        return time_point::duration::min();
+    if (next_time_limit <= now)
+        return time_point::duration::zero();
+    return next_time_limit - now;
+}
+
+bool epoll_awaiter_impl::matches(const file_descriptor_trigger &t) const {
+    file_descriptor::value_type fd = fd_of(t);
+    condition c = condition_of(t);
+    for (const epoll_api::event &e : m_ready_events)
+        if (e.fd == fd && e.conditions[c])
+            return true;
+    return false;
+}
+
+void epoll_awaiter_impl::dispatch_ready_events() {
+    m_ready_waiters.clear();
+    for (const epoll_api::event &e : m_ready_events) {
+        auto i = m_registrations.find(e.fd);
+        if (i == m_registrations.end())
+            continue;
+
+        for (std::size_t j = 0; j < condition_set::size(); ++j)
+            if (e.conditions[static_cast<condition>(j)])
+                m_ready_waiters.insert(
+                        m_ready_waiters.end(),
+                        i->second.waiters[j].begin(),
+                        i->second.waiters[j].end());
+    }
+
+    // Like the pselect-based awaiter, an event fires with the first of its
+    // triggers that matches the result.
+    using namespace std::placeholders;
+    for (watched_event *e : m_ready_waiters) {
+        if (e->has_fired())
+            continue;
+
+        auto i = std::find_if(
+                e->triggers().begin(),
+                e->triggers().end(),
+                std::bind(&epoll_awaiter_impl::matches, this, _1));
+        if (i != e->triggers().end())
+            e->fire(std::move(*i));
+    }
+}
+
+void epoll_awaiter_impl::await_events() {
+    while (!m_pending_events.empty()) {
+        time_point now = m_api.steady_clock_now();
+        bool timed_out = fire_timeouts(now);
+
+        register_new_events();
+        if (remove_fired_events() || timed_out)
+            continue;
+
+        register_signal_file_descriptor();
+
+        std::error_code e = m_api.epoll_pwait(
+                m_epoll,
+                m_ready_events,
+                max_ready_events,
+                duration_to_next_timeout(now),
+                m_handler_configuration->mask_for_pselect());
+        assert(e != std::errc::bad_file_descriptor);
+
+        call_handlers(e);
+
+        if (!e)
+            dispatch_ready_events();
+        remove_fired_events();
+    }
+}
+
+} // namespace
+
+std::unique_ptr<awaiter> create_awaiter(
+        const epoll_api &api,
+        std::shared_ptr<handler_configuration> &&hc) {
+    auto epoll = api.epoll_create();
+    switch (epoll.tag()) {
+    case decltype(epoll)::tag<file_descriptor>():
+        return std::unique_ptr<awaiter>(new epoll_awaiter_impl(
+                api,
+                std::move(hc),
+                std::move(epoll.value<file_descriptor>())));
+    case decltype(epoll)::tag<std::error_code>():
+        return create_awaiter(
+                static_cast<const pselect_api &>(api), std::move(hc));
+    }
+    UNREACHABLE();
+}
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,190 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <map>
+#include <system_error>
+#include "async/future.hh"
+#include "async/future_test_helper.hh"
+#include "catch.hpp"
+#include "os/event/awaiter_test_helper.hh"
+#include "os/event/epoll_api.hh"
+#include "os/event/error_file_descriptor.hh"
+#include "os/event/readable_file_descriptor.hh"
+#include "os/event/trigger.hh"
+#include "os/event/writable_file_descriptor.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/io/file_descriptor_set.hh"
+#include "os/signaling/handler_configuration_api_test_helper.hh"
+#include "os/signaling/signal_number_set.hh"
+
+namespace {
+
+using sesh::os::event::awaiter_test_fixture;
+using sesh::os::event::epoll_api;
+using sesh::os::event::error_file_descriptor;
+using sesh::os::event::readable_file_descriptor;
+using sesh::os::event::trigger;
+using sesh::os::event::writable_file_descriptor;
+using sesh::os::io::file_descriptor;
+using sesh::os::io::file_descriptor_set;
+using sesh::os::signaling::handler_configuration_api_dummy;
+using sesh::os::signaling::signal_number_set;
+
+using condition = epoll_api::condition;
+using condition_set = epoll_api::condition_set;
+using interest_map = std::map<file_descriptor::value_type, condition_set>;
+
+TEST_CASE_METHOD(
+        awaiter_test_fixture<handler_configuration_api_dummy>,
+        "Epoll awaiter: registration of unfired event persists") {
+    unsigned fire_count = 0;
+    expect_result(
+            a.expect(readable_file_descriptor(3)),
+            [&fire_count](trigger &&t) {
+        CHECK(t.tag() == trigger::tag<readable_file_descriptor>());
+        ++fire_count;
+    });
+    expect_result(
+            a.expect(readable_file_descriptor(4)),
+            [&fire_count](trigger &&t) {
+        CHECK(t.tag() == trigger::tag<readable_file_descriptor>());
+        ++fire_count;
+    });
+
+    implementation() = [this](
+            const pselect_api_stub &,
+            file_descriptor::value_type,
+            file_descriptor_set *read_fds,
+            file_descriptor_set *,
+            file_descriptor_set *,
+            std::chrono::nanoseconds,
+            const signal_number_set *) -> std::error_code {
+        CHECK(interests() == (interest_map{
+                {3, condition_set{condition::readable}},
+                {4, condition_set{condition::readable}}}));
+        read_fds->reset(4);
+
+        implementation() = [this](
+                const pselect_api_stub &,
+                file_descriptor::value_type,
+                file_descriptor_set *,
+                file_descriptor_set *,
+                file_descriptor_set *,
+                std::chrono::nanoseconds,
+                const signal_number_set *) -> std::error_code {
+            CHECK(interests() == (interest_map{
+                    {4, condition_set{condition::readable}}}));
+            implementation() = nullptr;
+            return std::error_code();
+        };
+        return std::error_code();
+    };
+    a.await_events();
+    CHECK(fire_count == 2);
+    CHECK(interests().empty());
+}
+
+TEST_CASE_METHOD(
+        awaiter_test_fixture<handler_configuration_api_dummy>,
+        "Epoll awaiter: conditions of FD are merged and split") {
+    unsigned fire_count = 0;
+    expect_result(
+            a.expect(readable_file_descriptor(3)),
+            [&fire_count](trigger &&t) {
+        CHECK(t.tag() == trigger::tag<readable_file_descriptor>());
+        ++fire_count;
+    });
+    expect_result(
+            a.expect(writable_file_descriptor(3)),
+            [&fire_count](trigger &&t) {
+        CHECK(t.tag() == trigger::tag<writable_file_descriptor>());
+        ++fire_count;
+    });
+
+    implementation() = [this](
+            const pselect_api_stub &,
+            file_descriptor::value_type,
+            file_descriptor_set *read_fds,
+            file_descriptor_set *,
+            file_descriptor_set *,
+            std::chrono::nanoseconds,
+            const signal_number_set *) -> std::error_code {
+        CHECK(interests() == (interest_map{
+                {3, condition_set{
+                        condition::readable, condition::writable}}}));
+        read_fds->reset(3);
+
+        implementation() = [this](
+                const pselect_api_stub &,
+                file_descriptor::value_type,
+                file_descriptor_set *,
+                file_descriptor_set *,
+                file_descriptor_set *,
+                std::chrono::nanoseconds,
+                const signal_number_set *) -> std::error_code {
+            CHECK(interests() == (interest_map{
+                    {3, condition_set{condition::readable}}}));
+            implementation() = nullptr;
+            return std::error_code();
+        };
+        return std::error_code();
+    };
+    a.await_events();
+    CHECK(fire_count == 2);
+    CHECK(interests().empty());
+}
+
+TEST_CASE_METHOD(
+        awaiter_test_fixture<handler_configuration_api_dummy>,
+        "Epoll awaiter: unpollable FD is always readable") {
+    unpollable_fds().insert(3);
+    unsigned fire_count = 0;
+    expect_result(
+            a.expect(readable_file_descriptor(3)),
+            [&fire_count](trigger &&t) {
+        REQUIRE(t.tag() == trigger::tag<readable_file_descriptor>());
+        CHECK(t.value<readable_file_descriptor>().value() == 3);
+        ++fire_count;
+    });
+    a.await_events();
+    CHECK(fire_count == 1);
+    CHECK(interests().empty());
+}
+
+TEST_CASE_METHOD(
+        awaiter_test_fixture<handler_configuration_api_dummy>,
+        "Epoll awaiter: unpollable FD is writable but never in error") {
+    unpollable_fds().insert(3);
+    unsigned fire_count = 0;
+    expect_result(
+            a.expect(error_file_descriptor(3), writable_file_descriptor(3)),
+            [&fire_count](trigger &&t) {
+        REQUIRE(t.tag() == trigger::tag<writable_file_descriptor>());
+        CHECK(t.value<writable_file_descriptor>().value() == 3);
+        ++fire_count;
+    });
+    a.await_events();
+    CHECK(fire_count == 1);
+    CHECK(interests().empty());
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,270 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "io_ring_proactor.hh"
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "async/promise.hh"
+#include "common/either.hh"
+#include "common/variant.hh"
+#include "helpermacros.h"
+#include "os/event/asynchronous_io.hh"
+#include "os/event/proactor.hh"
+#include "os/event/readable_file_descriptor.hh"
+#include "os/event/timeout.hh"
+#include "os/event/trigger.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/io/io_ring_api.hh"
+
+using sesh::async::future;
+using sesh::async::make_future;
+using sesh::async::make_promise_future_pair;
+using sesh::async::promise;
+using sesh::common::trial;
+using sesh::os::io::file_descriptor;
+using sesh::os::io::io_ring;
+using sesh::os::io::io_ring_api;
+
+namespace sesh {
+namespace os {
+namespace event {
+
+namespace {
+
+using result = asynchronous_io::result;
+
+/** The number of requests the ring is created for. */
+constexpr unsigned ring_entries = 64;
+
+/**
+ * The state of an I/O ring proactor. Callbacks registered to the base
+ * proactor refer to this state by a weak pointer so that they do nothing
+ * after the proactor has been destroyed.
+ */
+class io_ring_state : public std::enable_shared_from_this<io_ring_state> {
+
+private:
+
+    std::unique_ptr<io_ring> m_ring;
+    proactor &m_base;
+
+    /** Promises of the requests in progress, keyed by their user data. */
+    std::unordered_map<io_ring::user_data, promise<result>> m_requests;
+    io_ring::user_data m_next_user_data = 0;
+
+    bool m_is_submission_scheduled = false;
+    bool m_is_awaiting_completion = false;
+
+    template<typename Prepare>
+    future<result> add_request(Prepare prepare);
+
+    void schedule_submission();
+    void submit();
+    void await_completion();
+    void complete(trial<trigger> &&);
+    void fail_all(const std::exception_ptr &);
+
+public:
+
+    io_ring_state(std::unique_ptr<io_ring> &&ring, proactor &base) noexcept :
+            m_ring(std::move(ring)), m_base(base) { }
+
+    future<result> read(const file_descriptor &, void *, std::size_t);
+    future<result> write(const file_descriptor &, const void *, std::size_t);
+
+}; // class io_ring_state
+
+template<typename Prepare>
+future<result> io_ring_state::add_request(Prepare prepare) {
+    io_ring::user_data data = m_next_user_data++;
+    std::error_code e = prepare(data);
+    if (e == std::errc::device_or_resource_busy) {
+        // The ring is full. Submit the queued requests to make room.
+        if (!(e = m_ring->submit()))
+            await_completion();
+        if (!e)
+            e = prepare(data);
+    }
+    if (e)
+        return make_future<result>(e);
+
+    auto pf = make_promise_future_pair<result>();
+    m_requests.emplace(data, std::move(pf.first));
+    schedule_submission();
+    return std::move(pf.second);
+}
+
+future<result> io_ring_state::read(
+        const file_descriptor &fd, void *buffer, std::size_t size) {
+    return add_request([this, &fd, buffer, size](io_ring::user_data data) {
+        return m_ring->prepare_read(fd, buffer, size, data);
+    });
+}
+
+future<result> io_ring_state::write(
+        const file_descriptor &fd, const void *bytes, std::size_t size) {
+    return add_request([this, &fd, bytes, size](io_ring::user_data data) {
+        return m_ring->prepare_write(fd, bytes, size, data);
+    });
+}
+
+void io_ring_state::schedule_submission() {
+    if (m_is_submission_scheduled)
+        return;
+    m_is_submission_scheduled = true;
+
+    // A zero timeout fires at the beginning of the next iteration of the
+    // event loop, so requests made in this iteration are submitted together.
+    std::weak_ptr<io_ring_state> weak_this = shared_from_this();
+    m_base.expect(timeout(std::chrono::nanoseconds::zero())).then(
+            [weak_this](trial<trigger> &&) {
+        if (auto shared_this = weak_this.lock())
+            shared_this->submit();
+    });
+}
+
+void io_ring_state::submit() {
+    m_is_submission_scheduled = false;
+
+    if (std::error_code e = m_ring->submit()) {
+        if (e == std::errc::resource_unavailable_try_again ||
+                e == std::errc::device_or_resource_busy) {
+            // The kernel is short of resources. Retry after completions are
+            // reaped.
+            await_completion();
+            schedule_submission();
+            return;
+        }
+        fail_all(std::make_exception_ptr(std::system_error(e)));
+        return;
+    }
+    await_completion();
+}
+
+void io_ring_state::await_completion() {
+    if (m_is_awaiting_completion || m_requests.empty())
+        return;
+    m_is_awaiting_completion = true;
+
+    std::weak_ptr<io_ring_state> weak_this = shared_from_this();
+    m_base.expect(readable_file_descriptor(m_ring->value())).then(
+            [weak_this](trial<trigger> &&t) {
+        if (auto shared_this = weak_this.lock())
+            shared_this->complete(std::move(t));
+    });
+}
+
+void io_ring_state::complete(trial<trigger> &&t) {
+    m_is_awaiting_completion = false;
+
+    if (!t) {
+        fail_all(t.value<std::exception_ptr>());
+        return;
+    }
+
+    while (auto c = m_ring->pop_completion()) {
+        auto i = m_requests.find(c->data);
+        if (i == m_requests.end())
+            continue;
+
+        promise<result> p = std::move(i->second);
+        m_requests.erase(i);
+        std::move(p).set_result(std::move(c->io_result));
+    }
+
+    await_completion();
+}
+
+void io_ring_state::fail_all(const std::exception_ptr &e) {
+    std::unordered_map<io_ring::user_data, promise<result>> requests;
+    requests.swap(m_requests);
+    for (auto &r : requests)
+        std::move(r.second).fail(e);
+}
+
+class io_ring_proactor : public proactor, private asynchronous_io {
+
+private:
+
+    proactor &m_base;
+
+    /** Null if the I/O ring is unavailable. */
+    std::shared_ptr<io_ring_state> m_state;
+
+    future<trigger> expect_impl(std::vector<trigger> &&triggers)
+            final override {
+        return m_base.expect(std::move(triggers));
+    }
+
+    future<result> read(
+            const file_descriptor &fd, void *buffer, std::size_t size)
+            final override {
+        return m_state->read(fd, buffer, size);
+    }
+
+    future<result> write(
+            const file_descriptor &fd, const void *bytes, std::size_t size)
+            final override {
+        return m_state->write(fd, bytes, size);
+    }
+
+public:
+
+    io_ring_proactor(proactor &base, std::unique_ptr<io_ring> &&ring) :
+            m_base(base),
+            m_state(ring == nullptr ?
+                    nullptr :
+                    std::make_shared<io_ring_state>(std::move(ring), base)) {
+    }
+
+    asynchronous_io *async_io() noexcept final override {
+        return m_state == nullptr ? nullptr : this;
+    }
+
+}; // class io_ring_proactor
+
+} // namespace
+
+std::unique_ptr<proactor> create_io_ring_proactor(
+        const io_ring_api &api, proactor &base) {
+    auto ring = api.create_io_ring(ring_entries);
+    std::unique_ptr<io_ring> ring_or_null;
+    switch (ring.tag()) {
+    case decltype(ring)::tag<std::unique_ptr<io_ring>>():
+        ring_or_null = std::move(ring.value<std::unique_ptr<io_ring>>());
+        break;
+    case decltype(ring)::tag<std::error_code>():
+        break;
+    }
+    return std::unique_ptr<proactor>(
+            new io_ring_proactor(base, std::move(ring_or_null)));
+}
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
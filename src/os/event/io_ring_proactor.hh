@@ -0,0 +1,58 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_event_io_ring_proactor_hh
+#define INCLUDED_os_event_io_ring_proactor_hh
+
+#include "buildconfig.h"
+
+#include <memory>
+#include "os/event/proactor.hh"
+#include "os/io/io_ring_api.hh"
+
+namespace sesh {
+namespace os {
+namespace event {
+
+/**
+ * Creates a proactor that performs reads and writes with an I/O ring.
+ *
+ * The returned proactor forwards all triggers passed to the expect function
+ * to the argument base proactor, which is typically an awaiter. Read and write
+ * requests made through the {@link proactor#async_io} interface are queued
+ * in the ring and submitted in a batch at the beginning of the next iteration
+ * of the base proactor's event loop. Their results are completed when the
+ * base proactor finds the ring readable.
+ *
+ * If the I/O ring cannot be created, the async_io function of the returned
+ * proactor returns null, so reads and writes fall back to waiting for
+ * readiness of file descriptors.
+ *
+ * The API and base proactor must be valid until the returned proactor is
+ * destroyed. The returned proactor must not be destroyed while a read or
+ * write is in progress.
+ */
+std::unique_ptr<proactor> create_io_ring_proactor(
+        const io::io_ring_api &, proactor &base);
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_event_io_ring_proactor_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
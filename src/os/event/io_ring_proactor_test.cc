@@ -0,0 +1,258 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "async/future.hh"
+#include "async/future_test_helper.hh"
+#include "async/promise.hh"
+#include "catch.hpp"
+#include "common/either.hh"
+#include "common/variant.hh"
+#include "os/event/asynchronous_io.hh"
+#include "os/event/io_ring_proactor.hh"
+#include "os/event/proactor.hh"
+#include "os/event/readable_file_descriptor.hh"
+#include "os/event/timeout.hh"
+#include "os/event/trigger.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/io/io_ring_api.hh"
+
+namespace {
+
+using sesh::async::future;
+using sesh::async::make_promise_future_pair;
+using sesh::async::promise;
+using sesh::common::maybe;
+using sesh::common::variant;
+using sesh::os::event::asynchronous_io;
+using sesh::os::event::create_io_ring_proactor;
+using sesh::os::event::proactor;
+using sesh::os::event::readable_file_descriptor;
+using sesh::os::event::timeout;
+using sesh::os::event::trigger;
+using sesh::os::io::file_descriptor;
+using sesh::os::io::io_ring;
+using sesh::os::io::io_ring_api;
+
+using result = asynchronous_io::result;
+
+constexpr file_descriptor::value_type ring_fd = 7;
+
+class io_ring_fake : public io_ring {
+
+public:
+
+    class request {
+
+    public:
+
+        bool is_read;
+        file_descriptor::value_type fd;
+        std::size_t size;
+        user_data data;
+
+    }; // class request
+
+    std::size_t capacity = 16;
+    std::vector<request> queued, submitted;
+    unsigned submit_count = 0;
+    std::deque<completion> completions;
+
+    file_descriptor::value_type value() const noexcept override {
+        return ring_fd;
+    }
+
+    std::error_code prepare(
+            bool is_read,
+            const file_descriptor &fd,
+            std::size_t size,
+            user_data data) {
+        if (queued.size() >= capacity)
+            return std::make_error_code(std::errc::device_or_resource_busy);
+        queued.push_back(request{is_read, fd.value(), size, data});
+        return std::error_code();
+    }
+
+    std::error_code prepare_read(
+            const file_descriptor &fd,
+            void *,
+            std::size_t size,
+            user_data data) override {
+        return prepare(true, fd, size, data);
+    }
+
+    std::error_code prepare_write(
+            const file_descriptor &fd,
+            const void *,
+            std::size_t size,
+            user_data data) override {
+        return prepare(false, fd, size, data);
+    }
+
+    std::error_code submit() override {
+        ++submit_count;
+        submitted.insert(submitted.end(), queued.begin(), queued.end());
+        queued.clear();
+        return std::error_code();
+    }
+
+    maybe<completion> pop_completion() override {
+        if (completions.empty())
+            return maybe<completion>();
+        completion c = std::move(completions.front());
+        completions.pop_front();
+        return c;
+    }
+
+}; // class io_ring_fake
+
+class fixture : protected io_ring_api, protected proactor {
+
+protected:
+
+    bool is_io_ring_supported = true;
+    mutable io_ring_fake *ring = nullptr;
+    std::vector<std::pair<trigger, promise<trigger>>> expectations;
+
+    variant<std::unique_ptr<io_ring>, std::error_code> create_io_ring(
+            unsigned) const override {
+        if (!is_io_ring_supported)
+            return std::make_error_code(std::errc::function_not_supported);
+        ring = new io_ring_fake;
+        return std::unique_ptr<io_ring>(ring);
+    }
+
+    future<trigger> expect_impl(std::vector<trigger> &&triggers) override {
+        REQUIRE(triggers.size() == 1);
+        auto pf = make_promise_future_pair<trigger>();
+        expectations.emplace_back(
+                std::move(triggers.front()), std::move(pf.first));
+        return std::move(pf.second);
+    }
+
+    /** Fires the only expectation, which must have the argument type. */
+    template<typename Trigger>
+    void fire_only() {
+        REQUIRE(expectations.size() == 1);
+        auto e = std::move(expectations.front());
+        expectations.clear();
+        REQUIRE(e.first.tag() == trigger::tag<Trigger>());
+        std::move(e.second).set_result(std::move(e.first));
+    }
+
+}; // class fixture
+
+TEST_CASE_METHOD(fixture, "I/O ring proactor: fallback") {
+    is_io_ring_supported = false;
+    auto p = create_io_ring_proactor(*this, *this);
+    CHECK(p->async_io() == nullptr);
+
+    p->expect(readable_file_descriptor(3));
+    REQUIRE(expectations.size() == 1);
+    CHECK(expectations.front().first.tag() ==
+            trigger::tag<readable_file_descriptor>());
+}
+
+TEST_CASE_METHOD(fixture, "I/O ring proactor: requests are batched") {
+    auto p = create_io_ring_proactor(*this, *this);
+    asynchronous_io *aio = p->async_io();
+    REQUIRE(aio != nullptr);
+    REQUIRE(ring != nullptr);
+
+    char buffer[10];
+    file_descriptor fd3(3), fd4(4);
+    bool called1 = false, called2 = false;
+    expect_result(
+            aio->read(fd3, buffer, sizeof buffer),
+            [&called1](result &&r) {
+        REQUIRE(r.tag() == r.tag<std::size_t>());
+        CHECK(r.value<std::size_t>() == 5);
+        called1 = true;
+    });
+    expect_result(
+            aio->write(fd4, buffer, 3),
+            [&called2](result &&r) {
+        REQUIRE(r.tag() == r.tag<std::error_code>());
+        CHECK(r.value<std::error_code>() == std::errc::io_error);
+        called2 = true;
+    });
+    CHECK(ring->submit_count == 0);
+    CHECK(ring->queued.size() == 2);
+
+    fire_only<timeout>();
+    CHECK(ring->submit_count == 1);
+    REQUIRE(ring->submitted.size() == 2);
+    CHECK(ring->submitted[0].is_read);
+    CHECK(ring->submitted[0].fd == 3);
+    CHECK(ring->submitted[0].size == sizeof buffer);
+    CHECK_FALSE(ring->submitted[1].is_read);
+    CHECK(ring->submitted[1].fd == 4);
+    CHECK(ring->submitted[1].size == 3);
+
+    REQUIRE(expectations.size() == 1);
+    const trigger &t = expectations.front().first;
+    REQUIRE(t.tag() == trigger::tag<readable_file_descriptor>());
+    CHECK(t.value<readable_file_descriptor>().value() == ring_fd);
+
+    ring->completions.push_back(io_ring::completion{
+            ring->submitted[1].data,
+            std::make_error_code(std::errc::io_error)});
+    fire_only<readable_file_descriptor>();
+    CHECK_FALSE(called1);
+    CHECK(called2);
+    CHECK(expectations.size() == 1);
+
+    ring->completions.push_back(io_ring::completion{
+            ring->submitted[0].data, static_cast<std::size_t>(5)});
+    fire_only<readable_file_descriptor>();
+    CHECK(called1);
+    CHECK(expectations.empty());
+
+    fd3.clear();
+    fd4.clear();
+}
+
+TEST_CASE_METHOD(fixture, "I/O ring proactor: full ring is submitted early") {
+    auto p = create_io_ring_proactor(*this, *this);
+    asynchronous_io *aio = p->async_io();
+    REQUIRE(aio != nullptr);
+    REQUIRE(ring != nullptr);
+    ring->capacity = 1;
+
+    char buffer[10];
+    file_descriptor fd(3);
+    aio->read(fd, buffer, sizeof buffer);
+    CHECK(ring->submit_count == 0);
+    aio->read(fd, buffer, sizeof buffer);
+    CHECK(ring->submit_count == 1);
+    CHECK(ring->submitted.size() == 1);
+    CHECK(ring->queued.size() == 1);
+
+    fd.clear();
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,183 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "pending_event.hh"
+
+#include <algorithm>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include "async/future.hh"
+#include "async/promise.hh"
+#include "common/either.hh"
+#include "common/shared_function.hh"
+#include "os/event/signal.hh"
+#include "os/event/timeout.hh"
+#include "os/event/trigger.hh"
+#include "os/event/user_provided_trigger.hh"
+#include "os/signaling/handler_configuration.hh"
+#include "os/signaling/signal_number.hh"
+#include "os/time_api.hh"
+
+using sesh::async::promise;
+using sesh::common::shared_function;
+using sesh::common::trial;
+using sesh::os::signaling::handler_configuration;
+using sesh::os::signaling::signal_number;
+
+using time_point = sesh::os::time_api::steady_clock_time;
+
+namespace sesh {
+namespace os {
+namespace event {
+
+namespace {
+
+class signal_handler {
+
+private:
+
+    std::weak_ptr<pending_event> m_event;
+
+public:
+
+    signal_handler(const std::shared_ptr<pending_event> &) noexcept;
+
+    void operator()(signal_number);
+
+}; // class signal_handler
+
+signal_handler::signal_handler(const std::shared_ptr<pending_event> &e)
+        noexcept :
+        m_event(e) { }
+
+void signal_handler::operator()(signal_number n) {
+    if (std::shared_ptr<pending_event> e = m_event.lock())
+        e->fire(signal(n));
+}
+
+void register_signal_trigger(
+        signal s,
+        const std::shared_ptr<pending_event> &e,
+        handler_configuration &hc) {
+    auto result = hc.add_handler(
+            s.number(), shared_function<signal_handler>::create(e));
+    switch (result.tag()) {
+    case decltype(result)::tag<handler_configuration::canceler_type>():
+        return e->add_canceler(std::move(
+                result.value<handler_configuration::canceler_type>()));
+    case decltype(result)::tag<std::error_code>():
+        throw std::system_error(result.value<std::error_code>());
+    }
+}
+
+void register_user_provided_trigger(
+        user_provided_trigger &&t, const std::shared_ptr<pending_event> &e) {
+    using result = user_provided_trigger::result_type;
+    std::weak_ptr<pending_event> w = e;
+    std::move(t.future()).then([w](trial<result> &&t) {
+        if (std::shared_ptr<pending_event> e = w.lock()) {
+            try {
+                e->fire(user_provided_trigger(std::move(t.get())));
+            } catch (...) {
+                e->fail_with_current_exception();
+            }
+        }
+    });
+}
+
+} // namespace
+
+pending_event::pending_event(promise<trigger> p) :
+        m_timeout(timeout::internal_type::max()),
+        m_triggers(),
+        m_promise(std::move(p)),
+        m_cancelers() { }
+
+pending_event::~pending_event() {
+    for (handler_configuration::canceler_type &c : m_cancelers)
+        (void) c();
+}
+
+void pending_event::add_trigger(const file_descriptor_trigger &t) {
+    m_triggers.push_back(t);
+}
+
+void pending_event::fire(trigger &&t) {
+    if (has_fired())
+        return;
+    will_fire();
+    std::move(m_promise).set_result(std::move(t));
+}
+
+void pending_event::fail_with_current_exception() {
+    if (has_fired())
+        return;
+    will_fire();
+    std::move(m_promise).fail_with_current_exception();
+}
+
+void pending_event::add_canceler(handler_configuration::canceler_type &&c) {
+    m_cancelers.push_back(std::move(c));
+}
+
+void register_trigger(
+        trigger &&t,
+        const std::shared_ptr<pending_event> &e,
+        handler_configuration &hc) {
+    switch (t.tag()) {
+    case trigger::tag<timeout>():
+        e->timeout() = std::min(e->timeout(), t.value<timeout>());
+        return;
+    case trigger::tag<readable_file_descriptor>():
+        e->add_trigger(t.value<readable_file_descriptor>());
+        return;
+    case trigger::tag<writable_file_descriptor>():
+        e->add_trigger(t.value<writable_file_descriptor>());
+        return;
+    case trigger::tag<error_file_descriptor>():
+        e->add_trigger(t.value<error_file_descriptor>());
+        return;
+    case trigger::tag<signal>():
+        register_signal_trigger(t.value<signal>(), e, hc);
+        return;
+    case trigger::tag<user_provided_trigger>():
+        register_user_provided_trigger(
+                std::move(t.value<user_provided_trigger>()), e);
+        return;
+    }
+}
+
+time_point compute_time_limit(timeout to, const time_api &api) {
+    if (to.interval() < timeout::internal_type::zero())
+        to = timeout(timeout::internal_type::zero());
+
+    if (to.interval() == timeout::internal_type::max())
+        return time_point::max();
+
+    time_point now = api.steady_clock_now();
+    if (now > time_point::max() - to.interval())
+        return time_point::max();
+    return now + to.interval();
+}
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,110 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_event_pending_event_hh
+#define INCLUDED_os_event_pending_event_hh
+
+#include "buildconfig.h"
+
+#include <memory>
+#include <vector>
+#include "async/promise.hh"
+#include "common/variant.hh"
+#include "os/event/error_file_descriptor.hh"
+#include "os/event/readable_file_descriptor.hh"
+#include "os/event/timeout.hh"
+#include "os/event/trigger.hh"
+#include "os/event/writable_file_descriptor.hh"
+#include "os/signaling/handler_configuration.hh"
+#include "os/time_api.hh"
+
+namespace sesh {
+namespace os {
+namespace event {
+
+using file_descriptor_trigger = common::variant<
+        readable_file_descriptor,
+        writable_file_descriptor,
+        error_file_descriptor>;
+
+/**
+ * A pending event is a set of triggers that has been passed to an awaiter but
+ * has not yet fired. This class is shared by the awaiter implementations.
+ */
+class pending_event {
+
+private:
+
+    class timeout m_timeout;
+    std::vector<file_descriptor_trigger> m_triggers;
+    async::promise<trigger> m_promise;
+    std::vector<signaling::handler_configuration::canceler_type> m_cancelers;
+
+    /**
+     * Called just before the promise receives a result. The default
+     * implementation does nothing.
+     */
+    virtual void will_fire() noexcept { }
+
+public:
+
+    explicit pending_event(async::promise<trigger>);
+    pending_event(pending_event &&) = default;
+    pending_event &operator=(pending_event &&) = default;
+    virtual ~pending_event();
+
+    class timeout &timeout() noexcept { return m_timeout; }
+
+    const std::vector<file_descriptor_trigger> &triggers() const noexcept {
+        return m_triggers;
+    }
+
+    void add_trigger(const file_descriptor_trigger &t);
+
+    bool has_fired() const noexcept { return !m_promise.is_valid(); }
+
+    void fire(trigger &&);
+    void fail_with_current_exception();
+
+    void add_canceler(signaling::handler_configuration::canceler_type &&c);
+
+}; // class pending_event
+
+/**
+ * Adds the argument trigger to the event. A signal trigger is registered with
+ * the handler configuration. A user-provided trigger is registered to the
+ * future in it so that it fires the event.
+ */
+void register_trigger(
+        trigger &&,
+        const std::shared_ptr<pending_event> &,
+        signaling::handler_configuration &);
+
+/**
+ * Computes the time point at which the argument timeout expires. A negative
+ * timeout is considered zero. The maximum timeout yields the maximum time
+ * point.
+ */
+time_api::steady_clock_time compute_time_limit(timeout, const time_api &);
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_event_pending_event_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -30,6 +30,8 @@ namespace sesh {
 namespace os {
 namespace event {
 
+class asynchronous_io;
+
 /**
  * A proactor accepts requests for future notification that should happen when
  * a specific trigger condition is met.
@@ -86,6 +88,15 @@ public:
                 std::forward<TriggerArg>(t)...));
     }
 
+    /**
+     * Returns a nullable pointer to the facility of this proactor that
+     * performs reads and writes as asynchronous operations. If null, reads
+     * and writes are performed by waiting for readiness of the file
+     * descriptor with this proactor and then calling the reader or writer
+     * API. The default implementation returns null.
+     */
+    virtual asynchronous_io *async_io() noexcept { return nullptr; }
+
 }; // class proactor
 
 } // namespace event
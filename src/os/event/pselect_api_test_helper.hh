@@ -54,7 +54,8 @@ namespace sesh {
 namespace os {
 namespace event {
 
-class pselect_api_stub : public pselect_api, public time_api_fake {
+class pselect_api_stub :
+        public virtual pselect_api, public time_api_fake {
 
 public:
 
@@ -0,0 +1,227 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_event_timer_queue_hh
+#define INCLUDED_os_event_timer_queue_hh
+
+#include "buildconfig.h"
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "os/time_api.hh"
+
+namespace sesh {
+namespace os {
+namespace event {
+
+/**
+ * A timer queue is a priority queue of values ordered by their time limits.
+ * It is implemented as a 4-ary heap. Every value in the queue is identified
+ * by a handle, which can be used to access or remove the value.
+ *
+ * Insertion and removal take O(log n) time. The value with the earliest time
+ * limit can be accessed in O(1) time, so popping all expired values takes
+ * O(k log n) time where k is the number of expired values.
+ *
+ * A handle is valid from when the value is pushed until it is popped or
+ * erased. Handles of removed values may be reused for values pushed later.
+ *
+ * @tparam T Value type. Must be move-constructible and move-assignable.
+ */
+template<typename T>
+class timer_queue {
+
+public:
+
+    using time_point = time_api::steady_clock_time;
+    using handle = std::size_t;
+    using size_type = std::size_t;
+
+    constexpr static size_type arity = 4;
+
+private:
+
+    constexpr static size_type free_index =
+            std::numeric_limits<size_type>::max();
+
+    class entry {
+
+    public:
+
+        time_point time_limit;
+        handle id;
+        T value;
+
+    }; // class entry
+
+    std::vector<entry> m_heap;
+
+    /**
+     * Maps handles to indices into m_heap. Free handles are mapped to
+     * free_index.
+     */
+    std::vector<size_type> m_indices;
+
+    /** Handles that are not in use. */
+    std::vector<handle> m_free_handles;
+
+    void place(size_type index, entry &&e) {
+        m_indices[e.id] = index;
+        m_heap[index] = std::move(e);
+    }
+
+    void sift_up(size_type index) {
+        entry e = std::move(m_heap[index]);
+        while (index > 0) {
+            size_type parent = (index - 1) / arity;
+            if (!(e.time_limit < m_heap[parent].time_limit))
+                break;
+            place(index, std::move(m_heap[parent]));
+            index = parent;
+        }
+        place(index, std::move(e));
+    }
+
+    void sift_down(size_type index) {
+        entry e = std::move(m_heap[index]);
+        for (;;) {
+            size_type first_child = index * arity + 1;
+            if (first_child >= m_heap.size())
+                break;
+
+            size_type last_child = first_child + arity;
+            if (last_child > m_heap.size())
+                last_child = m_heap.size();
+
+            size_type min_child = first_child;
+            for (size_type i = first_child + 1; i < last_child; ++i)
+                if (m_heap[i].time_limit < m_heap[min_child].time_limit)
+                    min_child = i;
+
+            if (!(m_heap[min_child].time_limit < e.time_limit))
+                break;
+            place(index, std::move(m_heap[min_child]));
+            index = min_child;
+        }
+        place(index, std::move(e));
+    }
+
+    /** Removes the entry at the argument index and returns its value. */
+    T remove_at(size_type index) {
+        assert(index < m_heap.size());
+        m_indices[m_heap[index].id] = free_index;
+        m_free_handles.push_back(m_heap[index].id);
+        T value = std::move(m_heap[index].value);
+
+        size_type last = m_heap.size() - 1;
+        if (index != last) {
+            place(index, std::move(m_heap[last]));
+            m_heap.pop_back();
+            if (index > 0 &&
+                    m_heap[index].time_limit <
+                            m_heap[(index - 1) / arity].time_limit)
+                sift_up(index);
+            else
+                sift_down(index);
+        } else
+            m_heap.pop_back();
+        return value;
+    }
+
+public:
+
+    bool empty() const noexcept { return m_heap.empty(); }
+    size_type size() const noexcept { return m_heap.size(); }
+
+    /** Reserves memory for at least the argument number of values. */
+    void reserve(size_type n) {
+        m_heap.reserve(n);
+        m_indices.reserve(n);
+        m_free_handles.reserve(n);
+    }
+
+    /**
+     * Adds a value to this queue.
+     * @return handle that identifies the added value.
+     */
+    handle push(time_point time_limit, T value) {
+        handle id;
+        if (m_free_handles.empty()) {
+            id = m_indices.size();
+            m_indices.push_back(m_heap.size());
+        } else {
+            id = m_free_handles.back();
+            m_free_handles.pop_back();
+            m_indices[id] = m_heap.size();
+        }
+
+        m_heap.push_back(entry{time_limit, id, std::move(value)});
+        sift_up(m_heap.size() - 1);
+        return id;
+    }
+
+    /** Returns the earliest time limit. The queue must not be empty. */
+    const time_point &top_time_limit() const {
+        assert(!empty());
+        return m_heap.front().time_limit;
+    }
+
+    /** Returns the value with the earliest time limit. */
+    T &top() {
+        assert(!empty());
+        return m_heap.front().value;
+    }
+
+    /** Removes and returns the value with the earliest time limit. */
+    T pop() { return remove_at(0); }
+
+    /**
+     * Returns true iff the argument handle identifies a value in this queue,
+     * that is, it has been returned from push and the value has not been
+     * popped or erased since.
+     */
+    bool contains(handle h) const noexcept {
+        return h < m_indices.size() && m_indices[h] != free_index;
+    }
+
+    /** Returns the value identified by the argument valid handle. */
+    T &operator[](handle h) {
+        assert(contains(h));
+        return m_heap[m_indices[h]].value;
+    }
+
+    /**
+     * Removes and returns the value identified by the argument handle. The
+     * handle must be valid; erasing a popped or erased value is an error.
+     */
+    T erase(handle h) {
+        assert(contains(h));
+        return remove_at(m_indices[h]);
+    }
+
+}; // template<typename T> class timer_queue
+
+} // namespace event
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_event_timer_queue_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
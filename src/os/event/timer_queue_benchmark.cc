@@ -0,0 +1,134 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+#include "os/event/timer_queue.hh"
+
+/*
+ * Compares the timer queue with the std::multimap the awaiter used to store
+ * its timeouts in. For each size, the benchmark inserts that many timers with
+ * random time limits, cancels every other one of them, and then expires the
+ * rest in order, which is the life cycle of watchdog timeouts in the awaiter.
+ */
+
+namespace {
+
+using sesh::os::event::timer_queue;
+
+using time_point = timer_queue<int>::time_point;
+using value_type = std::shared_ptr<int>;
+using clock = std::chrono::steady_clock;
+
+class result {
+
+public:
+
+    double insert_ms, cancel_ms, expire_ms;
+
+}; // class result
+
+double milliseconds_since(clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start)
+            .count();
+}
+
+std::vector<time_point> random_time_limits(std::size_t n) {
+    std::mt19937_64 engine(n);
+    std::uniform_int_distribution<long long> distribution(0, 3600000000000LL);
+    std::vector<time_point> limits;
+    limits.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        limits.push_back(time_point(std::chrono::nanoseconds(
+                distribution(engine))));
+    return limits;
+}
+
+result run_timer_queue(const std::vector<time_point> &limits) {
+    const auto value = std::make_shared<int>(0);
+    timer_queue<value_type> q;
+    std::vector<timer_queue<value_type>::handle> handles;
+    handles.reserve(limits.size());
+    result r;
+
+    clock::time_point start = clock::now();
+    for (const time_point &t : limits)
+        handles.push_back(q.push(t, value));
+    r.insert_ms = milliseconds_since(start);
+
+    start = clock::now();
+    for (std::size_t i = 0; i < handles.size(); i += 2)
+        (void) q.erase(handles[i]);
+    r.cancel_ms = milliseconds_since(start);
+
+    start = clock::now();
+    while (!q.empty())
+        (void) q.pop();
+    r.expire_ms = milliseconds_since(start);
+    return r;
+}
+
+result run_multimap(const std::vector<time_point> &limits) {
+    using map = std::multimap<time_point, value_type>;
+    const auto value = std::make_shared<int>(0);
+    map m;
+    std::vector<map::iterator> handles;
+    handles.reserve(limits.size());
+    result r;
+
+    clock::time_point start = clock::now();
+    for (const time_point &t : limits)
+        handles.push_back(m.emplace(t, value));
+    r.insert_ms = milliseconds_since(start);
+
+    start = clock::now();
+    for (std::size_t i = 0; i < handles.size(); i += 2)
+        m.erase(handles[i]);
+    r.cancel_ms = milliseconds_since(start);
+
+    start = clock::now();
+    while (!m.empty())
+        m.erase(m.begin());
+    r.expire_ms = milliseconds_since(start);
+    return r;
+}
+
+void print(const char *name, std::size_t n, const result &r) {
+    std::cout << name << '\t' << n << '\t' << r.insert_ms << '\t' <<
+            r.cancel_ms << '\t' << r.expire_ms << '\n';
+}
+
+} // namespace
+
+int main() {
+    std::cout << "container\ttimers\tinsert(ms)\tcancel(ms)\texpire(ms)\n";
+    for (std::size_t n : {10000, 100000, 1000000}) {
+        std::vector<time_point> limits = random_time_limits(n);
+        print("timer_queue", n, run_timer_queue(limits));
+        print("multimap", n, run_multimap(limits));
+    }
+    return 0;
+}
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
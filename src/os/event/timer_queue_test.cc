@@ -0,0 +1,129 @@
+/* Copyright (C) 2015 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <chrono>
+#include <vector>
+#include "catch.hpp"
+#include "os/event/timer_queue.hh"
+
+namespace {
+
+using sesh::os::event::timer_queue;
+
+using time_point = timer_queue<int>::time_point;
+
+time_point at(int seconds) {
+    return time_point(std::chrono::seconds(seconds));
+}
+
+TEST_CASE("Timer queue: empty queue") {
+    timer_queue<int> q;
+    CHECK(q.empty());
+    CHECK(q.size() == 0);
+}
+
+TEST_CASE("Timer queue: values are popped in order of time limit") {
+    timer_queue<int> q;
+    for (int i : {5, 3, 9, 1, 7, 2, 8, 6, 4, 0})
+        (void) q.push(at(i), i * 10);
+    CHECK(q.size() == 10);
+
+    std::vector<int> popped;
+    while (!q.empty()) {
+        CHECK(q.top_time_limit() == at(q.top() / 10));
+        popped.push_back(q.pop());
+    }
+    CHECK(popped == (std::vector<int>{0, 10, 20, 30, 40, 50, 60, 70, 80, 90}));
+}
+
+TEST_CASE("Timer queue: erasing values by handle") {
+    timer_queue<int> q;
+    std::vector<timer_queue<int>::handle> handles;
+    for (int i = 0; i < 20; ++i)
+        handles.push_back(q.push(at((i * 7) % 20), i));
+
+    CHECK(q[handles[3]] == 3);
+    CHECK(q.erase(handles[3]) == 3);
+    CHECK(q.erase(handles[0]) == 0);
+    CHECK(q.erase(handles[19]) == 19);
+    CHECK(q.size() == 17);
+
+    time_point last = time_point::min();
+    while (!q.empty()) {
+        CHECK(last <= q.top_time_limit());
+        last = q.top_time_limit();
+        int i = q.pop();
+        CHECK(i != 0);
+        CHECK(i != 3);
+        CHECK(i != 19);
+    }
+}
+
+TEST_CASE("Timer queue: handles are reused after removal") {
+    timer_queue<int> q;
+    auto h1 = q.push(at(1), 1);
+    auto h2 = q.push(at(2), 2);
+    CHECK(q.erase(h1) == 1);
+
+    auto h3 = q.push(at(0), 3);
+    CHECK(h3 == h1);
+    CHECK(q[h2] == 2);
+    CHECK(q[h3] == 3);
+    CHECK(q.pop() == 3);
+    CHECK(q.pop() == 2);
+    CHECK(q.empty());
+}
+
+TEST_CASE("Timer queue: popped and erased handles are not contained") {
+    timer_queue<int> q;
+    auto h1 = q.push(at(1), 1);
+    auto h2 = q.push(at(2), 2);
+    auto h3 = q.push(at(3), 3);
+    CHECK(q.contains(h1));
+    CHECK(q.contains(h2));
+    CHECK(q.contains(h3));
+
+    CHECK(q.pop() == 1);
+    CHECK_FALSE(q.contains(h1));
+    CHECK(q.erase(h3) == 3);
+    CHECK_FALSE(q.contains(h3));
+    CHECK(q.contains(h2));
+
+    auto h4 = q.push(at(4), 4);
+    CHECK(q.contains(h4));
+    CHECK(q[h2] == 2);
+    CHECK(q[h4] == 4);
+}
+
+TEST_CASE("Timer queue: equal time limits") {
+    timer_queue<int> q;
+    for (int i = 0; i < 10; ++i)
+        (void) q.push(at(1), i);
+    (void) q.push(at(0), 10);
+    CHECK(q.pop() == 10);
+    CHECK(q.size() == 10);
+    while (!q.empty()) {
+        CHECK(q.top_time_limit() == at(1));
+        (void) q.pop();
+    }
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -0,0 +1,118 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_io_io_ring_api_hh
+#define INCLUDED_os_io_io_ring_api_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include "common/either.hh"
+#include "common/variant.hh"
+#include "os/io/file_descriptor.hh"
+
+namespace sesh {
+namespace os {
+namespace io {
+
+/**
+ * An I/O ring performs reads and writes as asynchronous operations. Requests
+ * are queued by the prepare functions and passed to the OS in a batch by
+ * {@link #submit}. The results are popped from the ring later.
+ *
+ * A request waits for its file descriptor to become ready before reading or
+ * writing, so non-blocking file descriptors can be used. The buffer of a
+ * request must be kept valid until its completion is popped.
+ */
+class io_ring {
+
+public:
+
+    /** Identifies a request in its completion. */
+    using user_data = std::uint64_t;
+
+    /** The number of bytes transferred, or an error. */
+    using result = common::variant<std::size_t, std::error_code>;
+
+    class completion {
+
+    public:
+
+        user_data data;
+        result io_result;
+
+    }; // class completion
+
+    virtual ~io_ring() = default;
+
+    /**
+     * Returns the file descriptor of this ring, which becomes readable when
+     * a completion can be popped.
+     */
+    virtual file_descriptor::value_type value() const noexcept = 0;
+
+    /**
+     * Queues a read request. Fails with std::errc::device_or_resource_busy if
+     * the ring is full, in which case queued requests should be submitted
+     * before retrying.
+     */
+    virtual std::error_code prepare_read(
+            const file_descriptor &, void *, std::size_t, user_data) = 0;
+
+    /**
+     * Queues a write request. Fails with std::errc::device_or_resource_busy
+     * if the ring is full, in which case queued requests should be submitted
+     * before retrying.
+     */
+    virtual std::error_code prepare_write(
+            const file_descriptor &, const void *, std::size_t, user_data)
+            = 0;
+
+    /** Submits all the queued requests at once. */
+    virtual std::error_code submit() = 0;
+
+    /** Pops a completion if any request has completed. */
+    virtual common::maybe<completion> pop_completion() = 0;
+
+}; // class io_ring
+
+/** Abstraction of the Linux io_uring API. */
+class io_ring_api {
+
+public:
+
+    /**
+     * Creates a new I/O ring that can hold at least the specified number of
+     * requests. Implementations that do not support I/O rings fail with
+     * std::errc::function_not_supported; callers are expected to fall back
+     * to waiting for readiness of file descriptors in that case.
+     */
+    virtual common::variant<std::unique_ptr<io_ring>, std::error_code>
+            create_io_ring(unsigned entries) const = 0;
+
+}; // class io_ring_api
+
+} // namespace io
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_io_io_ring_api_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
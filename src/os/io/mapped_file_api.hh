@@ -0,0 +1,78 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef INCLUDED_os_io_mapped_file_api_hh
+#define INCLUDED_os_io_mapped_file_api_hh
+
+#include "buildconfig.h"
+
+#include <cstddef>
+#include <memory>
+#include <system_error>
+#include "common/variant.hh"
+#include "os/io/file_descriptor.hh"
+#include "os/time_api.hh"
+
+namespace sesh {
+namespace os {
+namespace io {
+
+/**
+ * A mapped file is a read-only view of the whole contents of a regular file
+ * that has been mapped into memory. The mapping is released when the object
+ * is destroyed. Modifications made to the file after mapping may or may not
+ * be visible through the view.
+ */
+class mapped_file {
+
+public:
+
+    virtual ~mapped_file() = default;
+
+    /** Returns a pointer to the first byte of the file contents. */
+    virtual const char *data() const noexcept = 0;
+
+    /** Returns the number of bytes in the file. */
+    virtual std::size_t size() const noexcept = 0;
+
+    /** Returns the last modification time of the file when mapped. */
+    virtual time_api::system_clock_time modification_time() const noexcept
+            = 0;
+
+}; // class mapped_file
+
+/** Abstraction of the POSIX mmap API for reading whole files. */
+class mapped_file_api {
+
+public:
+
+    /**
+     * Maps the regular file open for reading at the argument file
+     * descriptor. The file descriptor may be closed after mapping.
+     */
+    virtual common::variant<std::unique_ptr<mapped_file>, std::error_code>
+            map_file(const file_descriptor &) const = 0;
+
+}; // class mapped_file_api
+
+} // namespace io
+} // namespace os
+} // namespace sesh
+
+#endif // #ifndef INCLUDED_os_io_mapped_file_api_hh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
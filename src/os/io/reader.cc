@@ -24,6 +24,7 @@
 #include "async/future.hh"
 #include "common/either.hh"
 #include "common/variant.hh"
+#include "os/event/asynchronous_io.hh"
 #include "os/event/proactor.hh"
 #include "os/event/readable_file_descriptor.hh"
 #include "os/event/trigger.hh"
@@ -32,6 +33,7 @@ using sesh::async::future;
 using sesh::async::make_future;
 using sesh::common::trial;
 using sesh::common::variant;
+using sesh::os::event::asynchronous_io;
 using sesh::os::event::proactor;
 using sesh::os::event::readable_file_descriptor;
 using sesh::os::event::trigger;
@@ -78,6 +80,43 @@ struct reader {
 
 }; // struct reader
 
+future<result_pair> read_when_readable(
+        const reader_api &api,
+        proactor &p,
+        non_blocking_file_descriptor &&fd,
+        std::vector<char>::size_type max_bytes_to_read) {
+    auto trigger = readable_file_descriptor(fd.value());
+    return p.expect(trigger).then(
+            reader{api, std::move(fd), std::vector<char>(max_bytes_to_read)});
+}
+
+/** Receives the result of an asynchronous read. */
+struct asynchronous_reader {
+
+    const reader_api &api;
+    class proactor &proactor;
+    non_blocking_file_descriptor fd;
+    std::vector<char> buffer;
+
+    future<result_pair> operator()(std::size_t bytes_read) {
+        buffer.resize(static_cast<std::vector<char>::size_type>(bytes_read));
+        return make_future<result_pair>(std::move(fd), std::move(buffer));
+    }
+
+    future<result_pair> operator()(std::error_code e) {
+        if (e == std::errc::resource_unavailable_try_again ||
+                e == std::errc::operation_canceled)
+            return read_when_readable(
+                    api, proactor, std::move(fd), buffer.size());
+        return make_future<result_pair>(std::move(fd), std::move(e));
+    }
+
+    future<result_pair> operator()(trial<asynchronous_io::result> &&r) {
+        return r.get().apply(*this);
+    }
+
+}; // struct asynchronous_reader
+
 } // namespace
 
 future<result_pair> read(
@@ -91,9 +130,16 @@ future<result_pair> read(
     if (max_bytes_to_read > SIZE_MAX)
         max_bytes_to_read = SIZE_MAX;
 
-    auto trigger = readable_file_descriptor(fd.value());
-    return p.expect(trigger).then(
-            reader{api, std::move(fd), std::vector<char>(max_bytes_to_read)});
+    asynchronous_io *aio = p.async_io();
+    if (aio == nullptr)
+        return read_when_readable(api, p, std::move(fd), max_bytes_to_read);
+
+    std::vector<char> buffer(max_bytes_to_read);
+    auto buffer_body = static_cast<void *>(buffer.data());
+    auto size = static_cast<std::size_t>(buffer.size());
+    auto result = aio->read(fd, buffer_body, size);
+    return std::move(result).then(asynchronous_reader{
+            api, p, std::move(fd), std::move(buffer)}).unwrap();
 }
 
 } // namespace io
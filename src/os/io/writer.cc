@@ -23,14 +23,18 @@
 #include <system_error>
 #include <utility>
 #include "async/future.hh"
+#include "async/task.hh"
 #include "common/either.hh"
+#include "os/event/asynchronous_io.hh"
 #include "os/event/proactor.hh"
 #include "os/event/trigger.hh"
 #include "os/event/writable_file_descriptor.hh"
 
 using sesh::async::future;
-using sesh::async::make_future;
+using sesh::async::start_task;
+using sesh::async::task;
 using sesh::common::trial;
+using sesh::os::event::asynchronous_io;
 using sesh::os::event::proactor;
 using sesh::os::event::trigger;
 using sesh::os::event::writable_file_descriptor;
@@ -43,24 +47,67 @@ namespace {
 
 using result_pair = std::pair<non_blocking_file_descriptor, std::error_code>;
 
-struct writer {
+/**
+ * Writes all the bytes, awaiting the file descriptor to become writable or
+ * the asynchronous I/O to finish as needed. The task is the only object
+ * allocated for the whole operation, however many writes it takes.
+ */
+class write_task : public task<result_pair, write_task> {
+
+private:
+
+    const writer_api &m_api;
+    proactor &m_proactor;
+    non_blocking_file_descriptor m_fd;
+    std::vector<char> m_bytes;
+
+public:
+
+    write_task(
+            const writer_api &api,
+            proactor &p,
+            non_blocking_file_descriptor &&fd,
+            std::vector<char> &&bytes) :
+            m_api(api),
+            m_proactor(p),
+            m_fd(std::move(fd)),
+            m_bytes(std::move(bytes)) { }
+
+    void start() {
+        if (m_bytes.empty())
+            return operator()(std::error_code());
+
+        asynchronous_io *aio = m_proactor.async_io();
+        if (aio == nullptr)
+            return write_when_writable();
+
+        auto result = aio->write(
+                m_fd,
+                static_cast<const void *>(m_bytes.data()),
+                m_bytes.size());
+        await(std::move(result), &write_task::accept_asynchronous_io);
+    }
 
-    const writer_api &api;
-    class proactor &proactor;
-    non_blocking_file_descriptor fd;
-    std::vector<char> bytes;
+    void operator()(std::size_t bytes_written) {
+        auto i = m_bytes.begin();
+        m_bytes.erase(i, i + bytes_written);
+        start();
+    }
 
-    future<result_pair> operator()(std::size_t bytes_written) {
-        auto i = bytes.begin();
-        bytes.erase(i, i + bytes_written);
-        return write(api, proactor, std::move(fd), std::move(bytes));
+    void operator()(std::error_code e) {
+        complete(std::move(m_fd), e);
     }
 
-    future<result_pair> operator()(std::error_code e) {
-        return make_future<result_pair>(std::move(fd), e);
+private:
+
+    void write_when_writable() {
+        await(
+                m_proactor.expect(writable_file_descriptor(m_fd.value())),
+                &write_task::accept_trigger);
     }
 
-    future<result_pair> operator()(trial<trigger> &&t) {
+    /** Writes the bytes after the file descriptor has become writable. */
+    void accept_trigger(trial<trigger> &&t) {
         try {
             t.get();
         } catch (std::domain_error &e) {
@@ -68,16 +115,28 @@ struct writer {
                     std::make_error_code(std::errc::too_many_files_open));
         }
 
-        assert(t->value<writable_file_descriptor>().value() == fd.value());
+        assert(t->value<writable_file_descriptor>().value() == m_fd.value());
 
-        auto r = api.write(
-                fd,
-                static_cast<const void *>(bytes.data()),
-                bytes.size());
-        return std::move(r).apply(*this);
+        auto r = m_api.write(
+                m_fd,
+                static_cast<const void *>(m_bytes.data()),
+                m_bytes.size());
+        std::move(r).apply(*this);
     }
 
-}; // struct writer
+    /** Receives the result of an asynchronous write. */
+    void accept_asynchronous_io(trial<asynchronous_io::result> &&t) {
+        asynchronous_io::result &r = t.get();
+        if (r.tag() == r.tag<std::error_code>()) {
+            const std::error_code &e = r.value<std::error_code>();
+            if (e == std::errc::resource_unavailable_try_again ||
+                    e == std::errc::operation_canceled)
+                return write_when_writable();
+        }
+        std::move(r).apply(*this);
+    }
+
+}; // class write_task
 
 } // namespace
 
@@ -86,12 +145,7 @@ future<result_pair> write(
         proactor &p,
         non_blocking_file_descriptor &&fd,
         std::vector<char> &&bytes) {
-    if (bytes.empty())
-        return make_future<result_pair>(std::move(fd), std::error_code());
-
-    auto trigger = writable_file_descriptor(fd.value());
-    auto w = writer{api, p, std::move(fd), std::move(bytes)};
-    return p.expect(trigger).then(std::move(w)).unwrap();
+    return start_task<write_task>(api, p, std::move(fd), std::move(bytes));
 }
 
 } // namespace io
@@ -18,14 +18,19 @@
 #include "buildconfig.h"
 #include "handler_configuration.hh"
 
+#include <atomic>
+#include <climits>
+#include <cstddef>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "common/either.hh"
 #include "common/shared_function.hh"
 #include "helpermacros.h"
+#include "os/io/file_descriptor.hh"
 #include "os/signaling/handler_configuration_api.hh"
 #include "os/signaling/signal_error_code.hh"
 #include "os/signaling/signal_number_set.hh"
@@ -33,6 +38,7 @@
 using sesh::common::make_maybe_of;
 using sesh::common::maybe;
 using sesh::common::shared_function;
+using sesh::os::io::file_descriptor;
 
 namespace sesh {
 namespace os {
@@ -45,6 +51,9 @@ using handler_type = handler_configuration::handler_type;
 using mask_change_how = handler_configuration_api::mask_change_how;
 using signal_action = handler_configuration_api::signal_action;
 
+/** The maximum number of signals read from the signal file descriptor. */
+constexpr std::size_t signal_batch_size = 64;
+
 enum class action_type {
     default_action, ignore, handler,
 };
@@ -124,6 +133,86 @@ public:
 
 }; // class signal_configuration
 
+/**
+ * Counts of signals caught by the native signal handler. The counters and the
+ * pending bitmask are lock-free atomics so that they can be updated from the
+ * signal handler, and {@link #for_each_pending} can skip all signals at once
+ * when none was caught.
+ */
+class pending_signals {
+
+public:
+
+    /** Signals numbered at or above this value cannot be caught. */
+    constexpr static signal_number capacity = 128;
+
+    static bool can_catch(signal_number n) noexcept {
+        return 0 <= n && n < capacity;
+    }
+
+private:
+
+    static_assert(
+            ATOMIC_INT_LOCK_FREE == 2,
+            "atomic unsigned must be lock-free to be async-signal-safe");
+
+    constexpr static unsigned word_bits = sizeof(unsigned) * CHAR_BIT;
+    constexpr static std::size_t word_count =
+            (capacity + word_bits - 1) / word_bits;
+
+    std::atomic<unsigned> m_counts[capacity];
+    /** Has the bit for each signal number whose count may be non-zero. */
+    std::atomic<unsigned> m_pending[word_count];
+
+public:
+
+    /** Async-signal-safe. The argument must be catchable. */
+    void increase(signal_number n) noexcept {
+        m_counts[n].fetch_add(1, std::memory_order_relaxed);
+        m_pending[n / word_bits].fetch_or(
+                1u << (n % word_bits), std::memory_order_release);
+    }
+
+    /** Clears all the counts. */
+    void clear() noexcept {
+        for (auto &p : m_pending)
+            p.store(0, std::memory_order_relaxed);
+        for (auto &c : m_counts)
+            c.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * Resets the count of every signal caught so far, calling the argument
+     * function with the signal number and the count in ascending order of
+     * signal numbers.
+     */
+    template<typename F>
+    void for_each_pending(F f) {
+        for (std::size_t i = 0; i < word_count; ++i) {
+            if (m_pending[i].load(std::memory_order_relaxed) == 0)
+                continue;
+
+            unsigned bits =
+                    m_pending[i].exchange(0, std::memory_order_acquire);
+            for (unsigned bit = 0; bits != 0; ++bit, bits >>= 1) {
+                if ((bits & 1u) == 0)
+                    continue;
+
+                signal_number n = static_cast<signal_number>(
+                        i * word_bits + bit);
+                unsigned count =
+                        m_counts[n].exchange(0, std::memory_order_relaxed);
+                if (count > 0)
+                    f(n, count);
+            }
+        }
+    }
+
+}; // class pending_signals
+
+/** Zero-initialized as an object with static storage duration. */
+pending_signals caught_signals;
+
 extern "C" void native_catch_signal(int);
 
 signal_action action_for_type(action_type type) {
@@ -151,9 +240,6 @@ public:
     /** Current action configuration on the native side. */
     maybe<action_type> native_action;
 
-    /** Number of signal instances caught. */
-    unsigned catch_count = 0;
-
     /**
      * Calls API's sigaction and remembers the old action if this is the first
      * call.
@@ -198,6 +284,17 @@ private:
     /** Null until {@link #initialize_masks()} is called. */
     std::unique_ptr<signal_number_set> m_mask_for_pselect;
 
+    /**
+     * True unless the API turned out not to support signal file descriptors.
+     */
+    bool m_uses_signalfd = true;
+    /** Invalid until a signal first needs a handler. */
+    file_descriptor m_signal_fd;
+    /** Signals accepted by the signal file descriptor. May be null. */
+    std::unique_ptr<signal_number_set> m_signalfd_mask;
+    /** Reused to receive signals from the signal file descriptor. */
+    std::vector<signal_number> m_fired_signals;
+
     /** Gets (or creates) the configuration for the argument signal number. */
     signal_configuration &configuration(signal_number n) {
         return m_data[n].configuration;
@@ -221,12 +318,62 @@ private:
         case action_type::default_action:
             return m_initial_mask->test(n);
         case action_type::ignore:
-        case action_type::handler:
             return false;
+        case action_type::handler:
+            return m_uses_signalfd;
         }
         UNREACHABLE();
     }
 
+    /**
+     * Adds/removes a signal number to/from the mask of the signal file
+     * descriptor, creating the file descriptor if necessary. If the file
+     * descriptor cannot be created, signals are delivered by the native
+     * handler from then on.
+     */
+    std::error_code update_signalfd(signal_number n, bool accept) {
+        if (!m_uses_signalfd)
+            return std::error_code();
+
+        if (m_signalfd_mask == nullptr)
+            m_signalfd_mask = m_api.create_signal_number_set();
+        m_signalfd_mask->set(n, accept);
+
+        if (!m_signal_fd.is_valid()) {
+            if (!accept)
+                return std::error_code();
+            if (m_api.signalfd(m_signal_fd, *m_signalfd_mask)) {
+                m_uses_signalfd = false;
+                m_signalfd_mask.reset();
+            }
+            return std::error_code();
+        }
+
+        return m_api.signalfd(m_signal_fd, *m_signalfd_mask);
+    }
+
+    /** Reads all pending signals and calls their handlers. */
+    void drain_signal_file_descriptor() {
+        // The buffer is moved out during the loop in case a handler calls
+        // this function recursively.
+        std::vector<signal_number> fired;
+        fired.swap(m_fired_signals);
+
+        do {
+            fired.clear();
+            if (m_api.read_signalfd(m_signal_fd, fired, signal_batch_size))
+                break;
+
+            for (signal_number n : fired) {
+                auto i = m_data.find(n);
+                if (i != m_data.end())
+                    i->second.configuration.call_handlers(n);
+            }
+        } while (fired.size() >= signal_batch_size);
+
+        m_fired_signals.swap(fired);
+    }
+
     std::error_code update_configuration(signal_number n, signal_data &data) {
         if (std::error_code e = initialize_masks())
             return e;
@@ -236,10 +383,17 @@ private:
         if (maybe_new_type == data.native_action)
             return std::error_code(); // no change, just return
 
+        if (new_type == action_type::handler &&
+                !pending_signals::can_catch(n))
+            return std::make_error_code(std::errc::invalid_argument);
+
         if (needs_blocking(new_type))
             if (std::error_code e = m_api.sigprocmask_block(n))
                 return e;
 
+        if (std::error_code e = update_signalfd(n, needs_blocking(new_type)))
+            return e;
+
         signal_action a = action_for_type(new_type);
         if (std::error_code e = data.sigaction(m_api, n, &a))
             return e;
@@ -291,7 +445,15 @@ public:
 
     explicit handler_configuration_impl(const handler_configuration_api &api)
             noexcept :
-            m_api(api) { }
+            m_api(api) {
+        caught_signals.clear();
+    }
+
+    ~handler_configuration_impl() override {
+        if (m_signal_fd.is_valid())
+            (void) m_api.close_signalfd(m_signal_fd);
+        m_signal_fd.clear();
+    }
 
     add_handler_result add_handler(signal_number n, handler_type &&h)
             final override {
@@ -332,38 +494,36 @@ public:
         return m_mask_for_pselect.get();
     }
 
-    void call_handlers() final override {
-        for (auto &pair : m_data) {
-            const signal_number &n = pair.first;
-            signal_data &data = pair.second;
-
-            while (data.catch_count > 0) {
-                --data.catch_count;
-                data.configuration.call_handlers(n);
-            }
-        }
+    const file_descriptor *signal_file_descriptor() const final override {
+        return m_signal_fd.is_valid() ? &m_signal_fd : nullptr;
     }
 
-    void increase_catch_count(signal_number n) {
-        ++m_data[n].catch_count;
+    void call_handlers() final override {
+        if (m_signal_fd.is_valid())
+            drain_signal_file_descriptor();
+
+        caught_signals.for_each_pending(
+                [this](signal_number n, unsigned count) {
+            auto i = m_data.find(n);
+            if (i == m_data.end())
+                return;
+            while (count-- > 0)
+                i->second.configuration.call_handlers(n);
+        });
     }
 
 }; // class handler_configuration_impl
 
-std::weak_ptr<handler_configuration_impl> instance;
-
 void native_catch_signal(int signal_number) {
-    if (auto shared_instance = instance.lock())
-        shared_instance->increase_catch_count(signal_number);
+    if (pending_signals::can_catch(signal_number))
+        caught_signals.increase(signal_number);
 }
 
 } // namespace
 
 auto handler_configuration::create(const handler_configuration_api &api)
         -> std::shared_ptr<handler_configuration> {
-    auto shared_instance = std::make_shared<handler_configuration_impl>(api);
-    instance = shared_instance;
-    return std::move(shared_instance);
+    return std::make_shared<handler_configuration_impl>(api);
 }
 
 } // namespace signaling
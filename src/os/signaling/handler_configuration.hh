@@ -24,6 +24,7 @@
 #include <memory>
 #include <system_error>
 #include "common/variant.hh"
+#include "os/io/file_descriptor.hh"
 #include "os/signaling/handler_configuration_api.hh"
 #include "os/signaling/signal_number.hh"
 #include "os/signaling/signal_number_set.hh"
@@ -80,7 +81,9 @@ public:
      *
      * This function and the returned function may change the signal handler
      * and blocking mask for the signal using the OS API. If the API call
-     * fails, the error code is returned.
+     * fails, the error code is returned. This function fails with
+     * std::errc::invalid_argument if the signal number is too large to be
+     * caught.
      */
     virtual add_handler_result add_handler(signal_number, handler_type &&) = 0;
 
@@ -128,12 +131,31 @@ public:
      */
     virtual const signal_number_set *mask_for_pselect() const = 0;
 
+    /**
+     * Returns a nullable pointer to the signal file descriptor that becomes
+     * readable when the process receives a signal that has a handler.
+     *
+     * If the API supports signal file descriptors, signals that have handlers
+     * are delivered through the file descriptor rather than by the native
+     * signal handler. Such signals remain blocked in the mask for "pselect",
+     * so the file descriptor must be waited for by the "pselect" call
+     * instead.
+     *
+     * The returned pointer is valid until any action or trap configuration is
+     * modified or this instance is destroyed.
+     */
+    virtual const io::file_descriptor *signal_file_descriptor() const = 0;
+
     /**
      * Calls signal handling functions for signals that have been received by
      * the process.
      *
      * To receive signals, you must call the "pselect" OS API after setting
-     * handlers and/or traps.
+     * handlers and/or traps. If {@link #signal_file_descriptor} returns
+     * non-null, the call must also wait for the file descriptor to become
+     * readable. In that case, this function reads the pending signals from
+     * the file descriptor in batches and calls the handlers for the read
+     * signals only.
      */
     virtual void call_handlers() = 0;
 
@@ -18,6 +18,10 @@
 #include "buildconfig.h"
 #include "handler_configuration_api.hh"
 
+#include <cstddef>
+#include <system_error>
+#include <vector>
+#include "os/io/file_descriptor.hh"
 #include "os/signaling/signal_number.hh"
 #include "os/signaling/signal_number_set.hh"
 
@@ -39,6 +43,24 @@ std::error_code handler_configuration_api::sigprocmask_unblock(signal_number n)
     return sigprocmask(mask_change_how::unblock, set.get(), nullptr);
 }
 
+std::error_code handler_configuration_api::signalfd(
+        io::file_descriptor &, const signal_number_set &) const {
+    return std::make_error_code(std::errc::function_not_supported);
+}
+
+std::error_code handler_configuration_api::read_signalfd(
+        const io::file_descriptor &,
+        std::vector<signal_number> &,
+        std::size_t) const {
+    return std::make_error_code(std::errc::function_not_supported);
+}
+
+std::error_code handler_configuration_api::close_signalfd(
+        io::file_descriptor &fd) const {
+    fd.clear();
+    return std::error_code();
+}
+
 } // namespace signaling
 } // namespace os
 } // namespace sesh
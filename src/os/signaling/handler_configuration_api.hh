@@ -20,10 +20,13 @@
 
 #include "buildconfig.h"
 
+#include <cstddef>
 #include <memory>
 #include <system_error>
+#include <vector>
 #include "common/variant.hh"
 #include "os/capitypes.h"
+#include "os/io/file_descriptor.hh"
 #include "os/signaling/signal_number.hh"
 #include "os/signaling/signal_number_set.hh"
 
@@ -77,6 +80,44 @@ public:
             const signal_action *new_action,
             signal_action *old_action) const = 0;
 
+    /**
+     * Creates a signal file descriptor or changes the mask of an existing
+     * one. If the file descriptor argument is invalid, a new non-blocking
+     * signal file descriptor that accepts the signals in the mask is created
+     * and assigned to the argument. Otherwise, the mask of the signal file
+     * descriptor is replaced.
+     *
+     * The mask must be obtained from the {@link #create_signal_number_set}
+     * function called for the same <code>*this</code>.
+     *
+     * The default implementation fails with
+     * std::errc::function_not_supported.
+     */
+    virtual std::error_code signalfd(
+            io::file_descriptor &, const signal_number_set &mask) const;
+
+    /**
+     * Reads pending signals from a signal file descriptor with a single read.
+     * At most max_signals signal numbers are appended to the vector argument.
+     * If no signal is pending, this function fails with
+     * std::errc::resource_unavailable_try_again.
+     *
+     * The default implementation fails with
+     * std::errc::function_not_supported.
+     */
+    virtual std::error_code read_signalfd(
+            const io::file_descriptor &,
+            std::vector<signal_number> &,
+            std::size_t max_signals) const;
+
+    /**
+     * Closes a signal file descriptor created by {@link #signalfd}. The
+     * argument file descriptor is invalidated.
+     *
+     * The default implementation only invalidates the argument.
+     */
+    virtual std::error_code close_signalfd(io::file_descriptor &) const;
+
 }; // class handler_configuration_api
 
 } // namespace signaling
@@ -21,9 +21,13 @@
 #include "buildconfig.h"
 
 #include <cassert>
+#include <cstddef>
+#include <deque>
 #include <map>
 #include <memory>
 #include <system_error>
+#include <vector>
+#include "os/io/file_descriptor.hh"
 #include "os/signaling/handler_configuration_api.hh"
 #include "os/signaling/signal_number.hh"
 #include "os/signaling/signal_number_set_test_helper.hh"
@@ -140,6 +144,69 @@ public:
 
 }; // class handler_configuration_api_fake
 
+/**
+ * Handler configuration API fake that supports the signal file descriptor.
+ * Signals pushed to {@link #signalfd_pending} are read from the file
+ * descriptor.
+ */
+class handler_configuration_api_signalfd_fake :
+        public handler_configuration_api_fake {
+
+public:
+
+    constexpr static io::file_descriptor::value_type signalfd_value = 10;
+
+private:
+
+    mutable signal_number_set_fake m_signalfd_mask;
+    mutable std::deque<signal_number> m_signalfd_pending;
+    mutable unsigned m_signalfd_read_count = 0;
+
+public:
+
+    const signal_number_set_fake &signalfd_mask() const noexcept {
+        return m_signalfd_mask;
+    }
+
+    std::deque<signal_number> &signalfd_pending() noexcept {
+        return m_signalfd_pending;
+    }
+
+    /** Number of read_signalfd calls made so far. */
+    unsigned signalfd_read_count() const noexcept {
+        return m_signalfd_read_count;
+    }
+
+    std::error_code signalfd(
+            io::file_descriptor &fd, const signal_number_set &mask) const
+            override {
+        if (!fd.is_valid())
+            fd = io::file_descriptor(signalfd_value);
+        else if (fd.value() != signalfd_value)
+            return std::make_error_code(std::errc::invalid_argument);
+        m_signalfd_mask = dynamic_cast<const signal_number_set_fake &>(mask);
+        return std::error_code();
+    }
+
+    std::error_code read_signalfd(
+            const io::file_descriptor &fd,
+            std::vector<signal_number> &signals,
+            std::size_t max_signals) const override {
+        ++m_signalfd_read_count;
+        if (fd.value() != signalfd_value)
+            return std::make_error_code(std::errc::bad_file_descriptor);
+        if (m_signalfd_pending.empty())
+            return std::make_error_code(
+                    std::errc::resource_unavailable_try_again);
+        for (; max_signals > 0 && !m_signalfd_pending.empty(); --max_signals) {
+            signals.push_back(m_signalfd_pending.front());
+            m_signalfd_pending.pop_front();
+        }
+        return std::error_code();
+    }
+
+}; // class handler_configuration_api_signalfd_fake
+
 } // namespace signaling
 } // namespace os
 } // namespace sesh
@@ -21,6 +21,7 @@
 #include "catch.hpp"
 #include "common/nop.hh"
 #include "common/type_tag_test_helper.hh"
+#include "os/io/file_descriptor.hh"
 #include "os/signaling/handler_configuration.hh"
 #include "os/signaling/handler_configuration_api_test_helper.hh"
 #include "os/signaling/signal_error_code.hh"
@@ -30,9 +31,11 @@
 namespace {
 
 using sesh::common::nop;
+using sesh::os::io::file_descriptor;
 using sesh::os::signaling::handler_configuration;
 using sesh::os::signaling::handler_configuration_api_dummy;
 using sesh::os::signaling::handler_configuration_api_fake;
+using sesh::os::signaling::handler_configuration_api_signalfd_fake;
 using sesh::os::signaling::signal_error_code;
 using sesh::os::signaling::signal_number;
 using sesh::os::signaling::signal_number_set;
@@ -68,6 +71,13 @@ TEST_CASE_METHOD(
     CHECK(c->mask_for_pselect() == nullptr);
 }
 
+TEST_CASE_METHOD(
+        fixture<handler_configuration_api_fake>,
+        "Handler configuration: no signal file descriptor if unsupported") {
+    auto result = c->add_handler(5, nop());
+    CHECK(c->signal_file_descriptor() == nullptr);
+}
+
 TEST_CASE_METHOD(
         fixture<handler_configuration_api_fake>,
         "Handler configuration: simple handler and action") {
@@ -401,6 +411,39 @@ TEST_CASE_METHOD(
     CHECK(signal_mask().test(5));
 }
 
+TEST_CASE_METHOD(
+        fixture<handler_configuration_api_fake>,
+        "Handler configuration: handler for too large signal number") {
+    auto result = c->add_handler(1000, nop());
+    REQUIRE(result.tag() == result.tag<std::error_code>());
+    CHECK(result.value<std::error_code>() == std::errc::invalid_argument);
+    CHECK(actions().count(1000) == 0);
+}
+
+TEST_CASE_METHOD(
+        fixture<handler_configuration_api_fake>,
+        "Handler configuration: handlers are called for caught signals only") {
+    unsigned count1 = 0, count2 = 0, count3 = 0;
+    auto result1 = c->add_handler(1, [&count1](signal_number) { ++count1; });
+    auto result2 = c->add_handler(2, [&count2](signal_number) { ++count2; });
+    auto result3 = c->add_handler(3, [&count3](signal_number) { ++count3; });
+
+    signal_action &a = actions().at(3);
+    REQUIRE(a.tag() == signal_action::tag<sesh_osapi_signal_handler *>());
+    a.value<sesh_osapi_signal_handler *>()(3);
+    a.value<sesh_osapi_signal_handler *>()(1);
+    a.value<sesh_osapi_signal_handler *>()(3);
+    c->call_handlers();
+    CHECK(count1 == 1);
+    CHECK(count2 == 0);
+    CHECK(count3 == 2);
+
+    c->call_handlers();
+    CHECK(count1 == 1);
+    CHECK(count2 == 0);
+    CHECK(count3 == 2);
+}
+
 TEST_CASE_METHOD(
         fixture<handler_configuration_api_fake>,
         "Handler configuration: trapping invalid signal") {
@@ -471,6 +514,56 @@ TEST_CASE_METHOD(
     CHECK_FALSE(set->test(3));
 }
 
+TEST_CASE_METHOD(
+        fixture<handler_configuration_api_signalfd_fake>,
+        "Handler configuration: signal file descriptor") {
+    CHECK(c->signal_file_descriptor() == nullptr);
+
+    signal_number v = 0;
+    auto result = c->add_handler(5, [&v](signal_number n) { v += n; });
+    const auto *fd = c->signal_file_descriptor();
+    REQUIRE(fd != nullptr);
+    file_descriptor::value_type expected_fd = signalfd_value;
+    CHECK(fd->value() == expected_fd);
+    CHECK(signalfd_mask().test(5));
+    CHECK(signal_mask().test(5));
+
+    const signal_number_set *set = c->mask_for_pselect();
+    REQUIRE(set != nullptr);
+    CHECK(set->test(5));
+
+    c->call_handlers();
+    CHECK(v == 0);
+
+    signalfd_pending().assign({5, 5});
+    c->call_handlers();
+    CHECK(v == 10);
+    CHECK(signalfd_pending().empty());
+
+    REQUIRE(result.tag() == result.tag<canceler_type>());
+    CHECK(result.value<canceler_type>()().value() == 0);
+    CHECK_FALSE(signalfd_mask().test(5));
+    CHECK_FALSE(signal_mask().test(5));
+}
+
+TEST_CASE_METHOD(
+        fixture<handler_configuration_api_signalfd_fake>,
+        "Handler configuration: signals are read in batches") {
+    unsigned count2 = 0, count3 = 0;
+    auto result2 = c->add_handler(2, [&count2](signal_number) { ++count2; });
+    auto result3 = c->add_handler(3, [&count3](signal_number) { ++count3; });
+
+    for (unsigned i = 0; i < 100; ++i)
+        signalfd_pending().push_back(2);
+    signalfd_pending().push_back(3);
+    c->call_handlers();
+
+    CHECK(count2 == 100);
+    CHECK(count3 == 1);
+    CHECK(signalfd_pending().empty());
+    CHECK(signalfd_read_count() == 2);
+}
+
 } // namespace
 
 /* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
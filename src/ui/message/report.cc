@@ -0,0 +1,83 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+#include "report.hh"
+
+#include <cstddef>
+#include "common/either.hh"
+#include "common/xchar.hh"
+#include "common/xstring.hh"
+#include "language/source/location.hh"
+#include "ui/message/category.hh"
+#include "ui/message/format.hh"
+
+namespace sesh {
+namespace ui {
+namespace message {
+
+namespace {
+
+using sesh::common::maybe;
+using sesh::common::xstring;
+using sesh::language::source::line_and_column;
+using sesh::language::source::line_table;
+
+const xstring::value_type *prefix(enum category c) {
+    switch (c) {
+    case category::result:
+        return L("");
+    case category::error:
+        return L("error: ");
+    case category::warning:
+        return L("warning: ");
+    case category::note:
+        return L("note: ");
+    }
+    return L("");
+}
+
+void append(const report &r, const line_table &t, xstring &s) {
+    maybe<line_and_column> lc = t.look_up(r.position);
+    if (lc)
+        s += (format<std::size_t, std::size_t>(L("%1%:%2%: "))
+                % lc->line % lc->column).to_string();
+    s += prefix(r.category);
+    s += r.text.to_string();
+    s += L('\n');
+    if (lc && !lc->text.empty()) {
+        s += lc->text;
+        s += L('\n');
+    }
+
+    for (const auto &sr : r.subreports)
+        append(*sr, t, s);
+}
+
+} // namespace
+
+xstring to_string(const report &r, const line_table &t) {
+    xstring s;
+    append(r, t, s);
+    return s;
+}
+
+} // namespace message
+} // namespace ui
+} // namespace sesh
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
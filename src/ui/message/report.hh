@@ -23,7 +23,8 @@
 #include <memory>
 #include <utility>
 #include <vector>
-#include "language/source/fragment.hh"
+#include "common/xstring.hh"
+#include "language/source/location.hh"
 #include "ui/message/category.hh"
 #include "ui/message/format.hh"
 
@@ -32,8 +33,10 @@ namespace ui {
 namespace message {
 
 /**
- * A report is a message associated with a source fragment position and an
- * error level.
+ * A report is a message associated with a source location and an error level.
+ *
+ * A report does not keep the source code alive. The line and the text of the
+ * source code are looked up when the report is converted to a string.
  */
 class report {
 
@@ -43,8 +46,8 @@ public:
 
     format<> text;
 
-    /** Nullable pointer to a source fragment associated with this report. */
-    language::source::fragment_position position;
+    /** Source location associated with this report. May be unknown. */
+    language::source::location position;
 
     /**
      * List of non-null pointers to other reports that provide additional info
@@ -55,15 +58,24 @@ public:
     report(
             enum category c,
             format<> &&text = format<>(),
-            language::source::fragment_position &&p = {},
+            language::source::location p = {},
             std::vector<std::shared_ptr<const report>> subreports = {}) :
             category(c),
             text(std::move(text)),
-            position(std::move(p)),
+            position(p),
             subreports(std::move(subreports)) { }
 
 }; // class report
 
+/**
+ * Converts the argument report to a string. The string begins with the line
+ * and column of the report's position if found in the argument line table,
+ * followed by the category and text. The line of the source code is appended
+ * if available. Sub-reports follow in separate lines.
+ */
+common::xstring to_string(
+        const report &, const language::source::line_table &);
+
 } // namespace message
 } // namespace ui
 } // namespace sesh
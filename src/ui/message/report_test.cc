@@ -0,0 +1,63 @@
+/* Copyright (C) 2014 WATANABE Yuki
+ *
+ * This file is part of Sesh.
+ *
+ * Sesh is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Sesh is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * Sesh.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "buildconfig.h"
+
+#include <memory>
+#include "catch.hpp"
+#include "common/xchar.hh"
+#include "language/source/fragment.hh"
+#include "language/source/location.hh"
+#include "ui/message/category.hh"
+#include "ui/message/format.hh"
+#include "ui/message/report.hh"
+
+namespace {
+
+using sesh::language::source::fragment;
+using sesh::language::source::line_table;
+using sesh::language::source::location;
+using sesh::ui::message::category;
+using sesh::ui::message::format;
+using sesh::ui::message::report;
+
+TEST_CASE("Report: to_string with location") {
+    auto f1 = std::make_shared<const fragment>(L("echo\n"));
+    auto f2 = std::make_shared<const fragment>(L("a b )\n"));
+    line_table t;
+    t.append(f1);
+    t.append(f2);
+
+    auto note = std::make_shared<const report>(
+            category::note, format<>(L("note")), location{f1->id, 0});
+    report r(
+            category::error,
+            format<>(L("unexpected")),
+            location{f2->id, 4},
+            {note});
+    CHECK(to_string(r, t) ==
+            L("2:5: error: unexpected\na b )\n1:1: note: note\necho\n"));
+}
+
+TEST_CASE("Report: to_string without location") {
+    report r(category::warning, format<>(L("message")));
+    CHECK(to_string(r, line_table()) == L("warning: message\n"));
+}
+
+} // namespace
+
+/* vim: set et sw=4 sts=4 tw=79 cino=\:0,g0,N-s,i2s,+2s ft=cpp: */
@@ -31,8 +31,8 @@ namespace message {
 inline void check_equal(const report &l, const report &r) {
     CHECK(l.category == r.category);
     CHECK(l.text.to_string() == r.text.to_string());
-    CHECK(l.position.head == r.position.head);
-    CHECK(l.position.index == r.position.index);
+    CHECK(l.position.fragment_id == r.position.fragment_id);
+    CHECK(l.position.offset == r.position.offset);
     CHECK(l.subreports.size() == r.subreports.size());
     for (decltype(l.subreports)::size_type i = 0;
             i < std::min(l.subreports.size(), r.subreports.size());